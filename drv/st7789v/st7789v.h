@@ -77,8 +77,6 @@ typedef struct {
     int16_t y2;
 } st7789v_area_t;
 
-typedef st7789v_area_t lv_area_t;
-
 /********** 导出的函数 **********/
 
 /**
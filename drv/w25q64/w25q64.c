@@ -1,77 +1,116 @@
 #define W25Q64_C
 
-#include "w25q64.h"
-#include "sc32_conf.h"
-#include "os.h"
-#include "log.h"
+#include <w25q64.h>
+#include <rthw.h>
 #include <string.h>
 
-static SemaphoreHandle_t dma_done = NULL;
-
-BaseType_t w25q64_init(void) {
-    if (dma_done == NULL) {
-        dma_done = xSemaphoreCreateBinary();
-        if (dma_done == NULL) {
-            OS_PRTF(ERRO_LOG, "create dma_done fail!\n");
-            return pdFAIL;
-        }
-    }
+static struct rt_semaphore dma_done;  // dma传输完成
+static struct rt_mutex     bus_lock;  // 保护单次总线事务（可递归）
+static struct rt_mutex     op_lock;   // 保护整个擦除/编程操作
+
+static volatile uint16_t op_cmd      = 0;  // 芯片内部正在进行的擦除/编程指令，0表示空闲
+static uint32_t          op_adr      = 0;  // 正在擦除/编程的起始地址
+static uint32_t          op_end      = 0;  // 正在擦除/编程的结束地址（不含）
+static rt_tick_t         resume_tick = 0;  // 最近一次恢复的时刻
+
+static volatile uint8_t rx_pending   = 0;  // 有一次已经释放总线锁、但仍在传输的DMA读取
+static volatile uint8_t rx_suspended = 0;  // 这次DMA读取暂停了擦除/编程，结束时恢复
+
+static struct rt_timer   pd_timer;         // 周期检查是否空闲
+static volatile uint8_t  pd_down     = 0;  // 当前是否处于深度掉电
+static volatile uint32_t pd_count    = 0;  // 进入掉电的次数
+static rt_tick_t         pd_since    = 0;  // 本次进入掉电的时刻
+static rt_tick_t         pd_ticks    = 0;  // 之前累计的掉电时间
+static rt_tick_t         last_access = 0;  // 最近一次访问的时刻
+
+/* 没有SFDP时的默认参数，与W25Q64JV的数据手册一致 */
+static w25q64_geo geo = {
+    .capacity  = 8 * 1024 * 1024,
+    .page_size = W25Q64_PAGE_SIZE,
+    .page_us   = 400,
+    .chip_ms   = 20000,
+    .adr_bytes = 3,
+    .erase =
+        {
+            {.size = 4 * 1024, .opcode = Erase4KB, .typ_ms = 45},
+            {.size = 32 * 1024, .opcode = Erase32KB, .typ_ms = 120},
+            {.size = 64 * 1024, .opcode = Erase64KB, .typ_ms = 150},
+        },
+};
+
+static uint8_t _w25q64_read_sr(const w25q64_cmd cmd);
+static void    _w25q64_resume(void);
+static void    _w25q64_probe(void);
+static void    _w25q64_quad_enable(void);
+static void    _w25q64_idle_check(void * parameter);
+
+int w25q64_init(void) {
+    rt_sem_init(&dma_done, "fdma", 0, RT_IPC_FLAG_FIFO);
+    rt_mutex_init(&bus_lock, "fbus", RT_IPC_FLAG_PRIO);
+    rt_mutex_init(&op_lock, "fop", RT_IPC_FLAG_PRIO);
 
     GPIO_WriteBit(CHIP_GPIO_GRP, CHIP_GPIO_PIN, 1);
 
     uint8_t    data[8] = {0};
     w25q64_arg arg;
 
+    /* 热复位时芯片可能仍处于深度掉电，此时不响应复位指令 */
+    pd_down = 1;
     w25q64_ctl(Reset, NULL);
-    vTaskDelay(1);
+    rt_thread_delay(1);
+    pd_ticks = 0;
 
     arg.data = data;
     arg.size = sizeof(data);
     w25q64_ctl(ReadUniqueID, &arg);
-    if (*(uint64_t *)data == W25Q64_Unique_ID) {
-        OS_PRTF(INFO_LOG, "id match: 0x%llX", *(uint64_t *)data);
-    } else {
-        OS_PRTF(INFO_LOG, "id unmatch: 0x%llX", *(uint64_t *)data);
+    OS_PRTF(INFO_LOG, "unique id: 0x%llX\n", *(uint64_t *)data);
+
+    /* 按JEDEC ID与SFDP确定芯片参数 */
+    _w25q64_probe();
+    OS_PRTF(INFO_LOG, "jedec id: 0x%06X, %u KB, %s\n", geo.jedec_id, geo.capacity / 1024,
+            geo.sfdp ? "sfdp" : "default");
+
+    /* 容量超过16MB的芯片需要4字节地址 */
+    if (geo.adr_bytes == 4) {
+        w25q64_ctl(Enter4ByteAdr, NULL);
     }
 
     w25q64_ctl(WriteDisable, NULL);
-    OS_PRTF(INFO_LOG, "Write Disable!");
+    OS_PRTF(INFO_LOG, "Write Disable!\n");
 
     arg.size = 1;
     w25q64_ctl(ReadSR1, &arg);
-    OS_PRTF(INFO_LOG, "SR1: 0x%X!", data[0]);
+    OS_PRTF(INFO_LOG, "SR1: 0x%X!\n", data[0]);
     w25q64_ctl(ReadSR2, &arg);
-    OS_PRTF(INFO_LOG, "SR2: 0x%X!", data[0]);
+    OS_PRTF(INFO_LOG, "SR2: 0x%X!\n", data[0]);
     w25q64_ctl(ReadSR3, &arg);
-    OS_PRTF(INFO_LOG, "SR3: 0x%X!", data[0]);
+    OS_PRTF(INFO_LOG, "SR3: 0x%X!\n", data[0]);
 
-    /********** 进行整片擦除 **********/
+    _w25q64_quad_enable();
 
-#if CHIP_ERASE
-    w25q64_ctl(WriteEnable, NULL);
+#if PD_IDLE_MS > 0
+    last_access = rt_tick_get();
+    rt_timer_init(&pd_timer, "fpd", _w25q64_idle_check, RT_NULL,
+                  rt_tick_from_millisecond(PD_IDLE_MS), RT_TIMER_FLAG_PERIODIC);
+    rt_timer_start(&pd_timer);
+#endif  // PD_IDLE_MS
 
-    uint8_t    SR1;
-    w25q64_arg erase_arg = {
-        .data = &SR1,
-        .size = 1,
-    };
+    /* 复位前若有被暂停的操作，复位后已经失效 */
+    op_cmd = 0;
+
+    /********** 进行整片擦除 **********/
 
-    w25q64_ctl(EraseChip, NULL);
-    do {
-        vTaskDelay(10);
-        w25q64_ctl(ReadSR1, &erase_arg);
-    } while (SR1 & 0x1);
+#if CHIP_ERASE
+    w25q64_erase(EraseChip, 0);
 #endif  // CHIP_ERASE
 
-    OS_PRTF(NEWS_LOG, "Initialize Finish!");
+    OS_PRTF(NEWS_LOG, "Initialize Finish!\n");
 
-    return pdPASS;
+    return RT_EOK;
 }
 
-__inline__ void w25q64_dma_irq(void) {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xSemaphoreGiveFromISR(dma_done, &xHigherPriorityTaskWoken);
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+__attribute__((always_inline)) void w25q64_dma_irq(void) {
+    rt_sem_release(&dma_done);
 }
 
 static void _w25q64_send_bytes(const uint8_t * const data, const uint32_t size) {
@@ -82,8 +121,142 @@ static void _w25q64_send_bytes(const uint8_t * const data, const uint32_t size)
     }
 }
 
+/**
+ * @brief 逐字节接收数据。
+ * @param data 接收缓冲区。
+ * @param size 接收字节数。
+ * @retval
+ * @warning
+ * @note QSPI_ReceiveMultipleData的计数只有8位，超过255字节会死循环，故在此自行接收。
+ */
+static void _w25q64_receive(volatile uint8_t * const data, const uint32_t size) {
+    for (uint32_t index = 0; index < size; ++index) {
+        USE_QSPI->QSPI_DL = 1;
+        QSPI_CLKONLYSet(USE_QSPI, QSPI_CLKONLY_ON);
+        while (QSPI_GetFlagStatus(USE_QSPI, QSPI_Flag_BUSY)) {}
+        data[index] = QSPI_ReceiveData8(USE_QSPI);
+    }
+}
+
+/**
+ * @brief 启动DMA接收。
+ * @param data 接收缓冲区。
+ * @param size 接收字节数。
+ * @retval
+ * @warning 必须持有bus_lock，且指令与地址已经发出、片选保持拉低。
+ * @note 之后必须调用_w25q64_rx_finish结束本次事务。
+ */
+static void _w25q64_rx_start(volatile uint8_t * const data, const uint32_t size) {
+    QSPI_Read_ComSet(USE_QSPI, QSPI_LMode_1Line, QSPI_DWidth_8bit, size);
+    DMA_SetDstAddress(USE_DMA_RX, (uint32_t)data);
+    DMA_SetCurrDataCounter(USE_DMA_RX, size);
+    DMA_Cmd(USE_DMA_RX, ENABLE);
+    QSPI_DMACmd(USE_QSPI, QSPI_DMAReq_RX, ENABLE);
+    QSPI_CLKONLYSet(USE_QSPI, QSPI_CLKONLY_ON);
+    rx_pending = 1;
+}
+
+/**
+ * @brief 等待DMA接收完成并结束事务。
+ * @param
+ * @retval
+ * @warning 必须持有bus_lock。
+ * @note 没有正在进行的接收时立即返回；任何线程都可以替发起者结束事务。
+ * 启动时暂停了擦除/编程的，在这里恢复。
+ */
+static void _w25q64_rx_finish(void) {
+    if (!rx_pending) {
+        return;
+    }
+    rt_sem_take(&dma_done, RT_WAITING_FOREVER);
+    QSPI_DMACmd(USE_QSPI, QSPI_DMAReq_RX, DISABLE);
+    DMA_Cmd(USE_DMA_RX, DISABLE);
+    GPIO_WriteBit(CHIP_GPIO_GRP, CHIP_GPIO_PIN, 1);
+    rx_pending = 0;
+
+    if (rx_suspended) {
+        rx_suspended = 0;
+        _w25q64_resume();
+    }
+}
+
+static void _w25q64_send_data(const volatile uint8_t * const data, const uint32_t size) {
+    QSPI_Write_ComSet(USE_QSPI, QSPI_LMode_1Line, QSPI_DWidth_8bit, QSPI_CLKONLY_OFF);
+    for (uint32_t index = 0; index < size; ++index) {
+        QSPI_SendData8(USE_QSPI, data[index]);
+        while (QSPI_GetFlagStatus(USE_QSPI, QSPI_Flag_BUSY)) {}
+    }
+}
+
+/**
+ * @brief 发送单字节指令。
+ * @param cmd 指令。
+ * @retval
+ * @warning 不加锁，也不会唤醒芯片；可以在中断中调用。
+ * @note
+ */
+static void _w25q64_send_cmd(const uint8_t cmd) {
+    GPIO_WriteBit(CHIP_GPIO_GRP, CHIP_GPIO_PIN, 0);
+    _w25q64_send_bytes(&cmd, 1);
+    GPIO_WriteBit(CHIP_GPIO_GRP, CHIP_GPIO_PIN, 1);
+}
+
+/**
+ * @brief 空闲检查：空闲超过PD_IDLE_MS且没有正在进行的操作时进入深度掉电。
+ * @param parameter 暂时没有使用。
+ * @retval
+ * @warning 在定时器中断中执行。
+ * @note 总线锁无人持有说明没有线程处于一次总线事务之中，此时可以直接操作总线。
+ */
+static void _w25q64_idle_check(void * parameter) {
+    const rt_tick_t now = rt_tick_get();
+    if (pd_down || (op_cmd != 0) || rx_pending || (bus_lock.owner != RT_NULL) ||
+        (now - last_access < rt_tick_from_millisecond(PD_IDLE_MS))) {
+        return;
+    }
+
+    _w25q64_send_cmd(PowerDown);
+    rt_hw_us_delay(PD_ENTER_US);
+    pd_since = now;
+    pd_down  = 1;
+    ++pd_count;
+}
+
+/**
+ * @brief 若芯片处于深度掉电则将其唤醒。
+ * @param
+ * @retval
+ * @warning 必须持有bus_lock。
+ * @note
+ */
+static void _w25q64_wakeup(void) {
+    last_access = rt_tick_get();
+    if (!pd_down) {
+        return;
+    }
+
+    _w25q64_send_cmd(ReleasePowerDown);
+    rt_hw_us_delay(PD_EXIT_US);
+
+    rt_base_t level = rt_hw_interrupt_disable();
+    pd_ticks += last_access - pd_since;
+    pd_down  = 0;
+    rt_hw_interrupt_enable(level);
+}
+
+void w25q64_pd_stat_get(w25q64_pd_stat * const stat) {
+    rt_base_t level  = rt_hw_interrupt_disable();
+    stat->down       = pd_down;
+    stat->down_count = pd_count;
+    stat->down_ticks = pd_ticks + (pd_down ? (rt_tick_get() - pd_since) : 0);
+    rt_hw_interrupt_enable(level);
+}
+
 __attribute__((optnone)) void w25q64_ctl(const w25q64_cmd         cmd,
                                          const w25q64_arg * const arg) {
+    rt_mutex_take(&bus_lock, RT_WAITING_FOREVER);
+    _w25q64_rx_finish();
+    _w25q64_wakeup();
     GPIO_WriteBit(CHIP_GPIO_GRP, CHIP_GPIO_PIN, 0);
 
     /********** 发送指令 **********/
@@ -117,6 +290,28 @@ __attribute__((optnone)) void w25q64_ctl(const w25q64_cmd         cmd,
                 QSPI_Read_ComSet(USE_QSPI, QSPI_LMode_1Line, QSPI_DWidth_8bit, 8);
                 QSPI_ReceiveMultipleData(USE_QSPI, (uint32_t *)arg->data, arg->size);
             } break;
+            case ReadJEDECID: {
+                /********** 接收3个字节 **********/
+
+                QSPI_Read_ComSet(USE_QSPI, QSPI_LMode_1Line, QSPI_DWidth_8bit, 3);
+                QSPI_ReceiveMultipleData(USE_QSPI, (uint32_t *)arg->data, arg->size);
+            } break;
+            case ReadSFDP: {
+                /********** SFDP固定使用3字节地址与1个空字节 **********/
+
+                uint8_t dummy = 0;
+                _w25q64_send_bytes(arg->adr, 3);
+                _w25q64_send_bytes(&dummy, 1);
+
+                QSPI_Read_ComSet(USE_QSPI, QSPI_LMode_1Line, QSPI_DWidth_8bit, arg->size);
+                QSPI_ReceiveMultipleData(USE_QSPI, (uint32_t *)arg->data, arg->size);
+            } break;
+            case WriteSR1:
+            case WriteSR2: {
+                /********** 按顺序发送寄存器值 **********/
+
+                _w25q64_send_data(arg->data, arg->size);
+            } break;
             case ReadSR1:
             case ReadSR2:
             case ReadSR3: {
@@ -131,83 +326,529 @@ __attribute__((optnone)) void w25q64_ctl(const w25q64_cmd         cmd,
                 arg->data[0] = QSPI_ReceiveData8(USE_QSPI);
             } break;
             case ReadDataSPI:
+            case ReadDataDSPI:
             case ReadDataQSPI: {
-                /********** 从高到低发送3个字节的地址 **********/
+                /********** 从高到低发送地址 **********/
 
-                _w25q64_send_bytes(arg->adr, 3);
+                _w25q64_send_bytes(arg->adr, geo.adr_bytes);
 
                 /********** 发送1个空字节 **********/
 
-                if (cmd == ReadDataQSPI) {
+                if (cmd != ReadDataSPI) {
                     QSPI_Write_ComSet(USE_QSPI, QSPI_LMode_1Line, QSPI_DWidth_8bit,
                                       QSPI_CLKONLY_OFF);
                     QSPI_SendData8(USE_QSPI, 0);
                     while (QSPI_GetFlagStatus(USE_QSPI, QSPI_Flag_BUSY)) {}
                 }
 
-                QSPI_Read_ComSet(
-                    USE_QSPI, (cmd == ReadDataQSPI) ? QSPI_LMode_4Line : QSPI_LMode_1Line,
-                    QSPI_DWidth_8bit, arg->size);
-
-                if (cmd == ReadDataQSPI) {
-                    QSPI_ReceiveMultipleData(QSPI0, (uint32_t *)arg->data, arg->size);
+                if (cmd != ReadDataSPI) {
+                    const QSPI_LMode_TypeDef lmode =
+                        (cmd == ReadDataDSPI) ? QSPI_LMode_2Line : QSPI_LMode_4Line;
+                    QSPI_Read_ComSet(USE_QSPI, lmode, QSPI_DWidth_8bit, arg->size);
+                    _w25q64_receive(arg->data, arg->size);
                 } else {
                     /********** 用DMA连续接收字节流 **********/
 
-                    if (xSemaphoreTake(dma_mutex, portMAX_DELAY) == pdTRUE) {
-                        DMA_SetDstAddress(USE_DMA_RX, (uint32_t)arg->data);
-                        DMA_SetCurrDataCounter(USE_DMA_RX, arg->size);
-                        DMA_Cmd(USE_DMA_RX, ENABLE);
-                        QSPI_DMACmd(USE_QSPI, QSPI_DMAReq_RX, ENABLE);
-                        QSPI_CLKONLYSet(USE_QSPI, QSPI_CLKONLY_ON);
-
-                        if (xSemaphoreTake(dma_done, portMAX_DELAY) == pdTRUE) {
-                            QSPI_DMACmd(USE_QSPI, QSPI_DMAReq_RX, DISABLE);
-                            DMA_Cmd(USE_DMA_RX, DISABLE);
-                        }
-
-                        xSemaphoreGive(dma_mutex);
-                    }
+                    _w25q64_rx_start(arg->data, arg->size);
+                    _w25q64_rx_finish();
                 }
 
             } break;
             case Erase4KB:
             case Erase32KB:
             case Erase64KB: {
-                /********** 从高到低发送3个字节的地址 **********/
+                /********** 从高到低发送地址 **********/
 
-                _w25q64_send_bytes(arg->adr, 3);
+                _w25q64_send_bytes(arg->adr, geo.adr_bytes);
             } break;
             case ProgramSPI:
             case ProgramQSPI: {
-                /********** 从高到低发送3个字节的地址 **********/
+                /********** 从高到低发送地址 **********/
 
-                _w25q64_send_bytes(arg->adr, 3);
+                _w25q64_send_bytes(arg->adr, geo.adr_bytes);
 
-                /********** 用DMA连续接收字节流 **********/
+                /********** 用DMA连续发送字节流 **********/
 
                 QSPI_Write_ComSet(
                     USE_QSPI, (cmd == ProgramQSPI) ? QSPI_LMode_4Line : QSPI_LMode_1Line,
                     QSPI_DWidth_8bit, QSPI_CLKONLY_OFF);
 
-                if (xSemaphoreTake(dma_mutex, portMAX_DELAY) == pdTRUE) {
-                    DMA_SetSrcAddress(USE_DMA_TX, (uint32_t)arg->data);
-                    DMA_SetCurrDataCounter(USE_DMA_TX, arg->size);
-                    DMA_Cmd(USE_DMA_TX, ENABLE);
-                    QSPI_DMACmd(USE_QSPI, QSPI_DMAReq_TX, ENABLE);
-                    DMA_SoftwareTrigger(USE_DMA_TX);
+                DMA_SetSrcAddress(USE_DMA_TX, (uint32_t)arg->data);
+                DMA_SetCurrDataCounter(USE_DMA_TX, arg->size);
+                DMA_Cmd(USE_DMA_TX, ENABLE);
+                QSPI_DMACmd(USE_QSPI, QSPI_DMAReq_TX, ENABLE);
+                DMA_SoftwareTrigger(USE_DMA_TX);
 
-                    if (xSemaphoreTake(dma_done, portMAX_DELAY) == pdTRUE) {
-                        QSPI_DMACmd(USE_QSPI, QSPI_DMAReq_TX, DISABLE);
-                        DMA_Cmd(USE_DMA_TX, DISABLE);
-                    }
+                rt_sem_take(&dma_done, RT_WAITING_FOREVER);
+                QSPI_DMACmd(USE_QSPI, QSPI_DMAReq_TX, DISABLE);
+                DMA_Cmd(USE_DMA_TX, DISABLE);
 
-                    xSemaphoreGive(dma_mutex);
-                }
+                /* 等待最后一个字节移出后再拉高片选 */
+                while (QSPI_GetFlagStatus(USE_QSPI, QSPI_Flag_BUSY)) {}
             } break;
             default: break;
         }
     }
 
     GPIO_WriteBit(CHIP_GPIO_GRP, CHIP_GPIO_PIN, 1);
+    rt_mutex_release(&bus_lock);
+}
+
+/********** 芯片参数探测 **********/
+
+/* SFDP中的单位换算：JESD216 BFPT DWORD10/11 */
+static const uint16_t erase_unit_ms[4] = {1, 16, 128, 1000};
+static const uint16_t chip_unit_ms[4]  = {16, 256, 4000, 64000};
+
+/**
+ * @brief 解析SFDP基本参数表（BFPT）。
+ * @param bfpt 参数表的DWORD数组，下标0对应DWORD1。
+ * @param len 有效DWORD数。
+ * @retval
+ * @warning
+ * @note 只解析擦除与容量相关的字段，其余保持默认值。
+ */
+static void _w25q64_parse_bfpt(const uint32_t * const bfpt, const uint32_t len) {
+    /* DWORD2：容量（以bit为单位） */
+    const uint32_t density = bfpt[1];
+    if (density & 0x80000000) {
+        const uint32_t n = density & 0x7FFFFFFF;
+        geo.capacity     = (n >= 3 && n < 35) ? (1UL << (n - 3)) : geo.capacity;
+    } else {
+        geo.capacity = (density + 1) / 8;
+    }
+
+    /* DWORD1[18:17]：地址宽度，超过16MB时必须使用4字节地址 */
+    const uint32_t adr_mode = (bfpt[0] >> 17) & 0x3;
+    if ((adr_mode == 2) || (geo.capacity > 16 * 1024 * 1024)) {
+        geo.adr_bytes = 4;
+    } else {
+        geo.adr_bytes = 3;
+    }
+
+    /* DWORD8~9：四种擦除类型的粒度与指令 */
+    for (uint32_t i = 0; i < W25Q64_ERASE_TYPES; ++i) {
+        const uint32_t field = (bfpt[7 + i / 2] >> ((i % 2) * 16)) & 0xFFFF;
+        const uint32_t exp   = field & 0xFF;
+        geo.erase[i].size    = (exp > 0 && exp < 32) ? (1UL << exp) : 0;
+        geo.erase[i].opcode  = field >> 8;
+        geo.erase[i].typ_ms  = 0;
+    }
+
+    /* JESD216A以后才有DWORD10以后的时间参数 */
+    if (len >= 11) {
+        for (uint32_t i = 0; i < W25Q64_ERASE_TYPES; ++i) {
+            const uint32_t field = (bfpt[9] >> (4 + i * 7)) & 0x7F;
+            geo.erase[i].typ_ms  = ((field & 0x1F) + 1) * erase_unit_ms[field >> 5];
+        }
+
+        /* DWORD11：页大小、典型页编程时间与整片擦除时间 */
+        const uint32_t dw11 = bfpt[10];
+        const uint32_t pp   = (dw11 >> 8) & 0x3F;
+        const uint32_t ce   = (dw11 >> 24) & 0x7F;
+        geo.page_size       = 1UL << ((dw11 >> 4) & 0xF);
+        geo.page_us         = ((pp & 0x1F) + 1) * ((pp & 0x20) ? 64 : 8);
+        geo.chip_ms         = ((ce & 0x1F) + 1) * chip_unit_ms[ce >> 5];
+    }
+
+    if (len >= 15) {
+        geo.qe_method = (bfpt[14] >> 20) & 0x7;
+    }
+
+    geo.sfdp = 1;
+}
+
+/**
+ * @brief 读取JEDEC ID与SFDP参数表，更新芯片几何参数。
+ * @param
+ * @retval
+ * @warning 只在初始化时调用。
+ * @note 芯片不支持SFDP时，按JEDEC容量ID推算容量，其余保持默认值。
+ */
+static void _w25q64_probe(void) {
+    uint8_t    id[3] = {0};
+    w25q64_arg arg   = {.data = id, .size = sizeof(id)};
+    w25q64_ctl(ReadJEDECID, &arg);
+    geo.jedec_id = ((uint32_t)id[0] << 16) | ((uint32_t)id[1] << 8) | id[2];
+
+    /* 容量ID为2^N字节 */
+    if ((id[2] >= 0x10) && (id[2] < 0x20)) {
+        geo.capacity  = 1UL << id[2];
+        geo.adr_bytes = (geo.capacity > 16 * 1024 * 1024) ? 4 : 3;
+    }
+
+    /* SFDP头与第一个参数头 */
+    uint32_t hdr[4] = {0};
+    uint32_t adr    = 0;
+    arg.adr         = (const uint8_t *)&adr;
+    arg.data        = (volatile uint8_t *)hdr;
+    arg.size        = sizeof(hdr);
+    w25q64_ctl(ReadSFDP, &arg);
+    if (hdr[0] != 0x50444653) {  // "SFDP"
+        return;
+    }
+
+    /* 第一个参数头必须是BFPT（ID为0xFF00） */
+    uint32_t len = hdr[2] >> 24;
+    if (((hdr[2] & 0xFF) != 0x00) || ((hdr[3] >> 24) != 0xFF) || (len < 9)) {
+        return;
+    }
+    if (len > 16) {
+        len = 16;
+    }
+
+    uint32_t bfpt[16] = {0};
+    adr               = hdr[3] & 0xFFFFFF;
+    arg.data          = (volatile uint8_t *)bfpt;
+    arg.size          = len * 4;
+    w25q64_ctl(ReadSFDP, &arg);
+    _w25q64_parse_bfpt(bfpt, len);
+}
+
+/**
+ * @brief 按SFDP给出的方式置起四线使能位。
+ * @param
+ * @retval
+ * @warning 只在初始化时调用。
+ * @note 方式3（SR2 bit7，指令3Eh）很少见，不做处理。
+ */
+static void _w25q64_quad_enable(void) {
+    uint8_t    sr[2];
+    w25q64_arg arg = {.data = sr};
+
+    switch (geo.qe_method) {
+        case 1:
+        case 4:
+        case 5: {
+            /* QE在SR2 bit1，用01h连续写SR1与SR2 */
+            sr[0] = _w25q64_read_sr(ReadSR1);
+            sr[1] = _w25q64_read_sr(ReadSR2);
+            if (sr[1] & W25Q64_SR2_QE) {
+                return;
+            }
+            sr[1] |= W25Q64_SR2_QE;
+            arg.size = 2;
+            w25q64_ctl(WriteEnable, NULL);
+            w25q64_ctl(WriteSR1, &arg);
+        } break;
+        case 2: {
+            /* QE在SR1 bit6 */
+            sr[0] = _w25q64_read_sr(ReadSR1);
+            if (sr[0] & W25Q64_SR1_QE) {
+                return;
+            }
+            sr[0] |= W25Q64_SR1_QE;
+            arg.size = 1;
+            w25q64_ctl(WriteEnable, NULL);
+            w25q64_ctl(WriteSR1, &arg);
+        } break;
+        case 6: {
+            /* QE在SR2 bit1，用31h单独写SR2 */
+            sr[0] = _w25q64_read_sr(ReadSR2);
+            if (sr[0] & W25Q64_SR2_QE) {
+                return;
+            }
+            sr[0] |= W25Q64_SR2_QE;
+            arg.size = 1;
+            w25q64_ctl(WriteEnable, NULL);
+            w25q64_ctl(WriteSR2, &arg);
+        } break;
+        default: return;
+    }
+
+    /* 等待状态寄存器写入完成 */
+    while (_w25q64_read_sr(ReadSR1) & W25Q64_SR1_BUSY) {
+        rt_thread_delay(1);
+    }
+    OS_PRTF(INFO_LOG, "quad enable by method %u\n", geo.qe_method);
+}
+
+const w25q64_geo * w25q64_geometry(void) {
+    return &geo;
+}
+
+/********** 擦除/编程的暂停与恢复 **********/
+
+/**
+ * @brief 读取一个状态寄存器。
+ * @param cmd ReadSR1、ReadSR2或ReadSR3。
+ * @retval 寄存器的值。
+ * @warning
+ * @note
+ */
+static uint8_t _w25q64_read_sr(const w25q64_cmd cmd) {
+    uint8_t    sr;
+    w25q64_arg arg = {.data = &sr, .size = 1};
+    w25q64_ctl(cmd, &arg);
+    return sr;
+}
+
+/**
+ * @brief 判断一段地址是否与正在擦除/编程的范围重叠。
+ * @param adr 起始地址。
+ * @param size 字节数。
+ * @retval 1：重叠，或者正在整片擦除。
+ * @retval 0：不重叠，或者没有正在进行的操作。
+ * @warning 必须持有bus_lock。
+ * @note
+ */
+static uint8_t _w25q64_overlap(const uint32_t adr, const uint32_t size) {
+    return (op_cmd != 0) && (adr < op_end) && (op_adr < adr + size);
+}
+
+/**
+ * @brief 若芯片内部有擦除/编程正在进行，则为读取一段地址将其暂停。
+ * @param adr 将要读取的起始地址。
+ * @param size 将要读取的字节数。
+ * @retval 1：已暂停，访问结束后必须调用_w25q64_resume。
+ * @retval 0：没有需要暂停的操作，或者已经等到操作完成。
+ * @warning 必须持有bus_lock，且只持有一层；等待期间会释放bus_lock，
+ * 返回时已经重新取得，但其它线程可能在此期间发起过事务。
+ * @note 整片擦除不支持暂停；暂停期间读取正在擦除/编程的范围得到的数据不确定，
+ * 这两种情况只能等待操作完成。刚恢复不久的操作也要先推进RESUME_GUARD_TICK，
+ * 避免连续读取使其饿死。等待时释放总线，让执行擦除/编程的线程能够轮询完成并清除op_cmd，
+ * 其它读取也不必一起等待；重新取得总线后从头判断，因为操作可能已经结束或者换了一个。
+ */
+static uint8_t _w25q64_suspend(const uint32_t adr, const uint32_t size) {
+    while (op_cmd != 0) {
+        rt_int32_t tick;
+        if (_w25q64_overlap(adr, size)) {
+            tick = rt_tick_from_millisecond(ERASE_POLL_MS);
+        } else if (rt_tick_get() - resume_tick < RESUME_GUARD_TICK) {
+            tick = RESUME_GUARD_TICK;
+        } else {
+            break;
+        }
+
+        rt_mutex_release(&bus_lock);
+        rt_thread_delay(tick);
+        rt_mutex_take(&bus_lock, RT_WAITING_FOREVER);
+
+        /* 等待期间其它线程可能发起了预读，先替它结束，总线才可以使用 */
+        _w25q64_rx_finish();
+    }
+    if (op_cmd == 0) {
+        return 0;
+    }
+
+    if (!(_w25q64_read_sr(ReadSR1) & W25Q64_SR1_BUSY)) {
+        return 0;
+    }
+
+    w25q64_ctl(Suspend, NULL);
+    for (uint32_t us = 0; us < SUSPEND_US; ++us) {
+        if (!(_w25q64_read_sr(ReadSR1) & W25Q64_SR1_BUSY)) {
+            break;
+        }
+        rt_hw_us_delay(1);
+    }
+
+    /* 操作恰好在暂停前完成时SUS位不会置起 */
+    return (_w25q64_read_sr(ReadSR2) & W25Q64_SR2_SUS) ? 1 : 0;
+}
+
+/**
+ * @brief 恢复被暂停的擦除/编程。
+ * @param
+ * @retval
+ * @warning 必须持有bus_lock。
+ * @note
+ */
+static void _w25q64_resume(void) {
+    w25q64_ctl(Resume, NULL);
+    resume_tick = rt_tick_get();
+}
+
+/**
+ * @brief 写使能后发出擦除/编程指令。
+ * @param cmd 擦除/编程指令。
+ * @param arg 指令附带参数。
+ * @param adr 被改写范围的起始地址。
+ * @param size 被改写范围的字节数。
+ * @retval
+ * @warning 必须持有op_lock。
+ * @note 记下被改写的范围，读取这个范围时不能暂停本次操作。
+ */
+static void _w25q64_start(const w25q64_cmd         cmd,
+                          const w25q64_arg * const arg,
+                          const uint32_t           adr,
+                          const uint32_t           size) {
+    rt_mutex_take(&bus_lock, RT_WAITING_FOREVER);
+    w25q64_ctl(WriteEnable, NULL);
+    switch (cmd) {
+        case ProgramSPI:
+        case ProgramQSPI:
+        case EraseChip: {
+            w25q64_ctl(cmd, arg);
+        } break;
+        default: {
+            /* 擦除指令来自SFDP，可能不在w25q64_cmd范围内，单独发送地址 */
+            GPIO_WriteBit(CHIP_GPIO_GRP, CHIP_GPIO_PIN, 0);
+            const uint8_t opcode = cmd;
+            _w25q64_send_bytes(&opcode, 1);
+            _w25q64_send_bytes(arg->adr, geo.adr_bytes);
+            GPIO_WriteBit(CHIP_GPIO_GRP, CHIP_GPIO_PIN, 1);
+        } break;
+    }
+    op_adr = adr;
+    op_end = adr + size;
+    op_cmd = cmd;
+    rt_mutex_release(&bus_lock);
+}
+
+/**
+ * @brief 等待擦除/编程完成。
+ * @param typ_ms 典型耗时：先休眠这么久再开始轮询，0表示立即轮询。
+ * @param poll_ms 轮询间隔（单位ms），至少为1。
+ * @retval
+ * @warning 必须持有op_lock。
+ * @note 每次轮询之间释放总线并休眠，读取请求可以在此期间暂停本次操作，
+ * 优先级更低的线程也能运行；只让出处理器的忙轮询会在整个页编程期间饿死它们。
+ */
+static void _w25q64_wait_done(const uint32_t typ_ms, const rt_int32_t poll_ms) {
+    if (typ_ms > 0) {
+        rt_thread_delay(rt_tick_from_millisecond(typ_ms));
+    }
+
+    while (1) {
+        rt_mutex_take(&bus_lock, RT_WAITING_FOREVER);
+        if (!(_w25q64_read_sr(ReadSR1) & W25Q64_SR1_BUSY)) {
+            op_cmd = 0;
+            rt_mutex_release(&bus_lock);
+            return;
+        }
+        rt_mutex_release(&bus_lock);
+        rt_thread_mdelay(poll_ms);
+    }
+}
+
+/********** 高层读写接口 **********/
+
+rt_err_t w25q64_read(const uint32_t adr, void * const buf, const uint32_t size) {
+    return w25q64_read_cmd(ReadDataSPI, adr, buf, size);
+}
+
+rt_err_t w25q64_read_cmd(const w25q64_cmd cmd,
+                         const uint32_t   adr,
+                         void * const     buf,
+                         const uint32_t   size) {
+    switch (cmd) {
+        case ReadDataSPI:
+        case ReadDataDSPI:
+        case ReadDataQSPI: break;
+        default: return -RT_EINVAL;
+    }
+
+    w25q64_arg arg = {
+        .adr  = (const uint8_t *)&adr,
+        .data = (volatile uint8_t *)buf,
+        .size = size,
+    };
+
+    rt_mutex_take(&bus_lock, RT_WAITING_FOREVER);
+    const uint8_t suspended = _w25q64_suspend(adr, size);
+    w25q64_ctl(cmd, &arg);
+    if (suspended) {
+        _w25q64_resume();
+    }
+    rt_mutex_release(&bus_lock);
+
+    return RT_EOK;
+}
+
+rt_err_t w25q64_read_start(const uint32_t adr, void * const buf, const uint32_t size) {
+    rt_mutex_take(&bus_lock, RT_WAITING_FOREVER);
+    _w25q64_rx_finish();
+    if (_w25q64_overlap(adr, size)) {
+        rt_mutex_release(&bus_lock);
+        return -RT_EBUSY;
+    }
+    rx_suspended = _w25q64_suspend(adr, size);
+    _w25q64_wakeup();
+
+    const uint8_t opcode = ReadDataSPI;
+    GPIO_WriteBit(CHIP_GPIO_GRP, CHIP_GPIO_PIN, 0);
+    _w25q64_send_bytes(&opcode, 1);
+    _w25q64_send_bytes((const uint8_t *)&adr, geo.adr_bytes);
+    _w25q64_rx_start((volatile uint8_t *)buf, size);
+    rt_mutex_release(&bus_lock);
+
+    return RT_EOK;
+}
+
+void w25q64_read_wait(void) {
+    if (!rx_pending) {
+        return;
+    }
+    rt_mutex_take(&bus_lock, RT_WAITING_FOREVER);
+    _w25q64_rx_finish();
+    rt_mutex_release(&bus_lock);
+}
+
+rt_err_t w25q64_program(const uint32_t adr, const void * const buf, uint32_t size) {
+    uint32_t        cur  = adr;
+    const uint8_t * data = (const uint8_t *)buf;
+
+    rt_mutex_take(&op_lock, RT_WAITING_FOREVER);
+    while (size > 0) {
+        /* 不能跨页编程 */
+        uint32_t len = geo.page_size - (cur % geo.page_size);
+        if (len > size) {
+            len = size;
+        }
+
+        w25q64_arg arg = {
+            .adr  = (const uint8_t *)&cur,
+            .data = (volatile uint8_t *)data,
+            .size = len,
+        };
+        _w25q64_start(ProgramSPI, &arg, cur, len);
+        _w25q64_wait_done(0, PROGRAM_POLL_MS);
+
+        cur += len;
+        data += len;
+        size -= len;
+    }
+    rt_mutex_release(&op_lock);
+
+    return RT_EOK;
+}
+
+rt_err_t w25q64_erase(const w25q64_cmd cmd, const uint32_t adr) {
+    uint32_t size;
+    switch (cmd) {
+        case Erase4KB: size = 4 * 1024; break;
+        case Erase32KB: size = 32 * 1024; break;
+        case Erase64KB: size = 64 * 1024; break;
+        case EraseChip: size = 0; break;
+        default: return -RT_EINVAL;
+    }
+
+    /* 在探测到的擦除类型中查找对应粒度 */
+    w25q64_cmd opcode = EraseChip;
+    uint32_t   typ_ms = geo.chip_ms;
+    if (size > 0) {
+        uint32_t i = 0;
+        while ((i < W25Q64_ERASE_TYPES) && (geo.erase[i].size != size)) {
+            ++i;
+        }
+        if (i == W25Q64_ERASE_TYPES) {
+            return -RT_ENOSYS;
+        }
+        opcode = (w25q64_cmd)geo.erase[i].opcode;
+        typ_ms = geo.erase[i].typ_ms;
+    }
+
+    w25q64_arg arg = {.adr = (const uint8_t *)&adr};
+
+    rt_mutex_take(&op_lock, RT_WAITING_FOREVER);
+    if (size > 0) {
+        _w25q64_start(opcode, &arg, adr & ~(size - 1), size);
+    } else {
+        _w25q64_start(opcode, NULL, 0, geo.capacity);
+    }
+    _w25q64_wait_done(typ_ms, ERASE_POLL_MS);
+    rt_mutex_release(&op_lock);
+
+    return RT_EOK;
 }
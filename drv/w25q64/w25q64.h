@@ -3,7 +3,11 @@
 
 /**
  * @brief 这是w25q64驱动模块。
- * @details 先初始化模块。
+ * @details 先初始化模块；再调用w25q64_read/w25q64_program/w25q64_erase进行读写擦除。
+ * 初始化时读取JEDEC ID与SFDP参数表，得到容量、擦除粒度与指令、典型擦除时间和四线使能方式，
+ * 因此同一驱动可以用于W25Q32/64/128/256等芯片。
+ * 擦除或编程进行中时，读取请求会自动暂停（0x75）正在进行的操作，读取完成后再恢复（0x7A）。
+ * 空闲一段时间后自动进入深度掉电（0xB9），下一次访问前自动唤醒（0xAB）。
  * @file w25q64.h
  * @author proyrb
  * @date 2025/7/28
@@ -12,9 +16,9 @@
 
 /********** 导入需要的头文件 **********/
 
-#include "sc32_conf.h"
-#include "FreeRTOS.h"
-#include "semphr.h"
+#include <sc32_conf.h>
+#include <rtthread.h>
+#include <log.h>
 
 /********** 选择 gpio 引脚 **********/
 
@@ -39,16 +43,46 @@
 
 /********** 配置设备信息 **********/
 
-// 以MSB方式接收后再以小端格式存储的设备唯一ID
-#define W25Q64_Unique_ID 0x353E730B973C60DF
+// 页大小：芯片没有提供SFDP时使用，一次编程不能跨页
+#define W25Q64_PAGE_SIZE 256
+
+// SFDP中擦除类型的个数
+#define W25Q64_ERASE_TYPES 4
 
 /********** 模块行为 **********/
 
 #ifdef W25Q64_C
 // 是否整片擦除
 #    define CHIP_ERASE 0
+
+// 发出暂停指令后等待芯片进入暂停状态的最长时间（tSUS，单位us）
+#    define SUSPEND_US 20
+
+// 恢复后至少经过多少个tick才允许再次暂停，保证擦除/编程能够向前推进
+#    define RESUME_GUARD_TICK 1
+
+// 擦除时轮询忙标志的间隔（单位ms）
+#    define ERASE_POLL_MS 1
+
+// 页编程时轮询忙标志的间隔（单位ms），页编程典型耗时不到1ms
+#    define PROGRAM_POLL_MS 1
+
+// 空闲多久后进入深度掉电（单位ms），0表示不自动掉电
+#    define PD_IDLE_MS 100
+
+// 进入掉电所需时间（tDP）与退出掉电所需时间（tRES1），单位us
+#    define PD_ENTER_US 3
+#    define PD_EXIT_US  3
 #endif  // W25Q64_C
 
+/********** 状态寄存器位 **********/
+
+#define W25Q64_SR1_BUSY 0x01  // 擦除或编程进行中
+#define W25Q64_SR1_WEL  0x02  // 写使能锁存
+#define W25Q64_SR1_QE   0x40  // 部分芯片的QE位在SR1
+#define W25Q64_SR2_QE   0x02  // 四线使能
+#define W25Q64_SR2_SUS  0x80  // 擦除或编程已暂停
+
 /********** 常用指令 **********/
 
 typedef enum {
@@ -59,11 +93,14 @@ typedef enum {
     /********** 读取指令 **********/
 
     ReadUniqueID = 0x4B,
+    ReadJEDECID  = 0x9F,
+    ReadSFDP     = 0x5A,
     ReadSR1      = 0x05,
     ReadSR2      = 0x35,
     ReadSR3      = 0x15,
     ReadDataSPI  = 0x03,
-    ReadDataQSPI = 0x6B,  // 4线读取和DMA搬运有问题
+    ReadDataDSPI = 0x3B,  // 2线读取，逐字节接收
+    ReadDataQSPI = 0x6B,  // 4线读取和DMA搬运有问题，逐字节接收
 
     /********** 擦写指令 **********/
 
@@ -75,26 +112,70 @@ typedef enum {
     EraseChip    = 0xC7,
     ProgramSPI   = 0x02,
     ProgramQSPI  = 0x32,
+    WriteSR1     = 0x01,  // 部分芯片可以连续写入SR1与SR2
+    WriteSR2     = 0x31,
+
+    /********** 地址模式指令 **********/
+
+    Enter4ByteAdr = 0xB7,
+
+    /********** 电源管理指令 **********/
+
+    PowerDown        = 0xB9,  // 进入深度掉电
+    ReleasePowerDown = 0xAB,  // 退出深度掉电
+
+    /********** 暂停与恢复指令 **********/
+
+    Suspend = 0x75,  // 暂停正在进行的擦除或编程
+    Resume  = 0x7A,  // 恢复被暂停的擦除或编程
 } w25q64_cmd;
 
 /********** 指令附带参数 **********/
 
 typedef struct {
-    const uint8_t *    adr;   // 3字节的地址
+    const uint8_t *    adr;   // 小端存放的地址，按当前地址宽度发送
     volatile uint8_t * data;  // 变字节数据
     uint32_t           size;  // 数据长度
 } w25q64_arg;
 
+/********** 芯片几何参数 **********/
+
+typedef struct {
+    uint32_t size;    // 擦除粒度（字节），0表示不支持该类型
+    uint8_t  opcode;  // 擦除指令
+    uint32_t typ_ms;  // 典型擦除时间
+} w25q64_erase_type;
+
+typedef struct {
+    uint32_t          jedec_id;   // 厂商ID、存储类型、容量ID
+    uint32_t          capacity;   // 容量（字节）
+    uint32_t          page_size;  // 页大小（字节）
+    uint32_t          page_us;    // 典型页编程时间
+    uint32_t          chip_ms;    // 典型整片擦除时间
+    uint8_t           adr_bytes;  // 地址宽度：3或4
+    uint8_t           qe_method;  // SFDP的四线使能方式（JESD216 BFPT DWORD15[22:20]）
+    uint8_t           sfdp;       // 1：参数来自SFDP；0：按JEDEC ID推算
+    w25q64_erase_type erase[W25Q64_ERASE_TYPES];
+} w25q64_geo;
+
+/********** 深度掉电统计 **********/
+
+typedef struct {
+    uint8_t   down;        // 当前是否处于掉电状态
+    uint32_t  down_count;  // 进入掉电的次数
+    rt_tick_t down_ticks;  // 累计处于掉电状态的tick数（包括当前这一次）
+} w25q64_pd_stat;
+
 /********** 导出的函数 **********/
 
 /**
  * @brief 初始化w25q64模块。
  * @param
- * @retval
+ * @retval RT_EOK：初始化成功。
  * @warning 必须先初始化模块后才能进行后续操作。
  * @note
  */
-BaseType_t w25q64_init(void);
+extern int w25q64_init(void);
 
 /**
  * @brief dma中断处理。
@@ -103,7 +184,7 @@ BaseType_t w25q64_init(void);
  * @warning 禁止在非中断中调用。
  * @note
  */
-void w25q64_dma_irq(void);
+extern void w25q64_dma_irq(void);
 
 /**
  * @brief 发送控制指令与附带的可选参数。
@@ -112,8 +193,103 @@ void w25q64_dma_irq(void);
  * 非NULL时，如果cmd值不在给定范围内，则不会发送该字节流。
  * @retval
  * @warning 线程安全；同步的。
+ * @note 不会处理擦除/编程的暂停与等待，一般请使用w25q64_read等高层接口。
+ */
+extern void w25q64_ctl(const w25q64_cmd cmd, const w25q64_arg * const arg);
+
+/**
+ * @brief 获取初始化时探测到的芯片几何参数。
+ * @param
+ * @retval 几何参数，只读。
+ * @warning 必须先初始化模块。
  * @note
  */
-void w25q64_ctl(const w25q64_cmd cmd, const w25q64_arg * const arg);
+extern const w25q64_geo * w25q64_geometry(void);
+
+/**
+ * @brief 获取深度掉电统计。
+ * @param stat 接收统计结果。
+ * @retval
+ * @warning
+ * @note 空闲超过PD_IDLE_MS后自动掉电，下一次访问时自动唤醒，调用者无需关心。
+ */
+extern void w25q64_pd_stat_get(w25q64_pd_stat * const stat);
+
+/**
+ * @brief 从指定地址读取数据。
+ * @param adr 起始地址。
+ * @param buf 接收缓冲区。
+ * @param size 读取字节数。
+ * @retval RT_EOK：读取成功。
+ * @warning 线程安全；同步的。
+ * @note 若有擦除或编程正在进行，会先暂停它，读取完成后再恢复；
+ * 读取范围与正在擦除或编程的范围重叠时不能暂停，改为等待它完成。
+ */
+extern rt_err_t w25q64_read(const uint32_t adr, void * const buf, const uint32_t size);
+
+/**
+ * @brief 用指定的读取指令从指定地址读取数据。
+ * @param cmd 读取指令：ReadDataSPI、ReadDataDSPI或ReadDataQSPI。
+ * @param adr 起始地址。
+ * @param buf 接收缓冲区。
+ * @param size 读取字节数。
+ * @retval RT_EOK：读取成功。
+ * @retval -RT_EINVAL：cmd不是读取指令。
+ * @warning 线程安全；同步的；2线与4线读取逐字节接收，不使用DMA。
+ * @note 与w25q64_read一样会暂停正在进行的擦除或编程。
+ */
+extern rt_err_t w25q64_read_cmd(const w25q64_cmd cmd,
+                                const uint32_t   adr,
+                                void * const     buf,
+                                const uint32_t   size);
+
+/**
+ * @brief 启动一次DMA读取后立即返回。
+ * @param adr 起始地址。
+ * @param buf 接收缓冲区：在w25q64_read_wait返回前不能使用。
+ * @param size 读取字节数。
+ * @retval RT_EOK：已经启动。
+ * @retval -RT_EBUSY：读取范围正在擦除或编程，没有启动，请改用w25q64_read。
+ * @warning 线程安全；异步的。
+ * @note 传输期间总线锁已经释放，其它访问会先等待本次传输结束；
+ * 用于在处理当前数据的同时预读下一段数据。
+ * 其它范围上正在进行的擦除或编程会被暂停，传输结束时恢复。
+ */
+extern rt_err_t w25q64_read_start(const uint32_t adr,
+                                  void * const   buf,
+                                  const uint32_t size);
+
+/**
+ * @brief 等待w25q64_read_start启动的读取完成。
+ * @param
+ * @retval
+ * @warning 线程安全；同步的。
+ * @note 没有正在进行的读取时立即返回。
+ */
+extern void w25q64_read_wait(void);
+
+/**
+ * @brief 向指定地址编程数据。
+ * @param adr 起始地址：可以不按页对齐，会自动按页拆分。
+ * @param buf 数据缓冲区。
+ * @param size 编程字节数。
+ * @retval RT_EOK：编程成功。
+ * @warning 线程安全；同步的；目标区域必须已经擦除。
+ * @note 等待编程完成期间会释放总线，允许读取请求暂停本次编程。
+ */
+extern rt_err_t w25q64_program(const uint32_t adr, const void * const buf, uint32_t size);
+
+/**
+ * @brief 擦除指定地址所在的块。
+ * @param cmd 擦除指令：Erase4KB、Erase32KB、Erase64KB或EraseChip。
+ * @param adr 块内任意地址，EraseChip时忽略。
+ * @retval RT_EOK：擦除成功。
+ * @retval -RT_EINVAL：cmd不是擦除指令。
+ * @retval -RT_ENOSYS：芯片不支持该擦除粒度。
+ * @warning 线程安全；同步的。
+ * @note cmd只表示擦除粒度，实际指令取自探测到的几何参数；
+ * 等待擦除完成期间会释放总线，允许读取请求暂停本次擦除。
+ */
+extern rt_err_t w25q64_erase(const w25q64_cmd cmd, const uint32_t adr);
 
 #endif  // W25Q64_H
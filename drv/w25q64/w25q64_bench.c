@@ -0,0 +1,285 @@
+#define W25Q64_BENCH_C
+
+#include <w25q64_bench.h>
+
+/********** 统计 **********/
+
+typedef struct {
+    uint32_t cnt;    // 次数
+    uint32_t min;    // 最短耗时（us）
+    uint32_t max;    // 最长耗时（us）
+    uint64_t sum;    // 累计耗时（us）
+    uint64_t bytes;  // 累计字节数
+} bench_stat;
+
+static void _stat_reset(bench_stat * const stat) {
+    stat->cnt   = 0;
+    stat->min   = UINT32_MAX;
+    stat->max   = 0;
+    stat->sum   = 0;
+    stat->bytes = 0;
+}
+
+static void _stat_add(bench_stat * const stat, const uint32_t us, const uint32_t bytes) {
+    ++stat->cnt;
+    stat->min = (us < stat->min) ? us : stat->min;
+    stat->max = (us > stat->max) ? us : stat->max;
+    stat->sum += us;
+    stat->bytes += bytes;
+}
+
+static void _stat_print(const w25q64_bench_ops * const ops,
+                        const char * const             name,
+                        const bench_stat * const       stat) {
+    if (stat->cnt == 0) {
+        ops->print("%-12s skipped\n", name);
+        return;
+    }
+
+    const uint32_t avg  = (uint32_t)(stat->sum / stat->cnt);
+    uint32_t       rate = 0;
+    if (stat->sum > 0) {
+        rate = (uint32_t)(stat->bytes * 1000000 / stat->sum);
+    }
+    ops->print("%-12s n=%-4u min=%-8u avg=%-8u max=%-8u us  %u B/s\n", name, stat->cnt,
+               stat->min, avg, stat->max, rate);
+}
+
+/**
+ * @brief 计时执行一次读取。
+ * @param ops 访问接口。
+ * @param stat 统计结果。
+ * @param lines 线数。
+ * @param adr 地址。
+ * @param buf 缓冲区。
+ * @param size 字节数。
+ * @retval 0：成功。
+ * @warning
+ * @note
+ */
+static int _bench_read(const w25q64_bench_ops * const ops,
+                       bench_stat * const             stat,
+                       const uint8_t                  lines,
+                       const uint32_t                 adr,
+                       uint8_t * const                buf,
+                       const uint32_t                 size) {
+    const uint32_t start = ops->now_us();
+    if (ops->read(lines, adr, buf, size) != 0) {
+        return -1;
+    }
+    _stat_add(stat, ops->now_us() - start, size);
+    return 0;
+}
+
+static int _bench_erase(const w25q64_bench_ops * const ops,
+                        bench_stat * const             stat,
+                        const uint32_t                 size,
+                        const uint32_t                 adr) {
+    const uint32_t start = ops->now_us();
+    if (ops->erase(size, adr) != 0) {
+        return -1;
+    }
+    _stat_add(stat, ops->now_us() - start, size);
+    return 0;
+}
+
+/********** 测试流程 **********/
+
+int w25q64_bench_run(const w25q64_bench_ops * const ops,
+                     const uint32_t                 scratch,
+                     uint8_t * const                buf,
+                     const uint32_t                 buf_size) {
+    if ((scratch % W25Q64_BENCH_SCRATCH != 0) ||
+        (scratch + W25Q64_BENCH_SCRATCH > ops->capacity) || (buf_size < ops->page_size) ||
+        (buf_size > W25Q64_BENCH_SCRATCH)) {
+        ops->print("flashbench: bad scratch 0x%X or buffer %u\n", scratch, buf_size);
+        return -1;
+    }
+
+    bench_stat stat;
+    char       name[16] = "seq read xL";
+
+    ops->print("flashbench: %u KB part, scratch 0x%X, %u B per read\n",
+               ops->capacity / 1024, scratch, buf_size);
+
+    /********** 读取：1、2、4线，顺序与随机 **********/
+
+    static const uint8_t lines_list[] = {1, 2, 4};
+    for (uint32_t l = 0; l < sizeof(lines_list); ++l) {
+        const uint8_t lines = lines_list[l];
+
+        _stat_reset(&stat);
+        for (uint32_t off = 0; off < SEQ_READ_TOTAL; off += buf_size) {
+            const uint32_t adr = scratch + (off % W25Q64_BENCH_SCRATCH);
+            if (_bench_read(ops, &stat, lines, adr, buf, buf_size) != 0) {
+                return -1;
+            }
+        }
+        name[10] = '0' + lines;
+        _stat_print(ops, name, &stat);
+
+        /* 固定种子的线性同余序列，保证多次运行可比 */
+        uint32_t seed = 0x2545F491;
+        _stat_reset(&stat);
+        for (uint32_t i = 0; i < RAND_READ_CNT; ++i) {
+            seed               = seed * 1664525 + 1013904223;
+            const uint32_t adr = (seed % (ops->capacity / buf_size)) * buf_size;
+            if (_bench_read(ops, &stat, lines, adr, buf, buf_size) != 0) {
+                return -1;
+            }
+        }
+        name[0] = 'r', name[1] = 'n', name[2] = 'd';
+        _stat_print(ops, name, &stat);
+        name[0] = 's', name[1] = 'e', name[2] = 'q';
+    }
+
+    /********** 擦除：64KB与32KB **********/
+
+    _stat_reset(&stat);
+    for (uint32_t i = 0; i < 2; ++i) {
+        if (_bench_erase(ops, &stat, 64 * 1024, scratch) != 0) {
+            return -1;
+        }
+    }
+    _stat_print(ops, "erase 64KB", &stat);
+
+    _stat_reset(&stat);
+    for (uint32_t i = 0; i < ERASE_32K_CNT; ++i) {
+        if (_bench_erase(ops, &stat, 32 * 1024, scratch + (i % 2) * 32 * 1024) != 0) {
+            return -1;
+        }
+    }
+    _stat_print(ops, "erase 32KB", &stat);
+
+    /********** 页编程并校验 **********/
+
+    for (uint32_t i = 0; i < ops->page_size; ++i) {
+        buf[i] = (uint8_t)(i * 7 + 1);
+    }
+
+    _stat_reset(&stat);
+    for (uint32_t off = 0; off < W25Q64_BENCH_SCRATCH; off += ops->page_size) {
+        const uint32_t start = ops->now_us();
+        if (ops->program(scratch + off, buf, ops->page_size) != 0) {
+            return -1;
+        }
+        _stat_add(&stat, ops->now_us() - start, ops->page_size);
+    }
+    _stat_print(ops, "program", &stat);
+
+    uint32_t bad = 0;
+    for (uint32_t off = 0; off < W25Q64_BENCH_SCRATCH; off += ops->page_size) {
+        if (ops->read(1, scratch + off, buf, ops->page_size) != 0) {
+            return -1;
+        }
+        for (uint32_t i = 0; i < ops->page_size; ++i) {
+            bad += (buf[i] != (uint8_t)(i * 7 + 1));
+        }
+    }
+    ops->print("verify       %u bad bytes\n", bad);
+
+    /********** 擦除：4KB（擦除已编程的扇区更接近实际耗时） **********/
+
+    _stat_reset(&stat);
+    for (uint32_t i = 0; i < ERASE_4K_CNT; ++i) {
+        const uint32_t adr = scratch + (i % (W25Q64_BENCH_SCRATCH / 4096)) * 4096;
+        if (_bench_erase(ops, &stat, 4 * 1024, adr) != 0) {
+            return -1;
+        }
+    }
+    _stat_print(ops, "erase 4KB", &stat);
+
+    return 0;
+}
+
+/********** 板上的MSH命令 **********/
+
+#ifndef W25Q64_BENCH_HOST
+
+#    include <w25q64.h>
+#    include <stdlib.h>
+
+// 每次读取的字节数
+#    define BENCH_BUF_SIZE 512
+
+/**
+ * @brief 由tick与SysTick计数值组合出微秒时间戳。
+ * @param
+ * @retval 微秒时间戳。
+ * @warning
+ * @note 读取期间发生tick更新时重新读取。
+ */
+static uint32_t _bench_now_us(void) {
+    const uint32_t us_per_tick = 1000000 / RT_TICK_PER_SECOND;
+    const uint32_t cnt_per_us  = (SysTick->LOAD + 1) / us_per_tick;
+
+    rt_tick_t tick;
+    uint32_t  val;
+    do {
+        tick = rt_tick_get();
+        val  = SysTick->VAL;
+    } while (tick != rt_tick_get());
+
+    return tick * us_per_tick + (SysTick->LOAD - val) / cnt_per_us;
+}
+
+static int _bench_read_dev(uint8_t lines, uint32_t adr, void * buf, uint32_t size) {
+    w25q64_cmd cmd = ReadDataSPI;
+    if (lines == 2) {
+        cmd = ReadDataDSPI;
+    } else if (lines == 4) {
+        cmd = ReadDataQSPI;
+    }
+    return (w25q64_read_cmd(cmd, adr, buf, size) == RT_EOK) ? 0 : -1;
+}
+
+static int _bench_program_dev(uint32_t adr, const void * buf, uint32_t size) {
+    return (w25q64_program(adr, buf, size) == RT_EOK) ? 0 : -1;
+}
+
+static int _bench_erase_dev(uint32_t size, uint32_t adr) {
+    w25q64_cmd cmd = Erase4KB;
+    if (size == 32 * 1024) {
+        cmd = Erase32KB;
+    } else if (size == 64 * 1024) {
+        cmd = Erase64KB;
+    }
+    return (w25q64_erase(cmd, adr) == RT_EOK) ? 0 : -1;
+}
+
+/**
+ * @brief flashbench [scratch]：测试w25q64的读取、编程与擦除性能。
+ * @param argc 参数个数。
+ * @param argv 可选的scratch地址，默认使用芯片最后64KB。
+ * @retval
+ * @warning 会破坏scratch区域的数据。
+ * @note
+ */
+static void flashbench(int argc, char ** argv) {
+    const w25q64_geo * const geo = w25q64_geometry();
+    const w25q64_bench_ops   ops = {
+          .capacity  = geo->capacity,
+          .page_size = geo->page_size,
+          .now_us    = _bench_now_us,
+          .read      = _bench_read_dev,
+          .program   = _bench_program_dev,
+          .erase     = _bench_erase_dev,
+          .print     = rt_kprintf,
+    };
+
+    uint32_t scratch = geo->capacity - W25Q64_BENCH_SCRATCH;
+    if (argc > 1) {
+        scratch = strtoul(argv[1], RT_NULL, 0);
+    }
+
+    uint8_t * buf = rt_malloc(BENCH_BUF_SIZE);
+    if (buf == RT_NULL) {
+        rt_kprintf("flashbench: no memory\n");
+        return;
+    }
+    w25q64_bench_run(&ops, scratch, buf, BENCH_BUF_SIZE);
+    rt_free(buf);
+}
+MSH_CMD_EXPORT(flashbench, W25Q64 throughput benchmark : flashbench[scratch]);
+
+#endif  // W25Q64_BENCH_HOST
@@ -0,0 +1,77 @@
+#ifndef W25Q64_BENCH_H
+#define W25Q64_BENCH_H
+
+/**
+ * @brief 这是w25q64的带宽测试模块。
+ * @details 通过w25q64_bench_ops访问存储器，因此同一套测试既可以在板上通过MSH命令flashbench运行，
+ * 也可以在主机上对着带时序模型的模拟芯片运行（见tool/flashbench.c）。
+ * @file w25q64_bench.h
+ * @author proyrb
+ * @date 2025/8/14
+ * @note 测试会擦除并改写scratch起始的64KB区域。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <stdint.h>
+
+/********** 配置模块行为 **********/
+
+// 测试会破坏的区域大小，必须是64KB的整数倍
+#define W25Q64_BENCH_SCRATCH (64 * 1024)
+
+#ifdef W25Q64_BENCH_C
+
+// 顺序读取的总字节数
+#    define SEQ_READ_TOTAL (32 * 1024)
+
+// 随机读取的次数
+#    define RAND_READ_CNT 64
+
+// 4KB与32KB擦除的次数（64KB擦除固定2次）
+#    define ERASE_4K_CNT  4
+#    define ERASE_32K_CNT 2
+
+#endif  // W25Q64_BENCH_C
+
+/********** 访问接口 **********/
+
+typedef struct {
+    uint32_t capacity;   // 芯片容量
+    uint32_t page_size;  // 页大小
+
+    /* 微秒时间戳，允许回绕 */
+    uint32_t (*now_us)(void);
+
+    /* 用lines（1、2或4）线读取，返回0表示成功 */
+    int (*read)(uint8_t lines, uint32_t adr, void * buf, uint32_t size);
+
+    /* 编程，调用者保证不跨页，返回0表示成功 */
+    int (*program)(uint32_t adr, const void * buf, uint32_t size);
+
+    /* 擦除size（4KB、32KB或64KB）大小的块，返回0表示成功 */
+    int (*erase)(uint32_t size, uint32_t adr);
+
+    /* 输出结果 */
+    int (*print)(const char * fmt, ...);
+} w25q64_bench_ops;
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 运行全部带宽测试并打印结果。
+ * @param ops 访问接口。
+ * @param scratch 可以破坏的区域起始地址，必须按64KB对齐。
+ * @param buf 测试缓冲区：大小至少为一页。
+ * @param buf_size 缓冲区字节数，也是每次读取的字节数。
+ * @retval 0：测试完成。
+ * @retval -1：参数错误或访问失败。
+ * @warning 会擦除scratch起始的W25Q64_BENCH_SCRATCH字节。
+ * @note 输出每项的最小/平均/最大耗时与吞吐率。
+ */
+extern int w25q64_bench_run(const w25q64_bench_ops * const ops,
+                            const uint32_t                 scratch,
+                            uint8_t * const                buf,
+                            const uint32_t                 buf_size);
+
+#endif  // W25Q64_BENCH_H
@@ -0,0 +1,217 @@
+#define W25Q64_POOL_C
+
+#include <w25q64_pool.h>
+
+#define MAP_SIZE (W25Q64_POOL_SECTORS / 8)
+
+static struct rt_mutex     pool_lock;   // 保护下面所有状态
+static struct rt_semaphore hint_sem;    // 唤醒后台擦除线程
+static struct rt_semaphore claim_done;  // 通知等待正在擦除扇区的写入者
+
+static uint8_t  dirty_map[MAP_SIZE];   // 待擦除的扇区
+static uint8_t  erased_map[MAP_SIZE];  // 已预擦除的扇区
+static uint32_t ready  = 0;            // 已预擦除的扇区数
+static uint32_t cursor = 0;            // 下一次查找待擦除扇区的起点
+
+static uint32_t erasing_first = 0;  // 正在后台擦除的第一个扇区
+static uint32_t erasing_cnt   = 0;  // 正在后台擦除的扇区数，0表示空闲
+static uint32_t claim_mask    = 0;  // 擦除期间被写入者取回的扇区
+static uint32_t claim_waiters = 0;  // 等待擦除完成的写入者数
+
+/********** 位图操作 **********/
+
+static __inline uint8_t _map_get(const uint8_t * const map, const uint32_t sec) {
+    return (map[sec >> 3] >> (sec & 0x7)) & 0x1;
+}
+
+static __inline void _map_set(uint8_t * const map, const uint32_t sec) {
+    map[sec >> 3] |= (uint8_t)(1 << (sec & 0x7));
+}
+
+static __inline void _map_clr(uint8_t * const map, const uint32_t sec) {
+    map[sec >> 3] &= (uint8_t)~(1 << (sec & 0x7));
+}
+
+/**
+ * @brief 判断扇区是否正在后台擦除。
+ * @param sec 扇区号。
+ * @retval 1：正在擦除。
+ * @retval 0：不在擦除。
+ * @warning 必须持有pool_lock。
+ * @note
+ */
+static uint8_t _pool_erasing(const uint32_t sec) {
+    return (erasing_cnt > 0) && (sec >= erasing_first) &&
+           (sec < erasing_first + erasing_cnt);
+}
+
+/**
+ * @brief 唤醒后台擦除线程。
+ * @param
+ * @retval
+ * @warning
+ * @note 信号量只作为唤醒标志，不累积计数。
+ */
+static void _pool_wake(void) {
+    if (hint_sem.value == 0) {
+        rt_sem_release(&hint_sem);
+    }
+}
+
+/**
+ * @brief 挑选并擦除下一批待擦除扇区。
+ * @param
+ * @retval RT_EOK：完成了一次擦除。
+ * @retval -RT_EEMPTY：扇区池已满或没有待擦除扇区。
+ * @warning 只在后台擦除线程中调用。
+ * @note 64KB对齐的整块都待擦除且池内空间足够时，使用一次64KB擦除。
+ */
+static rt_err_t _pool_erase_next(void) {
+    rt_mutex_take(&pool_lock, RT_WAITING_FOREVER);
+
+    if (ready >= POOL_DEPTH) {
+        rt_mutex_release(&pool_lock);
+        return -RT_EEMPTY;
+    }
+
+    /* 从上次的位置开始查找，使磨损分散 */
+    uint32_t sec = cursor;
+    uint32_t n   = 0;
+    for (; n < W25Q64_POOL_SECTORS; ++n) {
+        if (_map_get(dirty_map, sec)) {
+            break;
+        }
+        sec = (sec + 1) % W25Q64_POOL_SECTORS;
+    }
+    if (n == W25Q64_POOL_SECTORS) {
+        rt_mutex_release(&pool_lock);
+        return -RT_EEMPTY;
+    }
+
+    /* 判断能否整块擦除 */
+    uint32_t   cnt = 1;
+    w25q64_cmd cmd = Erase4KB;
+    if ((sec % BLOCK_SECTORS == 0) && (ready + BLOCK_SECTORS <= POOL_DEPTH)) {
+        uint32_t i = 1;
+        while ((i < BLOCK_SECTORS) && _map_get(dirty_map, sec + i)) {
+            ++i;
+        }
+        if (i == BLOCK_SECTORS) {
+            cnt = BLOCK_SECTORS;
+            cmd = Erase64KB;
+        }
+    }
+
+    for (uint32_t i = 0; i < cnt; ++i) {
+        _map_clr(dirty_map, sec + i);
+    }
+    erasing_first = sec;
+    erasing_cnt   = cnt;
+    claim_mask    = 0;
+    cursor        = (sec + cnt) % W25Q64_POOL_SECTORS;
+    rt_mutex_release(&pool_lock);
+
+    w25q64_erase(cmd, sec * W25Q64_SECTOR_SIZE);
+
+    rt_mutex_take(&pool_lock, RT_WAITING_FOREVER);
+    for (uint32_t i = 0; i < cnt; ++i) {
+        /* 擦除期间被取回的扇区已经直接交给写入者 */
+        if (!(claim_mask & (1UL << i))) {
+            _map_set(erased_map, sec + i);
+            ++ready;
+        }
+    }
+    erasing_cnt = 0;
+    while (claim_waiters > 0) {
+        --claim_waiters;
+        rt_sem_release(&claim_done);
+    }
+    rt_mutex_release(&pool_lock);
+
+    return RT_EOK;
+}
+
+/**
+ * @brief 后台擦除线程。
+ * @param thread_args 任务参数：暂时没有使用。
+ * @retval
+ * @warning
+ * @note
+ */
+static void _pool_thread(void * thread_args) {
+    while (1) {
+        rt_sem_take(&hint_sem, RT_WAITING_FOREVER);
+        while (_pool_erase_next() == RT_EOK) {}
+    }
+}
+
+int w25q64_pool_init(void) {
+    rt_mutex_init(&pool_lock, "plock", RT_IPC_FLAG_PRIO);
+    rt_sem_init(&hint_sem, "phint", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&claim_done, "pclaim", 0, RT_IPC_FLAG_FIFO);
+
+    rt_thread_t tid = rt_thread_create("ferase", _pool_thread, RT_NULL,
+                                       POOL_THREAD_STACK, POOL_THREAD_PRIO,
+                                       POOL_THREAD_TICK);
+    if (tid == RT_NULL) {
+        OS_PRTF(ERRO_LOG, "create ferase fail!\n");
+        return -RT_ENOMEM;
+    }
+    rt_thread_startup(tid);
+
+    OS_PRTF(NEWS_LOG, "init done!\n");
+
+    return RT_EOK;
+}
+
+void w25q64_pool_hint(const uint32_t adr, const uint32_t size) {
+    uint32_t sec = (adr + W25Q64_SECTOR_SIZE - 1) / W25Q64_SECTOR_SIZE;
+    uint32_t end = (adr + size) / W25Q64_SECTOR_SIZE;
+    if (end > W25Q64_POOL_SECTORS) {
+        end = W25Q64_POOL_SECTORS;
+    }
+
+    rt_mutex_take(&pool_lock, RT_WAITING_FOREVER);
+    for (; sec < end; ++sec) {
+        if (!_map_get(erased_map, sec) && !_pool_erasing(sec)) {
+            _map_set(dirty_map, sec);
+        }
+    }
+    _pool_wake();
+    rt_mutex_release(&pool_lock);
+}
+
+rt_err_t w25q64_pool_erase(const uint32_t adr) {
+    const uint32_t sec = adr / W25Q64_SECTOR_SIZE;
+    if (sec >= W25Q64_POOL_SECTORS) {
+        return w25q64_erase(Erase4KB, adr);
+    }
+
+    rt_mutex_take(&pool_lock, RT_WAITING_FOREVER);
+    _map_clr(dirty_map, sec);
+
+    /* 已预擦除：直接取走，并让后台线程补充 */
+    if (_map_get(erased_map, sec)) {
+        _map_clr(erased_map, sec);
+        --ready;
+        _pool_wake();
+        rt_mutex_release(&pool_lock);
+        return RT_EOK;
+    }
+
+    /* 正在后台擦除：等待擦除结束后直接使用 */
+    if (_pool_erasing(sec)) {
+        claim_mask |= 1UL << (sec - erasing_first);
+        ++claim_waiters;
+        rt_mutex_release(&pool_lock);
+        rt_sem_take(&claim_done, RT_WAITING_FOREVER);
+        return RT_EOK;
+    }
+    rt_mutex_release(&pool_lock);
+
+    return w25q64_erase(Erase4KB, sec * W25Q64_SECTOR_SIZE);
+}
+
+uint32_t w25q64_pool_ready(void) {
+    return ready;
+}
@@ -0,0 +1,82 @@
+#ifndef W25Q64_POOL_H
+#define W25Q64_POOL_H
+
+/**
+ * @brief 这是w25q64的后台预擦除模块。
+ * @details 先初始化w25q64模块，再初始化本模块；写入者通过w25q64_pool_hint告知不再需要的区域，
+ * 低优先级的后台线程把这些区域提前擦除成4KB扇区池；写入者在编程前调用w25q64_pool_erase，
+ * 若扇区已经预擦除则立即返回，否则同步擦除。
+ * @file w25q64_pool.h
+ * @author proyrb
+ * @date 2025/8/12
+ * @note 交给本模块的扇区在调用w25q64_pool_erase取回之前，不允许直接编程。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <w25q64.h>
+
+/********** 配置模块行为 **********/
+
+// 扇区大小
+#define W25Q64_SECTOR_SIZE 4096
+
+// 参与预擦除管理的扇区数：超出范围的扇区始终同步擦除
+#define W25Q64_POOL_SECTORS 2048
+
+#ifdef W25Q64_POOL_C
+
+// 最多保持多少个预擦除好的扇区
+#    define POOL_DEPTH 16
+
+// 后台擦除线程参数
+#    define POOL_THREAD_PRIO  (RT_THREAD_PRIORITY_MAX - 2)
+#    define POOL_THREAD_STACK (8 * 64)
+#    define POOL_THREAD_TICK  10
+
+// 一个64KB块内的扇区数：整块都待擦除时用一次64KB擦除代替16次4KB擦除
+#    define BLOCK_SECTORS 16
+
+#endif  // W25Q64_POOL_C
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 初始化预擦除模块并启动后台擦除线程。
+ * @param
+ * @retval RT_EOK：初始化成功。
+ * @retval -RT_ENOMEM：线程创建失败。
+ * @warning 必须在w25q64_init之后调用。
+ * @note
+ */
+extern int w25q64_pool_init(void);
+
+/**
+ * @brief 告知一段区域的内容已不再需要，可以在后台擦除。
+ * @param adr 起始地址：向上对齐到扇区，只管理完整覆盖的扇区。
+ * @param size 区域字节数。
+ * @retval
+ * @warning 线程安全；异步的。
+ * @note
+ */
+extern void w25q64_pool_hint(const uint32_t adr, const uint32_t size);
+
+/**
+ * @brief 取回一个扇区并保证它处于擦除状态。
+ * @param adr 扇区内任意地址。
+ * @retval RT_EOK：扇区已擦除，可以编程。
+ * @warning 线程安全；同步的。
+ * @note 扇区已预擦除时立即返回，否则同步执行4KB擦除。
+ */
+extern rt_err_t w25q64_pool_erase(const uint32_t adr);
+
+/**
+ * @brief 查询当前预擦除好的扇区数。
+ * @param
+ * @retval 扇区数。
+ * @warning
+ * @note
+ */
+extern uint32_t w25q64_pool_ready(void);
+
+#endif  // W25Q64_POOL_H
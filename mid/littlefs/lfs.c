@@ -1963,6 +1963,11 @@ static int lfs_dir_compact(lfs_t *                  lfs,
     }
 #    endif
 
+    LFS_COMPACT(dir->pair, (source != dir) ? LFS_COMPACT_SPLIT :
+                           tired           ? LFS_COMPACT_RELOCATE :
+                           dir->erased     ? LFS_COMPACT_FULL :
+                                             LFS_COMPACT_REWRITE);
+
     if (tired && lfs_pair_cmp(dir->pair, (const lfs_block_t[2]){0, 1}) != 0) {
         // we're writing too much, time to relocate
         goto relocate;
@@ -34,11 +34,32 @@
 // And build littlefs with the header by defining LFS_DEFINES.
 // (-DLFS_DEFINES=my_defines.h)
 
-#    include "log.h"
-#    include "FreeRTOS.h"
-#    define LFS_MALLOC(size) pvPortMalloc(size)
-#    define LFS_FREE(ptr) vPortFree(ptr)
-#    define LFS_NO_ASSERT
+// lfs_port: the filesystem is shared between RT-Thread threads, and the
+// host build (LFS_PORT_HOST) runs the same port against tool/flash_sim.c.
+// All caches are static buffers owned by lfs_port, so littlefs never
+// touches the heap; lfs_file_open fails with LFS_ERR_NOMEM, use
+// lfs_port_file_open instead.
+#    define LFS_THREADSAFE
+#    define LFS_NO_MALLOC
+#    ifndef LFS_PORT_HOST
+#        include <rtthread.h>
+#        include <stddef.h>
+#        include <stdint.h>
+#        define LFS_NO_ASSERT
+#        define LFS_NO_DEBUG
+#        define LFS_CRC(crc, buffer, size) lfs_port_crc(crc, buffer, size)
+uint32_t lfs_port_crc(uint32_t crc, const void * buffer, size_t size);
+#    endif
+// lfs_prof: every public API calls LFS_TRACE after taking the lock and
+// before releasing it, so the format string tells which API the block
+// device traffic belongs to. Only the format string is passed on, the
+// other arguments are never evaluated.
+#    include <lfs_prof.h>
+#    if LFS_PROF
+#        define LFS_PROF_API_(fmt, ...)     lfs_prof_api(fmt)
+#        define LFS_TRACE(...)              LFS_PROF_API_(__VA_ARGS__, "")
+#        define LFS_COMPACT(pair, reason)   lfs_prof_compact(pair, reason)
+#    endif
 
 #    ifdef LFS_DEFINES
 #        include LFS_STRINGIZE(LFS_DEFINES)
@@ -81,6 +102,16 @@ extern "C" {
 #        endif
 #    endif
 
+// Metadata compaction hook, called once when lfs_dir_compact starts
+// rewriting a metadata pair. reason is one of LFS_COMPACT_*.
+#    define LFS_COMPACT_SPLIT    0  // new tail of a pair that was split
+#    define LFS_COMPACT_RELOCATE 1  // block_cycles reached, moving the pair
+#    define LFS_COMPACT_FULL     2  // appending the commit ran out of space
+#    define LFS_COMPACT_REWRITE  3  // the pair cannot be appended to
+#    ifndef LFS_COMPACT
+#        define LFS_COMPACT(pair, reason)
+#    endif
+
 #    ifndef LFS_DEBUG
 #        ifndef LFS_NO_DEBUG
 #            define LFS_DEBUG_(fmt, ...)                                                 \
@@ -248,6 +279,11 @@ static inline uint32_t lfs_tobe32(uint32_t a) {
 }
 
 // Calculate CRC-32 with polynomial = 0x04c11db7
+//
+// lfs_crc_sw is the portable implementation, always available so that an
+// LFS_CRC backend can fall back to it.
+uint32_t lfs_crc_sw(uint32_t crc, const void * buffer, size_t size);
+
 #    ifdef LFS_CRC
 static inline uint32_t lfs_crc(uint32_t crc, const void * buffer, size_t size) {
     return LFS_CRC(crc, buffer, size);
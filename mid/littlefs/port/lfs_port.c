@@ -0,0 +1,723 @@
+#define LFS_PORT_C
+
+#include <lfs_port.h>
+#include <stddef.h>
+
+#ifndef LFS_PORT_HOST
+#    include <w25q64_pool.h>
+#    include <rthw.h>
+#    include <log.h>
+#elif defined(LFS_PORT_QUIET)
+#    define OS_PRTF(lev, fmt, ...)
+#else
+#    include <stdio.h>
+#    define OS_PRTF(lev, fmt, ...) printf(fmt, ##__VA_ARGS__)
+#endif  // LFS_PORT_HOST
+
+static struct lfs_config cfg;
+static lfs_t             lfs;
+static uint8_t           mounted = 0;
+
+/* 静态缓存：按字对齐，便于DMA与硬件CRC按字访问 */
+static uint32_t read_buf[LFS_PORT_CACHE_SIZE / 4];
+static uint32_t prog_buf[LFS_PORT_CACHE_SIZE / 4];
+static uint32_t lookahead_buf[LFS_PORT_LOOKAHEAD_SIZE / 4];
+
+/* 文件缓存池 */
+static uint32_t               file_buf[LFS_PORT_FILE_CNT][LFS_PORT_CACHE_SIZE / 4];
+static struct lfs_file_config file_cfg[LFS_PORT_FILE_CNT];
+static uint32_t               file_used = 0;  // 每位对应一个缓存
+
+/* 顺序预读 */
+static uint32_t pf_buf[LFS_PORT_PREFETCH_SIZE / 4];
+static uint32_t pf_adr  = 0;           // 预读区域的起始地址
+static uint32_t pf_len  = 0;           // 预读区域的长度，0表示无效
+static uint32_t seq_end = UINT32_MAX;  // 上一次读取的结束地址
+
+/* 分配器快照 */
+typedef struct {
+    uint32_t    magic;                         // SNAP_MAGIC
+    uint32_t    gen;                           // 代数：每写一次加1
+    uint32_t    block_count;                   // 文件系统块数
+    lfs_block_t start;                         // 预读窗口起点
+    lfs_block_t size;                          // 预读窗口大小
+    lfs_block_t next;                          // 窗口内下一个待检查的块
+    uint8_t     map[LFS_PORT_LOOKAHEAD_SIZE];  // 窗口位图：1表示已使用
+    uint32_t    crc;                           // 以上字段的CRC
+    uint32_t    consumed;                      // 0xFFFFFFFF：有效；0：已失效
+} snap_rec;
+
+#define SNAP_MAGIC 0x50414E53  // "SNAP"
+#define SNAP_SLOT  64          // 每条记录占用的字节数，不跨页
+#define SNAP_CNT   (LFS_PORT_BLOCK_SIZE / SNAP_SLOT)
+
+static uint32_t snap_adr  = 0;  // 快照扇区地址
+static uint32_t snap_gen  = 0;  // 最新记录的代数
+static uint32_t snap_slot = 0;  // 下一条记录的位置
+static uint8_t  snap_live = 0;  // 最新记录仍然有效，下一次写入前要使其失效
+
+#ifndef LFS_PORT_HOST
+static struct rt_mutex  lfs_lock;      // 保护文件系统内部状态
+static volatile uint8_t crc_busy = 1;  // CRC单元被占用，初始化前视为占用
+#else
+flash_sim lfs_port_sim;
+uint8_t   lfs_port_no_format = 0;
+uint8_t   lfs_port_sim_pool  = 0;
+
+/* 模拟w25q64_pool：参数与板上相同，每位对应一个块 */
+#    define SIM_POOL_SECTORS 2048
+#    define SIM_POOL_DEPTH   16
+static uint8_t  sim_dirty[SIM_POOL_SECTORS / 8];   // 待擦除的块
+static uint8_t  sim_erased[SIM_POOL_SECTORS / 8];  // 已预擦除的块
+static uint32_t sim_ready  = 0;                    // 已预擦除的块数
+static uint32_t sim_cursor = 0;                    // 下一次查找待擦除块的起点
+#endif  // LFS_PORT_HOST
+
+/********** 块设备操作 **********/
+
+static __inline uint32_t _port_adr(const lfs_block_t block, const lfs_off_t off) {
+    return LFS_PORT_BASE + block * LFS_PORT_BLOCK_SIZE + off;
+}
+
+/**
+ * @brief 同步读取。
+ * @param adr 地址。
+ * @param buf 缓冲区。
+ * @param size 字节数。
+ * @retval 1：成功。
+ * @retval 0：失败。
+ * @warning
+ * @note 会先结束正在进行的预读。
+ */
+static int _bd_read(const uint32_t adr, void * const buf, const uint32_t size) {
+#ifndef LFS_PORT_HOST
+    return w25q64_read(adr, buf, size) == RT_EOK;
+#else
+    return flash_sim_read(&lfs_port_sim, 1, adr, buf, size) == 0;
+#endif  // LFS_PORT_HOST
+}
+
+/**
+ * @brief 启动预读。
+ * @param adr 地址。
+ * @param buf 缓冲区。
+ * @param size 字节数。
+ * @retval 1：已启动。
+ * @retval 0：这段地址正在擦除/编程，放弃本次预读。
+ * @warning
+ * @note 主机版本没有DMA，直接同步读取。
+ */
+static int _bd_read_start(const uint32_t adr, void * const buf, const uint32_t size) {
+#ifndef LFS_PORT_HOST
+    return w25q64_read_start(adr, buf, size) == RT_EOK;
+#else
+    return flash_sim_read(&lfs_port_sim, 1, adr, buf, size) == 0;
+#endif  // LFS_PORT_HOST
+}
+
+static void _bd_read_wait(void) {
+#ifndef LFS_PORT_HOST
+    w25q64_read_wait();
+#endif  // LFS_PORT_HOST
+}
+
+static int _bd_prog(const uint32_t adr, const void * const buf, const uint32_t size) {
+#ifndef LFS_PORT_HOST
+    return w25q64_program(adr, buf, size) == RT_EOK;
+#else
+    /* 模拟芯片不允许跨页，按页拆分 */
+    const uint32_t page = lfs_port_sim.page_size;
+    for (uint32_t done = 0; done < size;) {
+        uint32_t n = page - (adr + done) % page;
+        n          = (n < size - done) ? n : size - done;
+        const uint8_t * src = (const uint8_t *)buf + done;
+        if (flash_sim_program(&lfs_port_sim, adr + done, src, n) != 0) {
+            return 0;
+        }
+        done += n;
+    }
+    return 1;
+#endif  // LFS_PORT_HOST
+}
+
+static int _bd_erase(const uint32_t adr) {
+#ifndef LFS_PORT_HOST
+    return w25q64_pool_erase(adr) == RT_EOK;
+#else
+    const uint32_t sec = adr / LFS_PORT_BLOCK_SIZE;
+    if (sec < SIM_POOL_SECTORS) {
+        const uint8_t bit = (uint8_t)(1 << (sec & 0x7));
+        sim_dirty[sec >> 3] &= (uint8_t)~bit;
+        if (sim_erased[sec >> 3] & bit) {
+            sim_erased[sec >> 3] &= (uint8_t)~bit;
+            --sim_ready;
+            return 1;
+        }
+    }
+    return flash_sim_erase(&lfs_port_sim, LFS_PORT_BLOCK_SIZE, adr) == 0;
+#endif  // LFS_PORT_HOST
+}
+
+/**
+ * @brief 把一个不再使用的块交给后台预擦除。
+ * @param adr 块的起始地址。
+ * @retval
+ * @warning
+ * @note 主机版本只在lfs_port_sim_pool非0时记下这个块，由lfs_port_sim_idle擦除。
+ */
+static void _bd_hint(const uint32_t adr) {
+#ifndef LFS_PORT_HOST
+    w25q64_pool_hint(adr, LFS_PORT_BLOCK_SIZE);
+#else
+    const uint32_t sec = adr / LFS_PORT_BLOCK_SIZE;
+    const uint8_t  bit = (uint8_t)(1 << (sec & 0x7));
+    if (lfs_port_sim_pool && (sec < SIM_POOL_SECTORS) && !(sim_erased[sec >> 3] & bit)) {
+        sim_dirty[sec >> 3] |= bit;
+    }
+#endif  // LFS_PORT_HOST
+}
+
+static void _snap_consume(void);
+
+/**
+ * @brief 丢弃预读数据。
+ * @param
+ * @retval
+ * @warning 编程或擦除之前调用，避免读到旧数据。
+ * @note 正在进行的预读会在驱动开始下一次总线事务前自动结束。
+ */
+static void _port_pf_drop(void) {
+    pf_len  = 0;
+    seq_end = UINT32_MAX;
+}
+
+/**
+ * @brief 读取一段数据。
+ * @param c 配置。
+ * @param block 块号。
+ * @param off 块内偏移。
+ * @param buffer 接收缓冲区。
+ * @param size 字节数。
+ * @retval LFS_ERR_OK：读取成功。
+ * @warning
+ * @note 与上一次读取首尾相接时视为顺序读取（CTZ文件的数据与元数据日志都是块内顺序读取），
+ * 返回前启动同一块内紧随其后的DMA预读，调用者处理本段数据的同时总线继续传输；
+ * 下一次读取落在预读区域内时只需等待剩余的传输并拷贝。
+ * CTZ链表的下一块要由lfs_ctz_find从表头查找，无法提前得知，因此预读不跨块。
+ */
+static int _port_read(const struct lfs_config * c,
+                      lfs_block_t               block,
+                      lfs_off_t                 off,
+                      void *                    buffer,
+                      lfs_size_t                size) {
+    const uint32_t start = lfs_prof_now();
+    const uint32_t adr   = _port_adr(block, off);
+    int            ret   = 1;
+
+    if ((pf_len > 0) && (adr >= pf_adr) && (adr + size <= pf_adr + pf_len)) {
+        _bd_read_wait();
+        memcpy(buffer, (const uint8_t *)pf_buf + (adr - pf_adr), size);
+    } else {
+        ret = _bd_read(adr, buffer, size);
+    }
+
+    const uint32_t next    = adr + size;
+    const uint32_t left    = c->block_size - (off + size);
+    const uint8_t  covered = (pf_len > 0) && (next >= pf_adr) && (next < pf_adr + pf_len);
+    if (ret && (adr == seq_end) && (left > 0) && !covered) {
+        const uint32_t n = (left < sizeof(pf_buf)) ? left : sizeof(pf_buf);
+        pf_len           = 0;
+        if (_bd_read_start(next, pf_buf, n)) {
+            pf_adr = next;
+            pf_len = n;
+        }
+    }
+    seq_end = next;
+
+    lfs_prof_bd(LFS_PROF_READ, block, off, size, start);
+    return ret ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+/**
+ * @brief 编程一段数据。
+ * @param c 配置。
+ * @param block 块号。
+ * @param off 块内偏移：littlefs保证按prog_size对齐。
+ * @param buffer 数据。
+ * @param size 字节数：littlefs保证是prog_size的整数倍。
+ * @retval LFS_ERR_OK：编程成功。
+ * @warning
+ * @note prog_size等于页大小，因此每次编程都从页首开始，不会被拆成两次。
+ */
+static int _port_prog(const struct lfs_config * c,
+                      lfs_block_t               block,
+                      lfs_off_t                 off,
+                      const void *              buffer,
+                      lfs_size_t                size) {
+    (void)c;
+    const uint32_t start = lfs_prof_now();
+    _port_pf_drop();
+    _snap_consume();
+    const int ret = _bd_prog(_port_adr(block, off), buffer, size);
+    lfs_prof_bd(LFS_PROF_PROG, block, off, size, start);
+    return ret ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+/**
+ * @brief 把littlefs接下来要分配的空闲块交给w25q64_pool预擦除。
+ * @param
+ * @retval
+ * @warning 必须持有文件系统锁。
+ * @note 预读窗口中next之后为0的位都是扫描时的空闲块，之后只有lfs_alloc会从next起依次取用，
+ * 取用的块先经过_port_erase（w25q64_pool_erase）再编程，因此提前擦除不会破坏数据；
+ * 窗口大小受ckpoint限制，不会绕回本次操作中已分配、尚未提交的块。
+ * 格式化时不提示：挂载后窗口从种子决定的位置重新开始，这些块会长期占着池。
+ */
+static void _port_hint(void) {
+    if (!mounted) {
+        return;
+    }
+
+    uint32_t cnt = 0;
+    for (lfs_block_t i = lfs.lookahead.next;
+         (i < lfs.lookahead.size) && (cnt < LFS_PORT_HINT_CNT); ++i) {
+        if (!(lfs.lookahead.buffer[i / 8] & (1U << (i % 8)))) {
+            _bd_hint(_port_adr((lfs.lookahead.start + i) % lfs.block_count, 0));
+            ++cnt;
+        }
+    }
+}
+
+/**
+ * @brief 擦除一个块。
+ * @param c 配置。
+ * @param block 块号。
+ * @retval LFS_ERR_OK：擦除成功。
+ * @retval LFS_ERR_IO：擦除失败。
+ * @warning
+ * @note littlefs总是在分配新块后立即擦除，这时预读窗口已经指向下一个空闲块，
+ * 顺便把其后的空闲块交给后台，下一次分配到它们时擦除立即返回。
+ */
+static int _port_erase(const struct lfs_config * c, lfs_block_t block) {
+    (void)c;
+    const uint32_t start = lfs_prof_now();
+    _port_pf_drop();
+    _snap_consume();
+    const int ret = _bd_erase(_port_adr(block, 0));
+    lfs_prof_bd(LFS_PROF_ERASE, block, 0, LFS_PORT_BLOCK_SIZE, start);
+    _port_hint();
+    return ret ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int _port_sync(const struct lfs_config * c) {
+    (void)c;
+    /* 驱动的读写擦除都是同步完成的，没有需要刷新的缓存 */
+    return LFS_ERR_OK;
+}
+
+/********** 线程安全 **********/
+
+static int _port_lock(const struct lfs_config * c) {
+    (void)c;
+#ifndef LFS_PORT_HOST
+    rt_mutex_take(&lfs_lock, RT_WAITING_FOREVER);
+#endif  // LFS_PORT_HOST
+    return LFS_ERR_OK;
+}
+
+static int _port_unlock(const struct lfs_config * c) {
+    (void)c;
+#ifndef LFS_PORT_HOST
+    rt_mutex_release(&lfs_lock);
+#endif  // LFS_PORT_HOST
+    return LFS_ERR_OK;
+}
+
+/********** 硬件CRC **********/
+
+#ifndef LFS_PORT_HOST
+
+/**
+ * @brief 32位位反转。
+ * @param x 输入。
+ * @retval 反转结果。
+ * @warning
+ * @note Cortex-M0+没有RBIT指令。
+ */
+static __inline uint32_t _crc_rbit(uint32_t x) {
+    x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+    x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F) | ((x & 0x0F0F0F0F) << 4);
+    x = ((x >> 8) & 0x00FF00FF) | ((x & 0x00FF00FF) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+/**
+ * @brief 用硬件CRC单元计算littlefs的CRC-32。
+ * @param crc 当前CRC值。
+ * @param buffer 数据。
+ * @param size 字节数。
+ * @retval 更新后的CRC值。
+ * @warning 其它使用CRC单元的代码也必须先占用crc_busy。
+ * @note littlefs使用反射的CRC-32（输入输出按LSB优先，不做最终异或），
+ * 硬件按MSB优先移位，因此把初值、输入和结果都做位反转：
+ * 按小端读出的一个字整体反转后，恰好是4个字节各自反转再按先后顺序排列的结果。
+ * CRC单元被占用（被抢占的线程正在使用）或数据太短时使用软件实现。
+ */
+uint32_t lfs_port_crc(uint32_t crc, const void * buffer, size_t size) {
+    if (size < LFS_PORT_CRC_MIN) {
+        return lfs_crc_sw(crc, buffer, size);
+    }
+
+    rt_base_t level = rt_hw_interrupt_disable();
+    if (crc_busy) {
+        rt_hw_interrupt_enable(level);
+        return lfs_crc_sw(crc, buffer, size);
+    }
+    crc_busy = 1;
+    rt_hw_interrupt_enable(level);
+
+    const uint8_t * data = buffer;
+    CRC_SetInitRegister(_crc_rbit(crc));
+    CRC_ResetDR();
+
+    /* 非对齐的头部逐字节写入 */
+    while ((size > 0) && ((uint32_t)data & 0x3)) {
+        *(volatile uint8_t *)&CRC->CRC_DR = (uint8_t)(_crc_rbit(*data++) >> 24);
+        --size;
+    }
+    for (; size >= 4; size -= 4, data += 4) {
+        CRC->CRC_DR = _crc_rbit(*(const uint32_t *)data);
+    }
+    while (size > 0) {
+        *(volatile uint8_t *)&CRC->CRC_DR = (uint8_t)(_crc_rbit(*data++) >> 24);
+        --size;
+    }
+
+    crc      = _crc_rbit(CRC->CRC_DR);
+    crc_busy = 0;
+    return crc;
+}
+
+#endif  // LFS_PORT_HOST
+
+/********** 分配器快照 **********/
+
+static uint32_t _snap_crc(const snap_rec * const rec) {
+    return lfs_crc(0xFFFFFFFF, rec, offsetof(snap_rec, crc));
+}
+
+/**
+ * @brief 使最新的快照失效。
+ * @param
+ * @retval
+ * @warning 必须持有文件系统锁。
+ * @note 把consumed字段从全1编程为0，不需要擦除。
+ */
+static void _snap_consume(void) {
+    if (!snap_live) {
+        return;
+    }
+    snap_live            = 0;
+    const uint32_t zero  = 0;
+    const uint32_t slot  = (snap_slot + SNAP_CNT - 1) % SNAP_CNT;
+    const uint32_t field = snap_adr + slot * SNAP_SLOT + offsetof(snap_rec, consumed);
+    _bd_prog(field, &zero, sizeof(zero));
+}
+
+/**
+ * @brief 挂载后查找最新的快照，有效时恢复分配器的预读窗口。
+ * @param
+ * @retval 1：已恢复。
+ * @retval 0：没有可用的快照，第一次分配时littlefs会完整遍历文件系统。
+ * @warning 必须在lfs_mount之后、任何写入之前调用。
+ * @note 记录按代数顺序追加，遇到空槽即停止。
+ */
+static int _snap_restore(void) {
+    snap_rec rec;
+    snap_rec last  = {0};
+    uint8_t  found = 0;
+
+    snap_slot = 0;
+    for (uint32_t slot = 0; slot < SNAP_CNT; ++slot) {
+        if (!_bd_read(snap_adr + slot * SNAP_SLOT, &rec, sizeof(rec)) ||
+            (rec.magic != SNAP_MAGIC)) {
+            break;
+        }
+        if ((rec.crc == _snap_crc(&rec)) && (!found || (rec.gen > last.gen))) {
+            last  = rec;
+            found = 1;
+        }
+        snap_slot = slot + 1;
+    }
+    if (!found) {
+        return 0;
+    }
+
+    snap_gen = last.gen;
+    if ((last.consumed != 0xFFFFFFFF) || (last.block_count != cfg.block_count) ||
+        (last.size > 8 * LFS_PORT_LOOKAHEAD_SIZE) || (last.next > last.size) ||
+        (last.start >= cfg.block_count)) {
+        return 0;
+    }
+
+    lfs.lookahead.start = last.start;
+    lfs.lookahead.size  = last.size;
+    lfs.lookahead.next  = last.next;
+    memcpy(lfs.lookahead.buffer, last.map, LFS_PORT_LOOKAHEAD_SIZE);
+    snap_live = 1;
+    return 1;
+}
+
+int lfs_port_snapshot(void) {
+    if (!mounted) {
+        return LFS_ERR_INVAL;
+    }
+
+    _port_lock(&cfg);
+    _snap_consume();
+
+    snap_rec rec;
+    memset(&rec, 0xFF, sizeof(rec));
+    rec.magic       = SNAP_MAGIC;
+    rec.gen         = snap_gen + 1;
+    rec.block_count = cfg.block_count;
+    rec.start       = lfs.lookahead.start;
+    rec.size        = lfs.lookahead.size;
+    rec.next        = lfs.lookahead.next;
+    memcpy(rec.map, lfs.lookahead.buffer, LFS_PORT_LOOKAHEAD_SIZE);
+    rec.crc = _snap_crc(&rec);
+
+    /* 扇区写满后擦除重来 */
+    int ret = 1;
+    if (snap_slot >= SNAP_CNT) {
+        ret       = _bd_erase(snap_adr);
+        snap_slot = 0;
+    }
+    if (ret) {
+        ret = _bd_prog(snap_adr + snap_slot * SNAP_SLOT, &rec, sizeof(rec));
+    }
+    if (ret) {
+        ++snap_slot;
+        snap_gen  = rec.gen;
+        snap_live = 1;
+    }
+
+    _port_unlock(&cfg);
+    return ret ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+/********** 导出的函数 **********/
+
+int lfs_port_init(void) {
+#ifndef LFS_PORT_HOST
+    rt_mutex_init(&lfs_lock, "lfs", RT_IPC_FLAG_PRIO);
+    crc_busy = 0;  // board.c已经配置好CRC单元
+    const uint32_t capacity  = w25q64_geometry()->capacity;
+    const uint32_t page_size = w25q64_geometry()->page_size;
+#else
+    const uint32_t capacity  = lfs_port_sim.capacity;
+    const uint32_t page_size = lfs_port_sim.page_size;
+#endif  // LFS_PORT_HOST
+
+    /* 区域的最后一块存放分配器快照，不交给littlefs */
+    uint32_t size = LFS_PORT_SIZE;
+    if ((size == 0) && (capacity > LFS_PORT_BASE + LFS_PORT_TAIL)) {
+        size = capacity - LFS_PORT_BASE - LFS_PORT_TAIL;
+    }
+    if ((size < 3 * LFS_PORT_BLOCK_SIZE) || (LFS_PORT_BASE + size > capacity) ||
+        (LFS_PORT_CACHE_SIZE % page_size != 0) || (SNAP_SLOT % sizeof(uint32_t) != 0) ||
+        (sizeof(snap_rec) > SNAP_SLOT) || (page_size % SNAP_SLOT != 0)) {
+        OS_PRTF(ERRO_LOG, "bad layout: base 0x%X size 0x%X!\n", LFS_PORT_BASE, size);
+        return LFS_ERR_INVAL;
+    }
+    size     = size / LFS_PORT_BLOCK_SIZE * LFS_PORT_BLOCK_SIZE - LFS_PORT_BLOCK_SIZE;
+    snap_adr = LFS_PORT_BASE + size;
+
+    cfg.read             = _port_read;
+    cfg.prog             = _port_prog;
+    cfg.erase            = _port_erase;
+    cfg.sync             = _port_sync;
+    cfg.lock             = _port_lock;
+    cfg.unlock           = _port_unlock;
+    cfg.read_size        = LFS_PORT_READ_SIZE;
+    cfg.prog_size        = page_size;
+    cfg.block_size       = LFS_PORT_BLOCK_SIZE;
+    cfg.block_count      = size / LFS_PORT_BLOCK_SIZE;
+    cfg.block_cycles     = LFS_PORT_BLOCK_CYCLES;
+    cfg.cache_size       = LFS_PORT_CACHE_SIZE;
+    cfg.lookahead_size   = LFS_PORT_LOOKAHEAD_SIZE;
+    cfg.read_buffer      = read_buf;
+    cfg.prog_buffer      = prog_buf;
+    cfg.lookahead_buffer = lookahead_buf;
+
+    /* 重新挂载后原有的文件句柄全部作废 */
+    file_used = 0;
+    snap_live = 0;
+    _port_pf_drop();
+#ifdef LFS_PORT_HOST
+    /* 主机上重新挂载视为复位，预擦除的记录随之丢失 */
+    memset(sim_dirty, 0, sizeof(sim_dirty));
+    memset(sim_erased, 0, sizeof(sim_erased));
+    sim_ready  = 0;
+    sim_cursor = 0;
+#endif  // LFS_PORT_HOST
+
+    int err = lfs_mount(&lfs, &cfg);
+#ifdef LFS_PORT_HOST
+    if ((err != LFS_ERR_OK) && lfs_port_no_format) {
+        OS_PRTF(ERRO_LOG, "mount fail (%d)!\n", err);
+        return err;
+    }
+#endif  // LFS_PORT_HOST
+    /* 只有内容不是可用的文件系统时才格式化：读取失败等错误原样返回，不能抹掉数据 */
+    if ((err == LFS_ERR_CORRUPT) || (err == LFS_ERR_INVAL)) {
+        OS_PRTF(WARN_LOG, "mount fail (%d), format!\n", err);
+        err = lfs_format(&lfs, &cfg);
+        if (err == LFS_ERR_OK) {
+            err = lfs_mount(&lfs, &cfg);
+        }
+    }
+    if (err != LFS_ERR_OK) {
+        OS_PRTF(ERRO_LOG, "mount fail (%d)!\n", err);
+        return err;
+    }
+    mounted = 1;
+
+    if (_snap_restore()) {
+        OS_PRTF(INFO_LOG, "lookahead snapshot %u restored\n", snap_gen);
+        _port_hint();
+    }
+
+    OS_PRTF(NEWS_LOG, "init done! %u blocks\n", cfg.block_count);
+
+    return LFS_ERR_OK;
+}
+
+int lfs_port_deinit(void) {
+    if (!mounted) {
+        return LFS_ERR_OK;
+    }
+    lfs_port_snapshot();
+    mounted   = 0;
+    snap_live = 0;
+    return lfs_unmount(&lfs);
+}
+
+int lfs_port_file_open(lfs_file_t * const file, const char * const path,
+                       const int flags) {
+    _port_lock(&cfg);
+    uint32_t slot = 0;
+    while ((slot < LFS_PORT_FILE_CNT) && (file_used & (1UL << slot))) {
+        ++slot;
+    }
+    if (slot == LFS_PORT_FILE_CNT) {
+        _port_unlock(&cfg);
+        return LFS_ERR_NOMEM;
+    }
+    file_used |= 1UL << slot;
+    _port_unlock(&cfg);
+
+    memset(&file_cfg[slot], 0, sizeof(file_cfg[slot]));
+    file_cfg[slot].buffer = file_buf[slot];
+
+    const int err = lfs_file_opencfg(&lfs, file, path, flags, &file_cfg[slot]);
+    if (err != LFS_ERR_OK) {
+        _port_lock(&cfg);
+        file_used &= ~(1UL << slot);
+        _port_unlock(&cfg);
+    }
+    return err;
+}
+
+int lfs_port_file_close(lfs_file_t * const file) {
+    const uint32_t slot = (uint32_t)(file->cfg - file_cfg);
+    const int      err  = lfs_file_close(&lfs, file);
+
+    if (slot < LFS_PORT_FILE_CNT) {
+        _port_lock(&cfg);
+        file_used &= ~(1UL << slot);
+        _port_unlock(&cfg);
+    }
+    return err;
+}
+
+uint32_t lfs_port_file_free(void) {
+    uint32_t cnt = 0;
+    for (uint32_t slot = 0; slot < LFS_PORT_FILE_CNT; ++slot) {
+        cnt += !(file_used & (1UL << slot));
+    }
+    return cnt;
+}
+
+void lfs_port_region(uint32_t * const base, uint32_t * const size) {
+    *base = LFS_PORT_BASE;
+    *size = snap_adr + LFS_PORT_BLOCK_SIZE - LFS_PORT_BASE;
+}
+
+lfs_t * lfs_port_fs(void) {
+    return mounted ? &lfs : NULL;
+}
+
+const struct lfs_config * lfs_port_cfg(void) {
+    return &cfg;
+}
+
+#ifdef LFS_PORT_HOST
+void lfs_port_sim_idle(const uint32_t ms) {
+    const uint64_t end   = lfs_port_sim.now_ns + (uint64_t)ms * 1000000;
+    const uint64_t erase = (uint64_t)lfs_port_sim.timing.erase_ms[0] * 1000000;
+
+    /* 与后台擦除线程相同：从上次的位置开始，每次擦除一块，池满即停 */
+    for (uint32_t n = 0; (n < SIM_POOL_SECTORS) && (sim_ready < SIM_POOL_DEPTH) &&
+                         (lfs_port_sim.now_ns + erase <= end);
+         ++n) {
+        const uint32_t sec = sim_cursor;
+        const uint8_t  bit = (uint8_t)(1 << (sec & 0x7));
+        sim_cursor         = (sim_cursor + 1) % SIM_POOL_SECTORS;
+        if ((sim_dirty[sec >> 3] & bit) &&
+            (flash_sim_erase(&lfs_port_sim, LFS_PORT_BLOCK_SIZE,
+                             sec * LFS_PORT_BLOCK_SIZE) == 0)) {
+            sim_dirty[sec >> 3] &= (uint8_t)~bit;
+            sim_erased[sec >> 3] |= bit;
+            ++sim_ready;
+        }
+    }
+    if (lfs_port_sim.now_ns < end) {
+        lfs_port_sim.now_ns = end;
+    }
+}
+#endif  // LFS_PORT_HOST
+
+/********** 板上的MSH命令 **********/
+
+#ifndef LFS_PORT_HOST
+
+/**
+ * @brief lfssync：保存分配器快照。
+ * @param
+ * @retval
+ * @warning
+ * @note 快照在下一次编程或擦除之前有效，写完一批文件后调用，断电后也能用上。
+ */
+static void lfssync(void) {
+    const int err = lfs_port_snapshot();
+    rt_kprintf("lookahead snapshot %u %s (%d)\n", snap_gen,
+               (err == LFS_ERR_OK) ? "saved" : "failed", err);
+}
+MSH_CMD_EXPORT(lfssync, save littlefs lookahead snapshot);
+
+/**
+ * @brief reboot：保存分配器快照后复位。
+ * @param
+ * @retval
+ * @warning 不会等待打开的文件关闭，尚未同步的写入会丢失。
+ * @note 有序重启的入口：下一次挂载直接恢复快照，不必遍历整个文件系统。
+ */
+static void reboot(void) {
+    lfs_port_snapshot();
+    rt_hw_cpu_reset();
+}
+MSH_CMD_EXPORT(reboot, save littlefs snapshot and reset);
+
+#endif  // LFS_PORT_HOST
@@ -0,0 +1,193 @@
+#ifndef LFS_PORT_H
+#define LFS_PORT_H
+
+/**
+ * @brief 这是littlefs到w25q64的移植模块。
+ * @details 初始化时按探测到的芯片容量生成lfs_config并挂载，
+ * 区域内不是可用的文件系统时格式化后重新挂载；
+ * 之后通过lfs_port_fs取得文件系统句柄，用lfs_port_file_open/lfs_port_file_close打开关闭文件，
+ * 其余操作直接调用lfs_file_read、lfs_dir_open等接口。
+ * 所有缓存都是静态分配的，文件缓存来自固定数量的缓存池，文件系统不会使用堆内存。
+ * 读取走w25q64_read（DMA），顺序读取时在块内提前启动下一段DMA预读；
+ * 编程按页对齐，擦除经过w25q64_pool，已预擦除的块立即返回：每次擦除后，
+ * 分配器预读窗口中接下来要分配的LFS_PORT_HINT_CNT个空闲块交给w25q64_pool在后台擦除。
+ * 定义LFS_PORT_HOST时编译为主机版本，底层换成tool/flash_sim.c的模拟芯片，
+ * 再定义LFS_PORT_QUIET则不输出日志。
+ * @file lfs_port.h
+ * @author proyrb
+ * @date 2025/8/15
+ * @note littlefs已打开LFS_THREADSAFE，多个线程可以同时使用同一个句柄；
+ * 板上的lfs_crc使用硬件CRC单元，单元被占用时自动退回软件实现。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <lfs.h>
+
+#ifdef LFS_PORT_HOST
+#    include <flash_sim.h>
+#endif  // LFS_PORT_HOST
+
+/********** 配置模块行为 **********/
+
+// 块大小：与芯片最小擦除粒度一致
+#define LFS_PORT_BLOCK_SIZE 4096
+
+#ifdef LFS_PORT_C
+
+// 文件系统在芯片中的起始地址与大小，大小为0表示一直用到芯片末尾前LFS_PORT_TAIL处；
+// 区域的最后一块用来保存分配器快照
+#    define LFS_PORT_BASE 0
+#    define LFS_PORT_SIZE 0
+
+// 芯片末尾不归文件系统管理的字节数：留给flashbench的默认scratch区域
+#    define LFS_PORT_TAIL (64 * 1024)
+
+// 最小读取粒度
+#    define LFS_PORT_READ_SIZE 16
+
+// 缓存大小：等于页大小，使每次编程都是一整页
+#    define LFS_PORT_CACHE_SIZE 256
+
+// 顺序读取时的预读字节数：等于缓存大小，正好是littlefs下一次读取的长度
+#    define LFS_PORT_PREFETCH_SIZE LFS_PORT_CACHE_SIZE
+
+// 预读分配位图的字节数，每字节对应8个块
+#    define LFS_PORT_LOOKAHEAD_SIZE 16
+
+// 每次擦除后交给w25q64_pool预擦除的空闲块数：与池的深度相同，0表示不预擦除
+#    define LFS_PORT_HINT_CNT 16
+
+// 元数据块被擦写多少次后迁移
+#    define LFS_PORT_BLOCK_CYCLES 500
+
+// 同时打开的文件数：每个文件占用一个LFS_PORT_CACHE_SIZE字节的缓存
+#    define LFS_PORT_FILE_CNT 4
+
+// 少于该字节数的CRC直接用软件计算，硬件的位反转与寄存器开销不划算
+#    define LFS_PORT_CRC_MIN 16
+
+#endif  // LFS_PORT_C
+
+/********** 导出的变量 **********/
+
+#ifdef LFS_PORT_HOST
+// 主机版本使用的模拟芯片：调用lfs_port_init前由调用者创建
+extern flash_sim lfs_port_sim;
+
+// 非0时lfs_port_init挂载失败直接返回错误，不格式化：用于校验现成的镜像
+extern uint8_t lfs_port_no_format;
+
+// 非0时模拟w25q64_pool：预擦除只在lfs_port_sim_idle中进行
+extern uint8_t lfs_port_sim_pool;
+#endif  // LFS_PORT_HOST
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 生成配置并挂载文件系统。
+ * @param
+ * @retval 0：挂载成功。
+ * @retval <0：littlefs错误码。
+ * @warning 必须在w25q64_init与w25q64_pool_init之后调用。
+ * @note 挂载返回LFS_ERR_CORRUPT（空白或损坏的芯片）或LFS_ERR_INVAL（版本、几何参数不符）时
+ * 会格式化，原有内容全部丢失；LFS_ERR_IO等其它错误直接返回，不格式化。
+ */
+extern int lfs_port_init(void);
+
+/**
+ * @brief 卸载文件系统。
+ * @param
+ * @retval 0：卸载成功。
+ * @warning 所有文件必须已经关闭。
+ * @note
+ */
+extern int lfs_port_deinit(void);
+
+/**
+ * @brief 打开文件，文件缓存取自缓存池。
+ * @param file 文件句柄。
+ * @param path 路径。
+ * @param flags lfs_open_flags的组合。
+ * @retval 0：打开成功。
+ * @retval LFS_ERR_NOMEM：缓存池已用完。
+ * @retval <0：其它littlefs错误码。
+ * @warning 线程安全；必须用lfs_port_file_close关闭。
+ * @note 不要直接调用lfs_file_open：文件系统没有堆内存，它总是返回LFS_ERR_NOMEM。
+ */
+extern int lfs_port_file_open(lfs_file_t * const file, const char * const path,
+                              const int flags);
+
+/**
+ * @brief 关闭文件并归还缓存。
+ * @param file 文件句柄。
+ * @retval 0：关闭成功。
+ * @retval <0：littlefs错误码，缓存同样会归还。
+ * @warning 线程安全。
+ * @note
+ */
+extern int lfs_port_file_close(lfs_file_t * const file);
+
+/**
+ * @brief 查询缓存池中空闲的文件缓存数。
+ * @param
+ * @retval 空闲数。
+ * @warning
+ * @note
+ */
+extern uint32_t lfs_port_file_free(void);
+
+/**
+ * @brief 保存分配器快照。
+ * @param
+ * @retval 0：保存成功。
+ * @retval <0：littlefs错误码。
+ * @warning 线程安全。
+ * @note 快照记录littlefs当前的空闲块预读窗口，下一次挂载时直接恢复，
+ * 第一次分配不必遍历整个文件系统。快照之后的第一次编程或擦除会先使它失效，
+ * 因此可以在空闲时随时调用，看门狗复位后仍然可以使用；lfs_port_deinit会自动调用。
+ * 板上MSH命令lfssync单独保存快照，reboot保存快照后复位，有序重启应当走reboot。
+ */
+extern int lfs_port_snapshot(void);
+
+/**
+ * @brief 获取文件系统在芯片中占用的区域。
+ * @param base 接收起始地址。
+ * @param size 接收字节数：包括最后存放分配器快照的一块。
+ * @retval
+ * @warning 必须先调用lfs_port_init。
+ * @note 主机上生成的镜像就是这段区域的内容，烧录到base处即可。
+ */
+extern void lfs_port_region(uint32_t * const base, uint32_t * const size);
+
+/**
+ * @brief 获取文件系统句柄。
+ * @param
+ * @retval 句柄：未挂载时为NULL。
+ * @warning
+ * @note
+ */
+extern lfs_t * lfs_port_fs(void);
+
+/**
+ * @brief 获取当前使用的配置。
+ * @param
+ * @retval 配置，只读。
+ * @warning
+ * @note
+ */
+extern const struct lfs_config * lfs_port_cfg(void);
+
+#ifdef LFS_PORT_HOST
+/**
+ * @brief 主机版本：让模拟芯片空闲一段时间，期间由模拟的后台线程预擦除。
+ * @param ms 空闲的毫秒数，虚拟时钟前进这么多。
+ * @retval
+ * @warning 只在主机版本中存在。
+ * @note 每块按4KB擦除的典型时间计算，时间不够擦完一块时不擦；
+ * 板上的后台线程还可能合并成64KB擦除，这里偏保守。
+ */
+extern void lfs_port_sim_idle(const uint32_t ms);
+#endif  // LFS_PORT_HOST
+
+#endif  // LFS_PORT_H
@@ -0,0 +1,288 @@
+#define LFS_PROF_C
+
+#include <lfs_port.h>
+
+#ifndef LFS_PORT_HOST
+#    include <sc32_conf.h>
+#    include <rtthread.h>
+#endif  // LFS_PORT_HOST
+
+#if LFS_PROF
+
+static lfs_prof_api_stat api[LFS_PROF_API_CNT];
+static lfs_prof_rec      trace[LFS_PROF_TRACE_CNT];
+static lfs_prof_dir      dirs[LFS_PROF_DIR_CNT];
+static uint32_t          trace_cnt = 0;  // 写入过的记录总数，取模得到下一条的位置
+static uint8_t           cur       = 0;  // 正在执行的接口，不在接口内时为0
+static uint32_t          cur_start = 0;  // 当前接口的进入时间
+
+static const char * const reason_name[] = {"split", "relocate", "full", "rewrite"};
+static const char * const op_name[]     = {"read", "prog", "erase", "compact"};
+
+/********** 时间戳 **********/
+
+#    ifndef LFS_PORT_HOST
+
+/**
+ * @brief 由tick与SysTick计数值组合出微秒时间戳。
+ * @param
+ * @retval 微秒时间戳。
+ * @warning
+ * @note 读取期间发生tick更新时重新读取。
+ */
+uint32_t lfs_prof_now(void) {
+    const uint32_t us_per_tick = 1000000 / RT_TICK_PER_SECOND;
+    const uint32_t cnt_per_us  = (SysTick->LOAD + 1) / us_per_tick;
+
+    rt_tick_t tick;
+    uint32_t  val;
+    do {
+        tick = rt_tick_get();
+        val  = SysTick->VAL;
+    } while (tick != rt_tick_get());
+
+    return tick * us_per_tick + (SysTick->LOAD - val) / cnt_per_us;
+}
+
+#    else
+
+uint32_t lfs_prof_now(void) {
+    return (uint32_t)(lfs_port_sim.now_ns / 1000);
+}
+
+#    endif  // LFS_PORT_HOST
+
+/********** 钩子 **********/
+
+/**
+ * @brief 取得接口名的长度。
+ * @param fmt 跟踪格式串。
+ * @retval 长度。
+ * @warning
+ * @note 进入时接口名后面是'('，退出时是" -> "。
+ */
+static uint32_t _name_len(const char * const fmt) {
+    uint32_t len = 0;
+    while ((fmt[len] != '\0') && (fmt[len] != '(') && (fmt[len] != ' ')) {
+        ++len;
+    }
+    return len;
+}
+
+void lfs_prof_api(const char * fmt) {
+    if (fmt[_name_len(fmt)] != '(') {
+        /* 退出 */
+        const uint32_t us = lfs_prof_now() - cur_start;
+        api[cur].us += us;
+        api[cur].max_us = (us > api[cur].max_us) ? us : api[cur].max_us;
+        cur             = 0;
+        return;
+    }
+
+    /* 进入：按格式串地址查找，找不到时占用空项，表满时记在第0项 */
+    uint8_t i = 1;
+    while ((i < LFS_PROF_API_CNT) && (api[i].name != NULL) && (api[i].name != fmt)) {
+        ++i;
+    }
+    if (i == LFS_PROF_API_CNT) {
+        i = 0;
+    } else if (api[i].name == NULL) {
+        api[i].name = fmt;
+    }
+    ++api[i].calls;
+    cur       = i;
+    cur_start = lfs_prof_now();
+}
+
+/**
+ * @brief 追加一条跟踪记录。
+ * @param
+ * @retval 记录。
+ * @warning
+ * @note 缓冲区满后覆盖最旧的记录。
+ */
+static lfs_prof_rec * _trace_next(void) {
+    lfs_prof_rec * const rec = &trace[trace_cnt % LFS_PROF_TRACE_CNT];
+    ++trace_cnt;
+    rec->api = cur;
+    return rec;
+}
+
+void lfs_prof_bd(const uint8_t  op,
+                 const uint32_t block,
+                 const uint32_t off,
+                 const uint32_t size,
+                 const uint32_t start) {
+    const uint32_t us = lfs_prof_now() - start;
+
+    api[cur].bd_us += us;
+    if (op == LFS_PROF_READ) {
+        api[cur].rd_bytes += size;
+    } else if (op == LFS_PROF_PROG) {
+        api[cur].pg_bytes += size;
+    } else {
+        ++api[cur].erases;
+    }
+
+    lfs_prof_rec * const rec = _trace_next();
+    rec->stamp               = start;
+    rec->block               = block;
+    rec->us                  = us;
+    rec->off                 = (uint16_t)off;
+    rec->size                = (uint16_t)size;
+    rec->op                  = op;
+}
+
+static uint32_t _dir_sum(const lfs_prof_dir * const d) {
+    return d->cnt[0] + d->cnt[1] + d->cnt[2] + d->cnt[3];
+}
+
+void lfs_prof_compact(const uint32_t pair[2], const int reason) {
+    ++api[cur].compacts;
+
+    lfs_prof_rec * const rec = _trace_next();
+    rec->stamp               = lfs_prof_now();
+    rec->block               = pair[0];
+    rec->us                  = 0;
+    rec->off                 = (uint16_t)pair[1];
+    rec->size                = (uint16_t)reason;
+    rec->op                  = LFS_PROF_COMPACT;
+
+    /* 元数据对的两块会轮换，按从小到大排列后作为键 */
+    const uint32_t lo = (pair[0] < pair[1]) ? pair[0] : pair[1];
+    const uint32_t hi = (pair[0] < pair[1]) ? pair[1] : pair[0];
+
+    uint32_t hit  = LFS_PROF_DIR_CNT;
+    uint32_t less = 0;
+    for (uint32_t i = 0; i < LFS_PROF_DIR_CNT; ++i) {
+        const uint32_t sum = _dir_sum(&dirs[i]);
+        if ((sum > 0) && (dirs[i].pair[0] == lo) && (dirs[i].pair[1] == hi)) {
+            hit = i;
+            break;
+        }
+        less = (sum < _dir_sum(&dirs[less])) ? i : less;
+    }
+    if (hit == LFS_PROF_DIR_CNT) {
+        hit = less;
+        memset(&dirs[hit], 0, sizeof(dirs[hit]));
+        dirs[hit].pair[0] = lo;
+        dirs[hit].pair[1] = hi;
+    }
+    if ((reason >= 0) && (reason < 4) && (dirs[hit].cnt[reason] < UINT16_MAX)) {
+        ++dirs[hit].cnt[reason];
+    }
+}
+
+/********** 查看结果 **********/
+
+static void _lock(void) {
+    const struct lfs_config * const c = lfs_port_cfg();
+    if (c->lock != NULL) {
+        c->lock(c);
+    }
+}
+
+static void _unlock(void) {
+    const struct lfs_config * const c = lfs_port_cfg();
+    if (c->unlock != NULL) {
+        c->unlock(c);
+    }
+}
+
+void lfs_prof_reset(void) {
+    _lock();
+    memset(api, 0, sizeof(api));
+    memset(trace, 0, sizeof(trace));
+    memset(dirs, 0, sizeof(dirs));
+    trace_cnt = 0;
+    cur       = 0;
+    _unlock();
+}
+
+static void _print_name(int (*print)(const char * fmt, ...), const char * const name) {
+    if (name == NULL) {
+        print("%-20s", "(other)");
+    } else {
+        print("%-20.*s", (int)_name_len(name), name);
+    }
+}
+
+void lfs_prof_print(int (*print)(const char * fmt, ...), const int trace_on) {
+    _lock();
+
+    print("%-20s %6s %9s %8s %9s %8s %8s %5s %5s\n", "api", "calls", "us", "max", "bd_us",
+          "read", "prog", "erase", "cmpct");
+    for (uint32_t i = 0; i < LFS_PROF_API_CNT; ++i) {
+        const lfs_prof_api_stat * const s = &api[i];
+        if (s->calls + s->rd_bytes + s->pg_bytes + s->erases + s->compacts == 0) {
+            continue;
+        }
+        _print_name(print, s->name);
+        print(" %6u %9u %8u %9u %8u %8u %5u %5u\n", s->calls, s->us, s->max_us, s->bd_us,
+              s->rd_bytes, s->pg_bytes, s->erases, s->compacts);
+    }
+
+    print("%-11s %5s %8s %5s %7s\n", "dir pair", "split", "relocate", "full", "rewrite");
+    for (uint32_t i = 0; i < LFS_PROF_DIR_CNT; ++i) {
+        const lfs_prof_dir * const d = &dirs[i];
+        if (_dir_sum(d) > 0) {
+            print("{%4u,%4u} %5u %8u %5u %7u\n", d->pair[0], d->pair[1], d->cnt[0],
+                  d->cnt[1], d->cnt[2], d->cnt[3]);
+        }
+    }
+
+    if (trace_on) {
+        const uint32_t cnt =
+            (trace_cnt < LFS_PROF_TRACE_CNT) ? trace_cnt : LFS_PROF_TRACE_CNT;
+        print("%10s %-20s %-7s %5s %5s %5s %8s\n", "stamp", "api", "op", "block", "off",
+              "size", "us");
+        for (uint32_t i = trace_cnt - cnt; i != trace_cnt; ++i) {
+            const lfs_prof_rec * const r = &trace[i % LFS_PROF_TRACE_CNT];
+            print("%10u ", r->stamp);
+            _print_name(print, (r->api == 0) ? NULL : api[r->api].name);
+            if (r->op == LFS_PROF_COMPACT) {
+                print(" %-7s %5u %5u %s\n", op_name[r->op], r->block, r->off,
+                      (r->size < 4) ? reason_name[r->size] : "?");
+            } else {
+                print(" %-7s %5u %5u %5u %8u\n", op_name[r->op], r->block, r->off,
+                      r->size, r->us);
+            }
+        }
+    }
+
+    _unlock();
+}
+
+#else
+
+void lfs_prof_reset(void) {
+}
+
+void lfs_prof_print(int (*print)(const char * fmt, ...), const int trace_on) {
+    print("lfs_prof disabled\n");
+}
+
+#endif  // LFS_PROF
+
+/********** 板上的MSH命令 **********/
+
+#ifndef LFS_PORT_HOST
+
+/**
+ * @brief lfsstat [trace|reset]：查看littlefs各接口的块设备开销。
+ * @param argc 参数个数。
+ * @param argv trace：同时打印跟踪缓冲区；reset：清空统计。
+ * @retval
+ * @warning
+ * @note
+ */
+static void lfsstat(int argc, char ** argv) {
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        lfs_prof_reset();
+        return;
+    }
+    lfs_prof_print(rt_kprintf, (argc > 1) && (strcmp(argv[1], "trace") == 0));
+}
+MSH_CMD_EXPORT(lfsstat, littlefs cost per api : lfsstat[trace | reset]);
+
+#endif  // LFS_PORT_HOST
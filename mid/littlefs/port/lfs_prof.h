@@ -0,0 +1,152 @@
+#ifndef LFS_PROF_H
+#define LFS_PROF_H
+
+/**
+ * @brief 这是littlefs的块设备开销统计模块。
+ * @details littlefs的每个公开接口在持有锁后、释放锁前各调用一次LFS_TRACE，
+ * lfs_util.h把它映射到lfs_prof_api，据此知道当前正在执行哪个接口；
+ * lfs_port的读、编程、擦除回调（lfs_bd_read等缓存未命中时才会到达）调用lfs_prof_bd，
+ * lfs_dir_compact开始时调用lfs_prof_compact。
+ * 于是每次读取/编程的字节数、擦除次数、压缩次数和耗时都记到触发它的接口名下，
+ * 同时写入一个环形跟踪缓冲区，并按元数据对统计压缩次数与原因。
+ * 板上通过MSH命令lfsstat查看，主机上由tool/lfs_host.c打印。
+ * @file lfs_prof.h
+ * @author proyrb
+ * @date 2025/8/16
+ * @note 所有钩子都在文件系统锁内调用，不需要另外加锁。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <stdint.h>
+
+/********** 配置模块行为 **********/
+
+// 是否启用统计：0表示不编译钩子，lfs_port的读写擦除不再计时
+#define LFS_PROF 1
+
+#ifdef LFS_PROF_C
+
+// 可以分别统计的接口个数，超出的接口记在第0项
+#    define LFS_PROF_API_CNT 16
+
+// 跟踪缓冲区的记录条数
+#    define LFS_PROF_TRACE_CNT 32
+
+// 分别统计压缩次数的元数据对个数，满后替换次数最少的一项
+#    define LFS_PROF_DIR_CNT 8
+
+#endif  // LFS_PROF_C
+
+/********** 操作类型 **********/
+
+#define LFS_PROF_READ    0
+#define LFS_PROF_PROG    1
+#define LFS_PROF_ERASE   2
+#define LFS_PROF_COMPACT 3
+
+/********** 统计结果 **********/
+
+typedef struct {
+    const char * name;      // littlefs的跟踪格式串，接口名以'('结束；NULL表示空项
+    uint32_t     calls;     // 调用次数
+    uint32_t     us;        // 累计耗时
+    uint32_t     max_us;    // 单次最长耗时
+    uint32_t     bd_us;     // 其中花在块设备上的时间
+    uint32_t     rd_bytes;  // 读取字节数
+    uint32_t     pg_bytes;  // 编程字节数
+    uint32_t     erases;    // 擦除次数
+    uint32_t     compacts;  // 元数据压缩次数
+} lfs_prof_api_stat;
+
+typedef struct {
+    uint32_t stamp;  // 开始时间（us）
+    uint32_t block;  // 块号；压缩时为元数据对的第一块
+    uint32_t us;     // 耗时；压缩时为0，随后的擦除与编程记录就是它的开销
+    uint16_t off;    // 块内偏移；压缩时为元数据对的第二块
+    uint16_t size;   // 字节数；压缩时为原因LFS_COMPACT_*
+    uint8_t  op;     // LFS_PROF_*
+    uint8_t  api;    // 接口在统计表中的下标
+} lfs_prof_rec;
+
+typedef struct {
+    uint32_t pair[2];  // 元数据对，按块号从小到大排列
+    uint16_t cnt[4];   // 按原因LFS_COMPACT_*分别计数
+} lfs_prof_dir;
+
+/********** 导出的函数 **********/
+
+#if LFS_PROF
+
+/**
+ * @brief 取得微秒时间戳。
+ * @param
+ * @retval 时间戳，允许回绕。
+ * @warning
+ * @note 主机版本返回模拟芯片的虚拟时钟，只包含芯片耗时。
+ */
+extern uint32_t lfs_prof_now(void);
+
+/**
+ * @brief littlefs公开接口的进入与退出。
+ * @param fmt LFS_TRACE的格式串：接口名后面是'('表示进入，是' '表示退出。
+ * @retval
+ * @warning 只能由LFS_TRACE调用。
+ * @note 格式串是字符串常量，用它的地址区分接口。
+ */
+extern void lfs_prof_api(const char * fmt);
+
+/**
+ * @brief 记录一次块设备操作。
+ * @param op LFS_PROF_READ、LFS_PROF_PROG或LFS_PROF_ERASE。
+ * @param block 块号。
+ * @param off 块内偏移。
+ * @param size 字节数。
+ * @param start 操作开始时lfs_prof_now的值。
+ * @retval
+ * @warning 必须持有文件系统锁。
+ * @note
+ */
+extern void lfs_prof_bd(const uint8_t  op,
+                        const uint32_t block,
+                        const uint32_t off,
+                        const uint32_t size,
+                        const uint32_t start);
+
+/**
+ * @brief 记录一次元数据压缩。
+ * @param pair 元数据对。
+ * @param reason 原因LFS_COMPACT_*。
+ * @retval
+ * @warning 只能由LFS_COMPACT调用。
+ * @note
+ */
+extern void lfs_prof_compact(const uint32_t pair[2], const int reason);
+
+#else
+
+#    define lfs_prof_now()                         0
+#    define lfs_prof_bd(op, block, off, size, start) ((void)(start))
+
+#endif  // LFS_PROF
+
+/**
+ * @brief 清空全部统计与跟踪记录。
+ * @param
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lfs_prof_reset(void);
+
+/**
+ * @brief 打印各接口的开销与压缩最频繁的元数据对。
+ * @param print 输出函数。
+ * @param trace_on 非0时同时按时间顺序打印跟踪缓冲区。
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lfs_prof_print(int (*print)(const char * fmt, ...), const int trace_on);
+
+#endif  // LFS_PROF_H
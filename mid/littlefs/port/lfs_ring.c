@@ -0,0 +1,391 @@
+#define LFS_RING_C
+
+#include <lfs_ring.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/* 段头：位于每个段文件的开头 */
+typedef struct {
+    uint32_t magic;  // SEG_MAGIC
+    uint32_t gen;    // 代数：每切换一次段加1
+    uint32_t rsv;    // 保留，全1
+    uint32_t crc;    // 以上字段的CRC
+} seg_hdr;
+
+#define SEG_MAGIC 0x474E4952  // "RING"
+
+/* 记录：数据（补齐到4字节）、CRC、标签；标签的低16位是长度，高16位是长度取反。
+ * 提交时用全0的字补齐到页边界，合法的标签不会是0，因此向前遍历时可以跳过补齐 */
+#define REC_TAG(len)  ((uint32_t)(len) | ((uint32_t)(~(len) & 0xFFFF) << 16))
+#define REC_LEN(tag)  ((tag) & 0xFFFF)
+#define REC_OK(tag)   (((tag) >> 16) == (~(tag) & 0xFFFF))
+#define REC_PAD       0x00000000
+#define REC_SIZE(len) ((((len) + 3) & ~3UL) + 8)
+
+/********** 内部函数 **********/
+
+static void _lock(void) {
+    const struct lfs_config * const c = lfs_port_cfg();
+    c->lock(c);
+}
+
+static void _unlock(void) {
+    const struct lfs_config * const c = lfs_port_cfg();
+    c->unlock(c);
+}
+
+static void _seg_path(const lfs_ring * const ring, const uint32_t seg,
+                      char * const path) {
+    snprintf(path, LFS_RING_PATH_MAX + 4, "%s/%u", ring->dir, seg);
+}
+
+/**
+ * @brief 把数据放进写入缓冲区，凑满一页就写入文件。
+ * @param ring 句柄。
+ * @param data 数据。
+ * @param size 字节数。
+ * @retval 0：成功。
+ * @retval <0：littlefs错误码。
+ * @warning
+ * @note 每次lfs_file_write都是从页首开始的一整页，littlefs的文件缓存直接编程一页。
+ */
+static int _put(lfs_ring * const ring, const void * const data, uint32_t size) {
+    const uint8_t * src = data;
+    while (size > 0) {
+        uint32_t n = LFS_RING_BUF_SIZE - ring->fill;
+        n          = (n < size) ? n : size;
+        memcpy((uint8_t *)ring->buf + ring->fill, src, n);
+        ring->fill += n;
+        src += n;
+        size -= n;
+
+        if (ring->fill == LFS_RING_BUF_SIZE) {
+            const lfs_ssize_t res =
+                lfs_file_write(lfs_port_fs(), &ring->file, ring->buf, LFS_RING_BUF_SIZE);
+            if (res < 0) {
+                return (int)res;
+            }
+            ring->size += LFS_RING_BUF_SIZE;
+            ring->fill = 0;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 补齐到页边界并同步。
+ * @param ring 句柄。
+ * @retval 0：成功。
+ * @retval <0：littlefs错误码。
+ * @warning 必须持有锁。
+ * @note
+ */
+static int _commit(lfs_ring * const ring) {
+    if (ring->fill > 0) {
+        const uint32_t pad = REC_PAD;
+        while (ring->fill > 0) {
+            const int err = _put(ring, &pad, sizeof(pad));
+            if (err != 0) {
+                return err;
+            }
+        }
+    }
+    return lfs_file_sync(lfs_port_fs(), &ring->file);
+}
+
+/**
+ * @brief 找出比指定段更旧的段中最新的一个。
+ * @param ring 句柄。
+ * @param seg 段。
+ * @retval 段号：LFS_RING_SEG_CNT表示没有更旧的段。
+ * @warning
+ * @note
+ */
+static uint32_t _older(const lfs_ring * const ring, const uint32_t seg) {
+    uint32_t best = LFS_RING_SEG_CNT;
+    for (uint32_t i = 0; i < LFS_RING_SEG_CNT; ++i) {
+        if ((ring->gen[i] != 0) && (ring->gen[i] < ring->gen[seg]) &&
+            ((best == LFS_RING_SEG_CNT) || (ring->gen[i] > ring->gen[best]))) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief 清空最旧的段并把它作为当前段。
+ * @param ring 句柄。
+ * @param first 1：打开日志时还没有任何段。
+ * @retval 0：成功。
+ * @retval <0：littlefs错误码。
+ * @warning 必须持有锁；调用前当前段必须已经提交并关闭。
+ * @note 用O_TRUNC重新打开，截断与新的段头在下一次提交时一起生效，
+ * 在此之前掉电，旧段的内容仍然完整。
+ */
+static int _rotate(lfs_ring * const ring, const uint8_t first) {
+    uint32_t next = 0;
+    for (uint32_t i = 1; i < LFS_RING_SEG_CNT; ++i) {
+        next = (ring->gen[i] < ring->gen[next]) ? i : next;
+    }
+
+    char path[LFS_RING_PATH_MAX + 4];
+    _seg_path(ring, next, path);
+    const int err =
+        lfs_port_file_open(&ring->file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if (err < 0) {
+        return err;
+    }
+    ring->closed = 0;
+
+    seg_hdr hdr;
+    hdr.magic       = SEG_MAGIC;
+    hdr.gen         = first ? 1 : ring->gen[ring->head] + 1;
+    hdr.rsv         = 0xFFFFFFFF;
+    hdr.crc         = lfs_crc(0xFFFFFFFF, &hdr, offsetof(seg_hdr, crc));
+    ring->gen[next] = hdr.gen;
+    ring->head      = next;
+    ring->size      = 0;
+    ring->fill      = 0;
+    return _put(ring, &hdr, sizeof(hdr));
+}
+
+/**
+ * @brief 确保当前段是打开的。
+ * @param ring 句柄。
+ * @retval 0：成功。
+ * @retval <0：littlefs错误码，当前段仍然是关闭的。
+ * @warning 必须持有锁；碰ring->file之前调用。
+ * @note 写满的段已经提交并关闭、但切换失败时（例如文件缓存暂时用完），在这里重试切换。
+ */
+static int _reopen(lfs_ring * const ring) {
+    return ring->closed ? _rotate(ring, 0) : LFS_ERR_OK;
+}
+
+/********** 导出的函数 **********/
+
+int lfs_ring_open(lfs_ring * const ring, const char * const dir) {
+    memset(ring, 0, sizeof(*ring));
+    if (strlen(dir) >= LFS_RING_PATH_MAX) {
+        return LFS_ERR_NAMETOOLONG;
+    }
+    strcpy(ring->dir, dir);
+
+    _lock();
+    int err = lfs_mkdir(lfs_port_fs(), dir);
+    if ((err != LFS_ERR_OK) && (err != LFS_ERR_EXIST)) {
+        _unlock();
+        return err;
+    }
+
+    /* 读取各段的段头，代数最大的是当前段 */
+    char path[LFS_RING_PATH_MAX + 4];
+    for (uint32_t i = 0; i < LFS_RING_SEG_CNT; ++i) {
+        seg_hdr hdr;
+        _seg_path(ring, i, path);
+        if (lfs_port_file_open(&ring->file, path, LFS_O_RDONLY) < 0) {
+            continue;
+        }
+        const lfs_ssize_t n =
+            lfs_file_read(lfs_port_fs(), &ring->file, &hdr, sizeof(hdr));
+        lfs_port_file_close(&ring->file);
+        if ((n == sizeof(hdr)) && (hdr.magic == SEG_MAGIC) &&
+            (hdr.crc == lfs_crc(0xFFFFFFFF, &hdr, offsetof(seg_hdr, crc)))) {
+            ring->gen[i] = hdr.gen;
+            ring->head   = (hdr.gen > ring->gen[ring->head]) ? i : ring->head;
+        }
+    }
+
+    if (ring->gen[ring->head] == 0) {
+        err = _rotate(ring, 1);
+        err = err ? err : _commit(ring);
+    } else {
+        _seg_path(ring, ring->head, path);
+        err = lfs_port_file_open(&ring->file, path, LFS_O_WRONLY | LFS_O_APPEND);
+        if (err == LFS_ERR_OK) {
+            const lfs_soff_t size = lfs_file_size(lfs_port_fs(), &ring->file);
+            err                   = (size < 0) ? (int)size : LFS_ERR_OK;
+            ring->size            = (uint32_t)size;
+        }
+    }
+    _unlock();
+    return err;
+}
+
+int lfs_ring_append(lfs_ring * const ring, const void * const data, const uint32_t size) {
+    if ((size == 0) || (size > LFS_RING_REC_MAX)) {
+        return LFS_ERR_INVAL;
+    }
+
+    _lock();
+    int err = _reopen(ring);
+    if ((err == LFS_ERR_OK) &&
+        (ring->size + ring->fill + REC_SIZE(size) > LFS_RING_SEG_SIZE)) {
+        err = _commit(ring);
+        if (err == LFS_ERR_OK) {
+            /* 无论成功与否文件都已关闭，切换失败时由_reopen重试 */
+            ring->closed = 1;
+            err          = lfs_port_file_close(&ring->file);
+        }
+        err = err ? err : _rotate(ring, 0);
+    }
+
+    const uint32_t pad = 0;
+    const uint32_t tag = REC_TAG(size);
+    uint32_t       crc = lfs_crc(0xFFFFFFFF, data, size);
+    crc                = lfs_crc(crc, &tag, sizeof(tag));
+    err                = err ? err : _put(ring, data, size);
+    err                = err ? err : _put(ring, &pad, REC_SIZE(size) - 8 - size);
+    err                = err ? err : _put(ring, &crc, sizeof(crc));
+    err                = err ? err : _put(ring, &tag, sizeof(tag));
+    _unlock();
+    return err;
+}
+
+int lfs_ring_commit(lfs_ring * const ring) {
+    _lock();
+    int err = _reopen(ring);
+    err     = err ? err : _commit(ring);
+    _unlock();
+    return err;
+}
+
+int lfs_ring_close(lfs_ring * const ring) {
+    /* 写满的段关闭之前已经提交，没有别的要做 */
+    _lock();
+    if (ring->closed) {
+        _unlock();
+        return LFS_ERR_OK;
+    }
+    const int err   = _commit(ring);
+    const int close = lfs_port_file_close(&ring->file);
+    _unlock();
+    return err ? err : close;
+}
+
+void lfs_ring_iter_init(lfs_ring * const ring, lfs_ring_iter * const it) {
+    memset(it, 0, sizeof(*it));
+    it->ring = ring;
+    it->seg  = ring->head;
+    for (uint32_t i = 0; i < LFS_RING_SEG_CNT; ++i) {
+        it->left += (ring->gen[i] != 0);
+    }
+}
+
+/**
+ * @brief 切换到更旧的一段。
+ * @param it 迭代器。
+ * @retval
+ * @warning 必须持有锁。
+ * @note
+ */
+static void _iter_next_seg(lfs_ring_iter * const it) {
+    if (it->open) {
+        lfs_port_file_close(&it->file);
+        it->open = 0;
+    }
+    --it->left;
+    it->seg = (uint8_t)_older(it->ring, it->seg);
+    if (it->seg == LFS_RING_SEG_CNT) {
+        it->left = 0;
+    }
+}
+
+/**
+ * @brief 从当前段的指定位置读取。
+ * @param it 迭代器。
+ * @param pos 位置。
+ * @param buf 缓冲区。
+ * @param size 字节数。
+ * @retval 0：成功。
+ * @retval <0：littlefs错误码。
+ * @warning
+ * @note
+ */
+static int _iter_read(lfs_ring_iter * const it, const uint32_t pos, void * const buf,
+                      const uint32_t size) {
+    lfs_soff_t off = lfs_file_seek(lfs_port_fs(), &it->file, pos, LFS_SEEK_SET);
+    if (off < 0) {
+        return (int)off;
+    }
+    const lfs_ssize_t n = lfs_file_read(lfs_port_fs(), &it->file, buf, size);
+    return (n < 0) ? (int)n : ((n == (lfs_ssize_t)size) ? 0 : LFS_ERR_CORRUPT);
+}
+
+int lfs_ring_iter_prev(lfs_ring_iter * const it, void * const buf, const uint32_t size) {
+    int ret = 0;
+
+    _lock();
+    while ((ret == 0) && (it->left > 0)) {
+        if (!it->open) {
+            char path[LFS_RING_PATH_MAX + 4];
+            _seg_path(it->ring, it->seg, path);
+            ret = lfs_port_file_open(&it->file, path, LFS_O_RDONLY);
+            if (ret < 0) {
+                break;
+            }
+            it->open = 1;
+            it->end  = (uint32_t)lfs_file_size(lfs_port_fs(), &it->file);
+        }
+
+        /* 段头之前没有记录了 */
+        if (it->end < sizeof(seg_hdr) + 8) {
+            _iter_next_seg(it);
+            continue;
+        }
+
+        uint32_t tail[2];  // CRC与标签
+        ret = _iter_read(it, it->end - 8, tail, sizeof(tail));
+        if (ret < 0) {
+            break;
+        }
+        if (tail[1] == REC_PAD) {
+            it->end -= 4;
+            continue;
+        }
+
+        const uint32_t len   = REC_LEN(tail[1]);
+        const uint32_t start = it->end - REC_SIZE(len);
+        if (!REC_OK(tail[1]) || (REC_SIZE(len) > it->end - sizeof(seg_hdr))) {
+            _iter_next_seg(it);
+            ret = LFS_ERR_CORRUPT;
+            break;
+        }
+
+        /* 数据先读进调用者的缓冲区，放不下的部分分段读取，只用于计算CRC */
+        const uint32_t copy = (len < size) ? len : size;
+        uint32_t       crc  = 0xFFFFFFFF;
+        ret                 = _iter_read(it, start, buf, copy);
+        crc                 = lfs_crc(crc, buf, copy);
+        for (uint32_t done = copy; (ret == 0) && (done < len);) {
+            uint8_t        chunk[32];
+            const uint32_t n = (len - done < sizeof(chunk)) ? len - done : sizeof(chunk);
+            ret              = _iter_read(it, start + done, chunk, n);
+            crc              = lfs_crc(crc, chunk, n);
+            done += n;
+        }
+        if (ret < 0) {
+            break;
+        }
+        crc = lfs_crc(crc, &tail[1], sizeof(tail[1]));
+
+        it->end = start;
+        if (crc != tail[0]) {
+            _iter_next_seg(it);
+            ret = LFS_ERR_CORRUPT;
+            break;
+        }
+        ret = (int)len;
+    }
+    _unlock();
+    return ret;
+}
+
+void lfs_ring_iter_end(lfs_ring_iter * const it) {
+    if (it->open) {
+        _lock();
+        lfs_port_file_close(&it->file);
+        it->open = 0;
+        _unlock();
+    }
+    it->left = 0;
+}
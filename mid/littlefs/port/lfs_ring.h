@@ -0,0 +1,144 @@
+#ifndef LFS_RING_H
+#define LFS_RING_H
+
+/**
+ * @brief 这是建立在littlefs上的环形日志模块。
+ * @details 日志由固定数量的段文件（目录下的0、1……）组成，追加时先放进一页大小的缓冲区，
+ * 凑满一页才调用lfs_file_write，因此每次编程都是一整页；
+ * 只有调用lfs_ring_commit时才填充到页边界并lfs_file_sync，之前的记录掉电后会丢失。
+ * 当前段写满后，用O_TRUNC重新打开最旧的段继续写，不需要改名或删除。
+ * 每条记录的末尾是CRC与带有长度的标签，读取时从段尾的标签开始向前遍历，先返回最新的记录。
+ * @file lfs_ring.h
+ * @author proyrb
+ * @date 2025/8/18
+ * @note littlefs每次lfs_file_sync后的下一次追加都要把最后一块未写满的部分复制到新块，
+ * 逐条打开、追加、关闭会让每条记录都付出这次复制与一次元数据提交，
+ * 因此请按业务需要的可靠性选择提交的时机，而不是每条都提交。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <lfs_port.h>
+
+/********** 配置模块行为 **********/
+
+// 段文件个数
+#define LFS_RING_SEG_CNT 4
+
+// 每个段的最大字节数（包括段头）
+#define LFS_RING_SEG_SIZE (8 * 1024)
+
+// 写入缓冲区的字节数：等于编程粒度
+#define LFS_RING_BUF_SIZE 256
+
+// 单条记录的最大字节数
+#define LFS_RING_REC_MAX 200
+
+// 路径的最大长度
+#define LFS_RING_PATH_MAX 24
+
+/********** 日志句柄 **********/
+
+typedef struct {
+    char       dir[LFS_RING_PATH_MAX];            // 段文件所在目录
+    lfs_file_t file;                              // 当前段，打开期间一直占用一个文件缓存
+    uint32_t   gen[LFS_RING_SEG_CNT];             // 各段的代数，0表示空段
+    uint8_t    head;                              // 当前段
+    uint8_t    closed;                            // 当前段已关闭，切换到下一段还没有成功
+    uint32_t   size;                              // 当前段已经写入文件的字节数
+    uint32_t   fill;                              // 缓冲区中的字节数
+    uint32_t   buf[LFS_RING_BUF_SIZE / 4];        // 写入缓冲区
+} lfs_ring;
+
+typedef struct {
+    lfs_ring * ring;  // 日志
+    lfs_file_t file;  // 正在读取的段
+    uint8_t    open;  // file是否已经打开
+    uint8_t    left;  // 还没有读取的段数（包括当前段）
+    uint8_t    seg;   // 当前段
+    uint32_t   end;   // 当前段中下一条要返回的记录的结束位置
+} lfs_ring_iter;
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 打开日志，目录或段文件不存在时创建。
+ * @param ring 句柄。
+ * @param dir 目录。
+ * @retval 0：成功。
+ * @retval <0：littlefs错误码。
+ * @warning 线程安全；文件系统必须已经挂载；关闭前一直占用一个文件缓存。
+ * @note 代数最大的段作为当前段，继续在它的末尾追加。
+ */
+extern int lfs_ring_open(lfs_ring * const ring, const char * const dir);
+
+/**
+ * @brief 追加一条记录。
+ * @param ring 句柄。
+ * @param data 数据。
+ * @param size 字节数：1到LFS_RING_REC_MAX。
+ * @retval 0：成功。
+ * @retval LFS_ERR_INVAL：size超出范围。
+ * @retval <0：其它littlefs错误码。
+ * @warning 线程安全。
+ * @note 缓冲区凑满一页才写入文件；当前段放不下时先提交，再切换到最旧的段。
+ * 切换失败时返回错误，下一次追加或提交先重试切换。
+ */
+extern int lfs_ring_append(lfs_ring * const ring, const void * const data,
+                           const uint32_t size);
+
+/**
+ * @brief 提交：之前追加的记录在掉电后仍然存在。
+ * @param ring 句柄。
+ * @retval 0：成功。
+ * @retval <0：littlefs错误码。
+ * @warning 线程安全。
+ * @note 用填充记录补齐到页边界后同步文件，没有新记录时什么也不做。
+ */
+extern int lfs_ring_commit(lfs_ring * const ring);
+
+/**
+ * @brief 提交并关闭日志。
+ * @param ring 句柄。
+ * @retval 0：成功。
+ * @retval <0：littlefs错误码，文件缓存同样会归还。
+ * @warning 线程安全。
+ * @note
+ */
+extern int lfs_ring_close(lfs_ring * const ring);
+
+/**
+ * @brief 开始从最新的记录向前遍历。
+ * @param ring 句柄。
+ * @param it 迭代器。
+ * @retval
+ * @warning 遍历期间不要追加；只能看到已经提交的记录。
+ * @note
+ */
+extern void lfs_ring_iter_init(lfs_ring * const ring, lfs_ring_iter * const it);
+
+/**
+ * @brief 取出上一条记录。
+ * @param it 迭代器。
+ * @param buf 接收缓冲区。
+ * @param size 缓冲区字节数。
+ * @retval >0：记录的字节数。
+ * @retval 0：已经没有更早的记录。
+ * @retval LFS_ERR_CORRUPT：记录损坏，该段中更早的记录被跳过。
+ * @retval <0：其它littlefs错误码。
+ * @warning 线程安全；每次迭代会占用一个文件缓存，必须用lfs_ring_iter_end结束。
+ * @note 记录比缓冲区长时只拷贝前size字节，返回值仍是记录的字节数。
+ */
+extern int lfs_ring_iter_prev(lfs_ring_iter * const it, void * const buf,
+                              const uint32_t size);
+
+/**
+ * @brief 结束遍历并归还文件缓存。
+ * @param it 迭代器。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void lfs_ring_iter_end(lfs_ring_iter * const it);
+
+#endif  // LFS_RING_H
@@ -0,0 +1,252 @@
+#define LV_DRAW_SC32_DMA_C
+
+#include <lv_draw_sc32_dma.h>
+#include <lv_port_layer.h>
+#ifndef LV_DRAW_SC32_DMA_HOST
+#    include <sc32_conf.h>
+#    include <rtthread.h>
+#    include <rthw.h>
+#else
+#    include <dma_sim.h>
+#endif  // LV_DRAW_SC32_DMA_HOST
+
+#if (LV_COLOR_DEPTH != 16)
+#    error "lv_draw_sc32_dma needs LV_COLOR_DEPTH 16"
+#endif
+
+/* 正在进行的任务：在LVGL线程中启动，在完成中断中逐行续传 */
+typedef struct {
+    uint32_t dst;    // 下一行的目标地址
+    uint32_t src;    // 下一行的源地址，填充时固定指向fill_word
+    uint32_t cnt;    // 每行的数据个数
+    uint32_t dstep;  // 目标的行距（字节）
+    uint32_t sstep;  // 源的行距（字节），填充时为0
+    uint32_t rows;   // 还没有启动的行数
+} dma_job;
+
+static struct rt_semaphore   dma_done;     // 整个任务完成
+static volatile dma_job      job;          // 当前任务
+static volatile uint8_t      pending = 0;  // 有一个已经启动、还没有被等待过的任务
+static uint32_t              fill_word;    // 填充的源：两个相同的像素
+static lv_draw_sc32_dma_stat stat;         // 只在LVGL线程中修改，rows除外
+
+/**
+ * @brief 设置传输宽度与源地址模式。
+ * @param size DMA_DataSize_Word或DMA_DataSize_HalfWord。
+ * @param mode DMA_SourceMode_INC或DMA_SourceMode_FIXED（填充）。
+ * @retval
+ * @warning 通道必须处于关闭状态；DMA_Init会改写整个配置，这里只改这两个字段。
+ * @note
+ */
+static void _dma_config(const uint32_t size, const uint32_t mode) {
+    const uint32_t cfg = USE_DMA->DMA_CFG & ~(DMA_CFG_TXWIDTH | DMA_CFG_SAINC);
+    USE_DMA->DMA_CFG   = cfg | size | mode;
+}
+
+/**
+ * @brief 启动任务的下一行。
+ * @param
+ * @retval
+ * @warning 在中断中调用时不能被LVGL线程打断；在线程中只用来启动第一行。
+ * @note 先把任务推进到再下一行，再触发传输：传输完成的中断可能立即到来。
+ */
+static void _dma_next(void) {
+    const uint32_t dst = job.dst;
+    const uint32_t src = job.src;
+    job.dst += job.dstep;
+    job.src += job.sstep;
+    --job.rows;
+
+    DMA_Cmd(USE_DMA, DISABLE);
+    DMA_SetSrcAddress(USE_DMA, src);
+    DMA_SetDstAddress(USE_DMA, dst);
+    DMA_SetCurrDataCounter(USE_DMA, job.cnt);
+    DMA_Cmd(USE_DMA, ENABLE);
+    DMA_SoftwareTrigger(USE_DMA);
+}
+
+/**
+ * @brief 先等待DMA完成，再调用软件实现。
+ * @param
+ * @retval
+ * @warning
+ * @note 这几个回调会直接读写缓冲区而不经过blend，LVGL不会在此之前等待。
+ */
+static void _layer_adjust(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx,
+                          lv_draw_layer_flags_t flags) {
+    lv_draw_sc32_dma_wait_for_finish(draw_ctx);
+    lv_draw_sw_layer_adjust(draw_ctx, layer_ctx, flags);
+}
+
+static void _layer_blend(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx,
+                         const lv_draw_img_dsc_t * draw_dsc) {
+    lv_draw_sc32_dma_wait_for_finish(draw_ctx);
+    lv_draw_sw_layer_blend(draw_ctx, layer_ctx, draw_dsc);
+}
+
+static void _buffer_copy(lv_draw_ctx_t * draw_ctx, void * dest_buf,
+                         lv_coord_t dest_stride, const lv_area_t * dest_area,
+                         void * src_buf, lv_coord_t src_stride,
+                         const lv_area_t * src_area) {
+    lv_draw_sc32_dma_wait_for_finish(draw_ctx);
+    lv_draw_sw_buffer_copy(draw_ctx, dest_buf, dest_stride, dest_area, src_buf,
+                           src_stride, src_area);
+}
+
+/********** 导出的函数 **********/
+
+int lv_draw_sc32_dma_init(void) {
+    return rt_sem_init(&dma_done, "ldma", 0, RT_IPC_FLAG_FIFO);
+}
+
+void lv_draw_sc32_dma_ctx_init(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx) {
+    lv_port_blend_init_ctx(drv, draw_ctx);
+
+    lv_draw_sc32_dma_ctx_t * const ctx = (lv_draw_sc32_dma_ctx_t *)draw_ctx;
+    ctx->blend                         = lv_draw_sc32_dma_blend;
+    ctx->base_draw.wait_for_finish     = lv_draw_sc32_dma_wait_for_finish;
+    ctx->base_draw.layer_adjust        = _layer_adjust;
+    ctx->base_draw.layer_blend         = _layer_blend;
+    ctx->base_draw.buffer_copy         = _buffer_copy;
+
+    /* 按空闲内存分配图层，换掉上面的_layer_adjust，它自己会先等待DMA */
+    lv_port_layer_init_ctx(draw_ctx);
+}
+
+void lv_draw_sc32_dma_blend(lv_draw_ctx_t *                draw_ctx,
+                            const lv_draw_sw_blend_dsc_t * dsc) {
+    /* 上一次传输还在使用job与fill_word，软件实现也可能写到它正在写的区域 */
+    lv_draw_sc32_dma_wait_for_finish(draw_ctx);
+
+    /* 只接管不透明、不带蒙版的填充，以及源图在Flash中的同类贴图 */
+    lv_disp_t * const      disp = _lv_refr_get_disp_refreshing();
+    const uint16_t * const src  = (const uint16_t *)dsc->src_buf;
+    if ((disp->driver->set_px_cb != NULL) || disp->driver->screen_transp ||
+        (dsc->blend_mode != LV_BLEND_MODE_NORMAL) || (dsc->opa < LV_OPA_MAX) ||
+        ((dsc->mask_buf != NULL) && (dsc->mask_res != LV_DRAW_MASK_RES_FULL_COVER)) ||
+        ((src != NULL) && ((uintptr_t)src >= SRAM_BASE))) {
+        lv_port_blend(draw_ctx, dsc);
+        return;
+    }
+
+    lv_area_t area;
+    if (!_lv_area_intersect(&area, dsc->blend_area, draw_ctx->clip_area)) {
+        return;
+    }
+    const int32_t w = lv_area_get_width(&area);
+    const int32_t h = lv_area_get_height(&area);
+    if (w * h < DMA_MIN_PX) {
+        lv_port_blend(draw_ctx, dsc);
+        return;
+    }
+
+    const lv_area_t * const buf_area = draw_ctx->buf_area;
+    const int32_t           stride   = lv_area_get_width(buf_area);
+    uint16_t *              dest     = (uint16_t *)draw_ctx->buf;
+    dest += stride * (area.y1 - buf_area->y1) + (area.x1 - buf_area->x1);
+
+    int32_t          sstride = 0;
+    const uint16_t * s       = (const uint16_t *)&fill_word;
+    if (src != NULL) {
+        sstride = lv_area_get_width(dsc->blend_area);
+        s       = src + sstride * (area.y1 - dsc->blend_area->y1);
+        s += area.x1 - dsc->blend_area->x1;
+    }
+
+    /* 各行首尾相接时合并成一次传输 */
+    int32_t cnt  = w;
+    int32_t rows = h;
+    if ((stride == w) && ((src == NULL) || (sstride == w))) {
+        cnt  = w * h;
+        rows = 1;
+    }
+
+    /* 每次传输的首地址与长度都对齐到字时按字传输，否则按半字 */
+    uint32_t align = (uint32_t)(uintptr_t)dest | (uint32_t)(cnt * 2);
+    if (rows > 1) {
+        align |= (uint32_t)(stride * 2);
+    }
+    if (src != NULL) {
+        align |= (uint32_t)(uintptr_t)s | ((rows > 1) ? (uint32_t)(sstride * 2) : 0);
+    }
+    const uint32_t word = (align & 2) == 0;
+
+    fill_word = dsc->color.full | ((uint32_t)dsc->color.full << 16);
+    job.dst   = (uint32_t)(uintptr_t)dest;
+    job.src   = (uint32_t)(uintptr_t)s;
+    job.cnt   = word ? (uint32_t)cnt / 2 : (uint32_t)cnt;
+    job.dstep = (uint32_t)stride * 2;
+    job.sstep = (uint32_t)sstride * 2;
+    job.rows  = (uint32_t)rows;
+
+    DMA_Cmd(USE_DMA, DISABLE);
+    _dma_config(word ? DMA_DataSize_Word : DMA_DataSize_HalfWord,
+                (src != NULL) ? DMA_SourceMode_INC : DMA_SourceMode_FIXED);
+    pending = 1;
+    _dma_next();
+
+    if (src != NULL) {
+        ++stat.copies;
+    } else {
+        ++stat.fills;
+    }
+    stat.pixels += (uint32_t)(w * h);
+    stat.halfword += !word;
+}
+
+void lv_draw_sc32_dma_wait_for_finish(lv_draw_ctx_t * draw_ctx) {
+    LV_UNUSED(draw_ctx);
+    if (!pending) {
+        return;
+    }
+    if (rt_sem_trytake(&dma_done) != RT_EOK) {
+        ++stat.waits;
+        rt_sem_take(&dma_done, RT_WAITING_FOREVER);
+    }
+    pending = 0;
+}
+
+void lv_draw_sc32_dma_irq(void) {
+    if (job.rows > 0) {
+        ++stat.rows;
+        _dma_next();
+        return;
+    }
+    DMA_Cmd(USE_DMA, DISABLE);
+    rt_sem_release(&dma_done);
+}
+
+void lv_draw_sc32_dma_info(lv_draw_sc32_dma_stat * const s) {
+    rt_base_t level = rt_hw_interrupt_disable();
+    *s              = stat;
+    rt_hw_interrupt_enable(level);
+}
+
+void lv_draw_sc32_dma_print(int (*print)(const char * fmt, ...)) {
+    lv_draw_sc32_dma_stat s;
+    lv_draw_sc32_dma_info(&s);
+
+    print("%6s %6s %8s %6s %6s %8s\n", "fills", "copies", "pixels", "rows", "waits",
+          "halfword");
+    print("%6u %6u %8u %6u %6u %8u\n", s.fills, s.copies, s.pixels, s.rows, s.waits,
+          s.halfword);
+}
+
+#ifndef LV_DRAW_SC32_DMA_HOST
+
+/********** 板上的MSH命令 **********/
+
+/**
+ * @brief lvdma：查看交给DMA的填充与贴图。
+ * @param argc 参数个数。
+ * @param argv
+ * @retval
+ * @warning
+ * @note
+ */
+static void lvdma(int argc, char ** argv) {
+    lv_draw_sc32_dma_print(rt_kprintf);
+}
+MSH_CMD_EXPORT(lvdma, lvgl fills and copies done by dma);
+
+#endif  // LV_DRAW_SC32_DMA_HOST
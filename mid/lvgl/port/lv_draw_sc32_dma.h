@@ -0,0 +1,120 @@
+#ifndef LV_DRAW_SC32_DMA_H
+#define LV_DRAW_SC32_DMA_H
+
+/**
+ * @brief 这是用SC32的DMA通道加速LVGL绘制的模块。
+ * @details 在lv_port_blend的基础上再替换一次blend：不透明的矩形填充，
+ * 以及源图位于Flash、不带蒙版的不透明贴图，交给一个空闲的DMA通道做内存到内存搬运，
+ * 启动后立即返回；其余情况仍由lv_port_blend在CPU上完成。
+ * blend开头与刷新到屏幕之前都会等待上一次传输完成，
+ * 所以DMA搬运像素的同时，CPU可以继续解码字形、计算蒙版等不写缓冲区的工作。
+ * 行宽等于缓冲区宽度时整块一次传输，否则在完成中断中逐行续传。
+ * 显示驱动把draw_ctx_init设为lv_draw_sc32_dma_ctx_init、draw_ctx_size设为
+ * sizeof(lv_draw_sc32_dma_ctx_t)即可启用。
+ * @file lv_draw_sc32_dma.h
+ * @author proyrb
+ * @date 2025/8/20
+ * @note 源图在RAM中的贴图不用DMA：LVGL在blend返回后可能立即改写或释放这块内存。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <lv_port_blend.h>
+
+/********** 配置模块行为 **********/
+
+#ifdef LV_DRAW_SC32_DMA_C
+
+/* 配置DMA：DMA0给屏幕、DMA1与DMA2给外部Flash，剩下的DMA3用于绘制 */
+#    define USE_DMA DMA3
+
+// 少于这么多像素时直接用CPU：启动DMA与等待完成的开销比搬运本身还大
+#    define DMA_MIN_PX 256
+
+#endif  // LV_DRAW_SC32_DMA_C
+
+/********** 绘制上下文 **********/
+
+typedef lv_draw_sw_ctx_t lv_draw_sc32_dma_ctx_t;
+
+/********** 统计结果 **********/
+
+typedef struct {
+    uint32_t fills;     // 交给DMA的填充次数
+    uint32_t copies;    // 交给DMA的贴图次数
+    uint32_t pixels;    // 交给DMA的像素数
+    uint32_t rows;      // 在中断中续传的行数
+    uint32_t waits;     // 等待时DMA仍未完成的次数
+    uint32_t halfword;  // 因为首地址或长度没有对齐到字而按半字传输的次数
+} lv_draw_sc32_dma_stat;
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 初始化模块。
+ * @param
+ * @retval RT_EOK：成功。
+ * @warning DMA通道本身在board.c中初始化；使用INIT_COMPONENT_EXPORT宏自动初始化。
+ * @note
+ */
+extern int lv_draw_sc32_dma_init(void);
+
+/**
+ * @brief 初始化绘制上下文：先按lv_port_blend_init_ctx初始化，再接管blend与wait_for_finish。
+ * @param drv 显示驱动。
+ * @param draw_ctx 绘制上下文，大小为sizeof(lv_draw_sc32_dma_ctx_t)。
+ * @retval
+ * @warning
+ * @note 赋给lv_disp_drv_t的draw_ctx_init。
+ */
+extern void lv_draw_sc32_dma_ctx_init(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx);
+
+/**
+ * @brief lv_draw_sw_ctx_t的blend回调。
+ * @param draw_ctx 绘制上下文。
+ * @param dsc 混合参数。
+ * @retval
+ * @warning 只在LVGL线程中调用。
+ * @note 先等待上一次DMA完成：lv_port_cull等包装blend的模块可能连续调用它，
+ * 不经过lv_draw_sw_blend中的等待。
+ */
+extern void lv_draw_sc32_dma_blend(lv_draw_ctx_t *                draw_ctx,
+                                   const lv_draw_sw_blend_dsc_t * dsc);
+
+/**
+ * @brief lv_draw_ctx_t的wait_for_finish回调：等待正在进行的DMA完成。
+ * @param draw_ctx 绘制上下文。
+ * @retval
+ * @warning 只在LVGL线程中调用。
+ * @note 没有正在进行的DMA时立即返回。
+ */
+extern void lv_draw_sc32_dma_wait_for_finish(lv_draw_ctx_t * draw_ctx);
+
+/**
+ * @brief DMA完成中断的处理：还有剩余的行时续传，否则通知等待者。
+ * @param
+ * @retval
+ * @warning 在DMA3_IRQHandler中调用，调用前清除中断标志。
+ * @note
+ */
+extern void lv_draw_sc32_dma_irq(void);
+
+/**
+ * @brief 取得统计。
+ * @param stat 统计结果。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void lv_draw_sc32_dma_info(lv_draw_sc32_dma_stat * const stat);
+
+/**
+ * @brief 打印统计。
+ * @param print 输出函数。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void lv_draw_sc32_dma_print(int (*print)(const char * fmt, ...));
+
+#endif  // LV_DRAW_SC32_DMA_H
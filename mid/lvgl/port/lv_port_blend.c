@@ -0,0 +1,419 @@
+#define LV_PORT_BLEND_C
+
+#include <lv_port_blend.h>
+
+#ifndef LV_PORT_BLEND_HOST
+#    include <sc32_conf.h>
+#    include <rtthread.h>
+#    include <string.h>
+#else
+#    include <stdlib.h>
+#    include <string.h>
+#    define rt_malloc malloc
+#    define rt_free   free
+#endif  // LV_PORT_BLEND_HOST
+
+#if (LV_COLOR_DEPTH != 16) || LV_COLOR_16_SWAP || LV_COLOR_MIX_ROUND_OFS
+#    error "lv_port_blend needs RGB565 without swap and LV_COLOR_MIX_ROUND_OFS 0"
+#endif
+
+// 展开后的像素：绿色移到高半字，红蓝留在低半字，各分量上方留出乘以32的空间
+#define MIX_MASK 0x07E0F81FU
+
+// lv_color_mix把0到255的透明度舍入到0到32
+#define MIX_OF(opa) (((uint32_t)(opa) + 4) >> 3)
+
+/********** 单个像素 **********/
+
+static inline uint32_t _spread(const uint32_t c) {
+    return (c | (c << 16)) & MIX_MASK;
+}
+
+/**
+ * @brief 与lv_color_mix相同的混合。
+ * @param fg 展开后的前景色。
+ * @param bg 背景色。
+ * @param mix 1到31；0与32分别等于背景色与前景色，由调用者处理。
+ * @retval 混合结果。
+ * @warning
+ * @note
+ */
+static inline uint32_t _mix(const uint32_t fg, const uint32_t bg, const uint32_t mix) {
+    const uint32_t bg_s = _spread(bg);
+    const uint32_t r    = ((((fg - bg_s) * mix) >> 5) + bg_s) & MIX_MASK;
+    return (r | (r >> 16)) & 0xFFFF;
+}
+
+/**
+ * @brief 按比例混合一个像素。
+ * @param fg 展开后的前景色。
+ * @param c 前景色。
+ * @param bg 背景色。
+ * @param mix 0到32。
+ * @retval 混合结果。
+ * @warning
+ * @note
+ */
+static inline uint32_t _mix_px(const uint32_t fg, const uint32_t c, const uint32_t bg,
+                               const uint32_t mix) {
+    if (mix == 0) {
+        return bg;
+    }
+    return (mix >= 32) ? c : _mix(fg, bg, mix);
+}
+
+/********** 填充 **********/
+
+static LV_ATTRIBUTE_FAST_MEM void _fill_row(uint16_t * d, const uint16_t c, int32_t w) {
+    if (((uintptr_t)d & 2) && (w > 0)) {
+        *d++ = c;
+        --w;
+    }
+
+    const uint32_t c32 = c | ((uint32_t)c << 16);
+    uint32_t *     d32 = (uint32_t *)d;
+    for (; w >= 8; w -= 8) {
+        d32[0] = c32;
+        d32[1] = c32;
+        d32[2] = c32;
+        d32[3] = c32;
+        d32 += 4;
+    }
+    for (; w >= 2; w -= 2) {
+        *d32++ = c32;
+    }
+    if (w > 0) {
+        *(uint16_t *)d32 = c;
+    }
+}
+
+/**
+ * @brief 无蒙版、带透明度的填充。
+ * @param
+ * @retval
+ * @warning 为了与fill_normal逐位相同，沿用它的两处特例：
+ * 透明度先舍入到8的倍数（252会回绕成0），用预乘与LV_UDIV255计算；
+ * 缓存的初值是用原透明度与黑色lv_color_mix的结果，直到遇到第一个非黑色像素。
+ * @note 连续两个像素都等于上一个背景色时，直接写入缓存的一对结果。
+ */
+static LV_ATTRIBUTE_FAST_MEM void _fill_opa(uint16_t * dest, const int32_t stride,
+                                            const int32_t w, const int32_t h,
+                                            const uint16_t c, const lv_opa_t opa) {
+    const lv_opa_t opa8   = (lv_opa_t)(MIX_OF(opa) << 3);
+    const uint32_t inv    = 255 - opa8;
+    const uint32_t pre[3] = {(uint32_t)(c >> 11) * opa8,
+                             (uint32_t)((c >> 5) & 0x3F) * opa8,
+                             (uint32_t)(c & 0x1F) * opa8};
+
+    uint32_t last = 0;
+    uint32_t res  = _mix_px(_spread(c), c, 0, MIX_OF(opa));
+
+#define FILL_OPA_PX(px)                                                                  \
+    if ((px) != last) {                                                                  \
+        last = (px);                                                                     \
+        res  = (LV_UDIV255(pre[0] + (last >> 11) * inv) << 11) |                         \
+              (LV_UDIV255(pre[1] + ((last >> 5) & 0x3F) * inv) << 5) |                  \
+              LV_UDIV255(pre[2] + (last & 0x1F) * inv);                                  \
+    }
+
+    for (int32_t y = 0; y < h; ++y) {
+        uint16_t * d = dest;
+        int32_t    x = w;
+        if (((uintptr_t)d & 2) && (x > 0)) {
+            FILL_OPA_PX(*d)
+            *d++ = res;
+            --x;
+        }
+        uint32_t * d32 = (uint32_t *)d;
+        for (; x >= 2; x -= 2) {
+            const uint32_t pair = *d32;
+            if (pair != (last | (last << 16))) {
+                FILL_OPA_PX(pair & 0xFFFF)
+                const uint32_t lo = res;
+                FILL_OPA_PX(pair >> 16)
+                *d32++ = lo | (res << 16);
+            } else {
+                *d32++ = res | (res << 16);
+            }
+        }
+        if (x > 0) {
+            d = (uint16_t *)d32;
+            FILL_OPA_PX(*d)
+            *d = res;
+        }
+        dest += stride;
+    }
+
+#undef FILL_OPA_PX
+}
+
+/********** 贴图 **********/
+
+/**
+ * @brief 拷贝一行。
+ * @param
+ * @retval
+ * @warning 源与目标相差半个字时，最后一次读取的对齐字可能比源多出一个像素。
+ * @note 对齐到目标的字边界后，源也对齐时按字拷贝，否则用相邻两个对齐字拼出一个字。
+ */
+static LV_ATTRIBUTE_FAST_MEM void _copy_row(uint16_t * d, const uint16_t * s, int32_t w) {
+    if (((uintptr_t)d & 2) && (w > 0)) {
+        *d++ = *s++;
+        --w;
+    }
+
+    uint32_t * d32 = (uint32_t *)d;
+    if (((uintptr_t)s & 2) == 0) {
+        const uint32_t * s32 = (const uint32_t *)s;
+        for (; w >= 8; w -= 8) {
+            d32[0] = s32[0];
+            d32[1] = s32[1];
+            d32[2] = s32[2];
+            d32[3] = s32[3];
+            d32 += 4;
+            s32 += 4;
+        }
+        for (; w >= 2; w -= 2) {
+            *d32++ = *s32++;
+        }
+        if (w > 0) {
+            *(uint16_t *)d32 = *(const uint16_t *)s32;
+        }
+    } else {
+        /* cur的高半字是下一个要输出的像素 */
+        const uint32_t * s32 = (const uint32_t *)(s - 1);
+        uint32_t         cur = *s32++;
+        for (; w >= 4; w -= 4) {
+            const uint32_t n0 = s32[0];
+            const uint32_t n1 = s32[1];
+            d32[0]            = (cur >> 16) | (n0 << 16);
+            d32[1]            = (n0 >> 16) | (n1 << 16);
+            cur               = n1;
+            d32 += 2;
+            s32 += 2;
+        }
+        for (; w >= 2; w -= 2) {
+            const uint32_t n = *s32++;
+            *d32++           = (cur >> 16) | (n << 16);
+            cur              = n;
+        }
+        if (w > 0) {
+            *(uint16_t *)d32 = cur >> 16;
+        }
+    }
+}
+
+/********** 导出的函数 **********/
+
+void lv_port_blend_init_ctx(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx) {
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+    ((lv_draw_sw_ctx_t *)draw_ctx)->blend = lv_port_blend;
+}
+
+void LV_ATTRIBUTE_FAST_MEM lv_port_blend(lv_draw_ctx_t *                draw_ctx,
+                                         const lv_draw_sw_blend_dsc_t * dsc) {
+    lv_disp_t * const disp = _lv_refr_get_disp_refreshing();
+    if ((disp->driver->set_px_cb != NULL) || disp->driver->screen_transp ||
+        (dsc->blend_mode != LV_BLEND_MODE_NORMAL)) {
+        lv_draw_sw_blend_basic(draw_ctx, dsc);
+        return;
+    }
+    /* 带蒙版的混合与带透明度的贴图在主机上测得没有比LVGL快，同样交给它 */
+    if (((dsc->mask_buf != NULL) && (dsc->mask_res != LV_DRAW_MASK_RES_FULL_COVER)) ||
+        ((dsc->src_buf != NULL) && (dsc->opa < LV_OPA_MAX))) {
+        lv_draw_sw_blend_basic(draw_ctx, dsc);
+        return;
+    }
+
+    /* 以下与lv_draw_sw_blend_basic的前半部分相同，蒙版只剩全覆盖一种情况，可以忽略 */
+    lv_area_t area;
+    if (!_lv_area_intersect(&area, dsc->blend_area, draw_ctx->clip_area)) {
+        return;
+    }
+
+    const int32_t stride = lv_area_get_width(draw_ctx->buf_area);
+    const int32_t w      = lv_area_get_width(&area);
+    const int32_t h      = lv_area_get_height(&area);
+    uint16_t *    dest   = (uint16_t *)draw_ctx->buf;
+    const lv_area_t * const buf_area = draw_ctx->buf_area;
+    dest += stride * (area.y1 - buf_area->y1) + (area.x1 - buf_area->x1);
+
+    if (dsc->src_buf == NULL) {
+        const uint16_t c = dsc->color.full;
+        if (dsc->opa >= LV_OPA_MAX) {
+            for (int32_t y = 0; y < h; ++y, dest += stride) {
+                _fill_row(dest, c, w);
+            }
+        } else {
+            _fill_opa(dest, stride, w, h, c, dsc->opa);
+        }
+        return;
+    }
+
+    const int32_t    sstride = lv_area_get_width(dsc->blend_area);
+    const uint16_t * src     = (const uint16_t *)dsc->src_buf;
+    src += sstride * (area.y1 - dsc->blend_area->y1) + (area.x1 - dsc->blend_area->x1);
+    for (int32_t y = 0; y < h; ++y, dest += stride, src += sstride) {
+        _copy_row(dest, src, w);
+    }
+}
+
+/********** 测试 **********/
+
+typedef struct {
+    const char * name;    // 名称
+    uint8_t      src;     // 0：填充；1：贴图；2：贴图且源比目标错开一个像素
+    uint8_t      masked;  // 是否带蒙版
+    lv_opa_t     opa;     // 整体透明度
+} bench_case;
+
+static const bench_case bench_cases[] = {
+    {"fill", 0, 0, LV_OPA_COVER},     {"fill opa", 0, 0, LV_OPA_50},
+    {"fill mask", 0, 1, LV_OPA_COVER}, {"fill mask opa", 0, 1, LV_OPA_70},
+    {"copy", 1, 0, LV_OPA_COVER},     {"copy odd", 2, 0, LV_OPA_COVER},
+    {"map opa", 1, 0, LV_OPA_50},      {"map mask", 1, 1, LV_OPA_COVER},
+    {"map mask opa", 1, 1, LV_OPA_70},
+};
+
+/**
+ * @brief 用同样的参数连续混合BENCH_LOOP次。
+ * @param
+ * @retval 耗时。
+ * @warning
+ * @note
+ */
+typedef void (*bench_blend)(lv_draw_ctx_t *, const lv_draw_sw_blend_dsc_t *);
+
+static uint32_t _bench_once(const bench_blend                    blend,
+                            lv_draw_ctx_t * const                ctx,
+                            const lv_draw_sw_blend_dsc_t * const dsc,
+                            uint32_t (*now)(void)) {
+    const uint32_t start = now();
+    for (uint32_t i = 0; i < BENCH_LOOP; ++i) {
+        blend(ctx, dsc);
+    }
+    return now() - start;
+}
+
+static void _bench_fill(uint16_t * const ref, uint16_t * const port, uint16_t * const src,
+                        lv_opa_t * const mask) {
+    for (uint32_t y = 0; y < BENCH_H; ++y) {
+        for (uint32_t x = 0; x < BENCH_W; ++x) {
+            const uint32_t i = y * BENCH_W + x;
+            ref[i] = port[i] = (uint16_t)((x * 7 + y * 13) * 0x0821);
+            src[i]           = (uint16_t)(x * 0x0841 + y * 0x1003);
+            /* 像抗锯齿边缘一样混合0、255与中间值 */
+            mask[i] = ((x & 15) < 4) ? 0 : ((x & 15) < 12) ? 255 : (uint8_t)(x * 29 + y);
+        }
+    }
+    src[BENCH_W * BENCH_H] = 0;
+}
+
+int lv_port_blend_bench(int (*print)(const char * fmt, ...), uint32_t (*now)(void),
+                        const char * const unit) {
+    const uint32_t px    = BENCH_W * BENCH_H;
+    uint16_t *     ref   = rt_malloc(px * 2);
+    uint16_t *     port  = rt_malloc(px * 2);
+    uint16_t *     src   = rt_malloc(px * 2 + 4);
+    lv_opa_t *     mask  = rt_malloc(px);
+    int            ret   = -1;
+    lv_disp_t *    saved = _lv_refr_get_disp_refreshing();
+
+    if ((ref == NULL) || (port == NULL) || (src == NULL) || (mask == NULL)) {
+        print("blendbench: no memory\n");
+        goto out;
+    }
+
+    /* 没有set_px_cb、不透明屏幕、开启抗锯齿的显示器 */
+    static lv_disp_drv_t drv;
+    static lv_disp_t     disp;
+    lv_memset_00(&drv, sizeof(drv));
+    lv_memset_00(&disp, sizeof(disp));
+    drv.antialiasing = 1;
+    disp.driver      = &drv;
+    _lv_refr_set_disp_refreshing(&disp);
+
+    lv_area_t     area = {0, 0, BENCH_W - 1, BENCH_H - 1};
+    lv_draw_ctx_t ctx;
+    lv_memset_00(&ctx, sizeof(ctx));
+    ctx.buf_area  = &area;
+    ctx.clip_area = &area;
+
+    print("%-14s %8s %8s %7s  (%s/px x100, %ux%u)\n", "case", "lvgl", "port", "speedup",
+          unit, BENCH_W, BENCH_H);
+    for (uint32_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); ++i) {
+        const bench_case * const bc = &bench_cases[i];
+        _bench_fill(ref, port, src, mask);
+
+        lv_draw_sw_blend_dsc_t dsc;
+        lv_memset_00(&dsc, sizeof(dsc));
+        dsc.blend_area = &area;
+        dsc.mask_area  = &area;
+        dsc.src_buf    = (bc->src == 0) ? NULL : (const lv_color_t *)src + (bc->src - 1);
+        dsc.color.full = 0x7BEF;
+        dsc.mask_buf   = bc->masked ? mask : NULL;
+        dsc.mask_res   = LV_DRAW_MASK_RES_FULL_COVER;
+        dsc.opa        = bc->opa;
+        dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+        if (bc->masked) {
+            dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+        }
+
+        ctx.buf             = ref;
+        const uint32_t t_lv = _bench_once(lv_draw_sw_blend_basic, &ctx, &dsc, now);
+        ctx.buf             = port;
+        const uint32_t t_pt = _bench_once(lv_port_blend, &ctx, &dsc, now);
+
+        const uint32_t n     = px * BENCH_LOOP;
+        const uint32_t ratio = (t_pt > 0) ? (uint32_t)((uint64_t)t_lv * 100 / t_pt) : 0;
+        const uint32_t px_lv = (uint32_t)((uint64_t)t_lv * 100 / n);
+        const uint32_t px_pt = (uint32_t)((uint64_t)t_pt * 100 / n);
+        print("%-14s %8u %8u %4u.%02u%s\n", bc->name, px_lv, px_pt, ratio / 100,
+              ratio % 100, (memcmp(ref, port, px * 2) == 0) ? "" : "  DIFF");
+    }
+    ret = 0;
+
+out:
+    _lv_refr_set_disp_refreshing(saved);
+    rt_free(ref);
+    rt_free(port);
+    rt_free(src);
+    rt_free(mask);
+    return ret;
+}
+
+/********** 板上的MSH命令 **********/
+
+#ifndef LV_PORT_BLEND_HOST
+
+/**
+ * @brief 取得HCLK周期数。
+ * @param
+ * @retval 周期数，允许回绕。
+ * @warning
+ * @note SysTick以HCLK/8计数，分辨率为8个周期。
+ */
+static uint32_t _bench_cycles(void) {
+    rt_tick_t tick;
+    uint32_t  val;
+    do {
+        tick = rt_tick_get();
+        val  = SysTick->VAL;
+    } while (tick != rt_tick_get());
+    return (tick * (SysTick->LOAD + 1) + (SysTick->LOAD - val)) * 8;
+}
+
+/**
+ * @brief blendbench：比较LVGL与lv_port_blend的混合耗时。
+ * @param argc 参数个数。
+ * @param argv
+ * @retval
+ * @warning 不能与LVGL的刷新同时运行。
+ * @note
+ */
+static void blendbench(int argc, char ** argv) {
+    lv_port_blend_bench(rt_kprintf, _bench_cycles, "cyc");
+}
+MSH_CMD_EXPORT(blendbench, RGB565 blend cycles per pixel);
+
+#endif  // LV_PORT_BLEND_HOST
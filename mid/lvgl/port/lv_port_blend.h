@@ -0,0 +1,73 @@
+#ifndef LV_PORT_BLEND_H
+#define LV_PORT_BLEND_H
+
+/**
+ * @brief 这是LVGL软件混合在RGB565上的字长优化模块。
+ * @details lv_draw_sw_blend_basic逐个lv_color_t处理填充、拷贝与透明度混合；
+ * 这里每次读写一个32位字（两个像素），混合时把像素展开成0x07E0F81F的形式，
+ * 一次乘法同时算出红、绿、蓝三个分量，前景色只展开一次。
+ * 源与目标相差半个字时，拷贝用两次对齐读取拼出一个字，不再退化为逐字节拷贝。
+ * 结果与LVGL的参考实现逐位相同（见tool/blend_host.c），包括两者在舍入上的特例。
+ * 显示驱动把draw_ctx_init设为lv_port_blend_init_ctx即可启用；
+ * set_px_cb、带透明通道的屏幕、非NORMAL混合模式、带蒙版的混合与带透明度的贴图
+ * 仍交给lv_draw_sw_blend_basic：后两者的字长实现在主机上测得比LVGL慢，没有保留。
+ * @file lv_port_blend.h
+ * @author proyrb
+ * @date 2025/8/19
+ * @note 核函数带有LV_ATTRIBUTE_FAST_MEM，需要放进RAM执行时在lv_conf.h中定义它。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <lvgl.h>
+#include <src/draw/sw/lv_draw_sw.h>
+
+/********** 配置模块行为 **********/
+
+#ifdef LV_PORT_BLEND_C
+
+// 板上测试区域的宽与高：源、目标、蒙版共需约5KB堆内存
+#    define BENCH_W 120
+#    define BENCH_H 8
+
+// 每项测试重复的次数
+#    define BENCH_LOOP 16
+
+#endif  // LV_PORT_BLEND_C
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 初始化软件绘制上下文，并把混合换成lv_port_blend。
+ * @param drv 显示驱动。
+ * @param draw_ctx 绘制上下文，大小为draw_ctx_size（sizeof(lv_draw_sw_ctx_t)）。
+ * @retval
+ * @warning
+ * @note 赋给lv_disp_drv_t的draw_ctx_init。
+ */
+extern void lv_port_blend_init_ctx(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx);
+
+/**
+ * @brief lv_draw_sw_ctx_t的blend回调。
+ * @param draw_ctx 绘制上下文。
+ * @param dsc 混合参数。
+ * @retval
+ * @warning 只在LVGL线程中调用。
+ * @note
+ */
+extern void lv_port_blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc);
+
+/**
+ * @brief 比较lv_draw_sw_blend_basic与lv_port_blend在各种情况下的耗时。
+ * @param print 输出函数。
+ * @param now 计时器，允许回绕。
+ * @param unit 计时器单位的名称，例如"cyc"。
+ * @retval 0：完成。
+ * @retval -1：内存不足。
+ * @warning 不能与LVGL的刷新同时运行：测试期间临时替换正在刷新的显示器。
+ * @note 同时检查两者的结果是否相同，不同时在该项后面打印"DIFF"。
+ */
+extern int lv_port_blend_bench(int (*print)(const char * fmt, ...), uint32_t (*now)(void),
+                               const char * const unit);
+
+#endif  // LV_PORT_BLEND_H
@@ -0,0 +1,300 @@
+#define LV_PORT_CULL_C
+
+#include <lv_port_cull.h>
+#include <lv_port_task.h>
+#include <lvgl.h>
+#include <src/draw/sw/lv_draw_sw.h>
+#include <rtthread.h>
+
+#if LV_PORT_CULL
+
+static lv_area_t         occ[CULL_RECT_CNT];  // 当前对象的遮挡物
+static uint32_t          occ_cnt = 0;         // 为0表示不在剔除阶段
+static int               enabled = 1;
+static lv_port_cull_stat stat;                // 只在LVGL线程中修改
+static uint64_t          frame_written = 0;   // 一帧开始时的written
+static uint64_t          frame_flushed = 0;   // 一帧开始时的flushed
+
+/* 被替换的blend */
+static void (*orig_blend)(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc);
+static const lv_draw_ctx_t * wrapped = NULL;  // 已经换过blend的绘制上下文
+
+/********** 分块混合 **********/
+
+/**
+ * @brief 从一块区域中扣掉一个矩形，剩下的部分最多分成上、下、左、右4块。
+ * @param piece 区域。
+ * @param hole 扣掉的矩形。
+ * @param out 剩下的部分。
+ * @retval 剩下的块数。
+ * @warning
+ * @note 两者不相交时原样返回1块。
+ */
+static uint32_t _subtract(const lv_area_t * const piece,
+                          const lv_area_t * const hole,
+                          lv_area_t * const       out) {
+    lv_area_t common;
+    if (!_lv_area_intersect(&common, piece, hole)) {
+        out[0] = *piece;
+        return 1;
+    }
+
+    uint32_t cnt = 0;
+    if (piece->y1 < common.y1) {
+        lv_area_set(&out[cnt++], piece->x1, piece->y1, piece->x2, common.y1 - 1);
+    }
+    if (common.y2 < piece->y2) {
+        lv_area_set(&out[cnt++], piece->x1, common.y2 + 1, piece->x2, piece->y2);
+    }
+    if (piece->x1 < common.x1) {
+        lv_area_set(&out[cnt++], piece->x1, common.y1, common.x1 - 1, common.y2);
+    }
+    if (common.x2 < piece->x2) {
+        lv_area_set(&out[cnt++], common.x2 + 1, common.y1, piece->x2, common.y2);
+    }
+    return cnt;
+}
+
+/**
+ * @brief 替换后的blend：剔除阶段中不带蒙版的填充扣掉遮挡物再分块混合。
+ * @param draw_ctx 绘制上下文。
+ * @param dsc 混合参数。
+ * @retval
+ * @warning
+ * @note 块数超过CULL_PIECE_CNT时整块混合，结果不变，只是没有省下像素；
+ * 只在LVGL线程中调用，分块用静态数组，不占LVGL线程的栈。
+ */
+static void _blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc) {
+    lv_area_t area;
+    if (!_lv_area_intersect(&area, dsc->blend_area, draw_ctx->clip_area)) {
+        return;
+    }
+    const uint32_t size = lv_area_get_size(&area);
+
+    if ((occ_cnt == 0) || !enabled || (dsc->src_buf != NULL) || (dsc->mask_buf != NULL)) {
+        stat.written += size;
+        orig_blend(draw_ctx, dsc);
+        return;
+    }
+
+    /* 两组轮流使用：每扣掉一个遮挡物，上一组的每块最多变成4块 */
+    static lv_area_t piece[2][CULL_PIECE_CNT + 4];
+    uint32_t         cnt = 1;
+    uint32_t         cur = 0;
+    piece[0][0]          = area;
+    for (uint32_t i = 0; (i < occ_cnt) && (cnt > 0); ++i) {
+        uint32_t next = 0;
+        for (uint32_t j = 0; (j < cnt) && (next <= CULL_PIECE_CNT); ++j) {
+            next += _subtract(&piece[cur][j], &occ[i], &piece[cur ^ 1][next]);
+        }
+        if (next > CULL_PIECE_CNT) {
+            ++stat.overflows;
+            stat.written += size;
+            orig_blend(draw_ctx, dsc);
+            return;
+        }
+        cnt = next;
+        cur ^= 1;
+    }
+
+    if ((cnt == 1) && (lv_area_get_size(&piece[cur][0]) == size)) {
+        stat.written += size;
+        orig_blend(draw_ctx, dsc);
+        return;
+    }
+
+    ++stat.splits;
+    lv_draw_sw_blend_dsc_t part = *dsc;
+    uint32_t               left = 0;
+    for (uint32_t j = 0; j < cnt; ++j) {
+        /* 与lv_draw_sw_blend相同，每次混合之前等待上一块：DMA的blend启动后立即返回 */
+        if (j > 0) {
+            lv_draw_wait_for_finish(draw_ctx);
+        }
+        part.blend_area = &piece[cur][j];
+        left += lv_area_get_size(&piece[cur][j]);
+        orig_blend(draw_ctx, &part);
+    }
+    stat.written += left;
+    stat.culled += size - left;
+}
+
+/**
+ * @brief 把绘制上下文的blend换成剔除的版本。
+ * @param disp 显示。
+ * @retval
+ * @warning
+ * @note 只换第一个显示的绘制上下文，不是软件绘制上下文时什么也不做。
+ */
+static void _wrap(lv_disp_t * const disp) {
+    lv_draw_sw_ctx_t * const ctx = (lv_draw_sw_ctx_t *)disp->driver->draw_ctx;
+    if ((wrapped != NULL) || (ctx == NULL) ||
+        (disp->driver->draw_ctx_size < sizeof(lv_draw_sw_ctx_t))) {
+        return;
+    }
+    orig_blend = ctx->blend;
+    ctx->blend = _blend;
+    wrapped    = &ctx->base_draw;
+}
+
+/********** 找遮挡物 **********/
+
+/**
+ * @brief 记下一个遮挡物，满了以后替换面积最小的一个。
+ * @param area 遮挡物。
+ * @retval
+ * @warning
+ * @note
+ */
+static void _occ_add(const lv_area_t * const area) {
+    ++stat.occluders;
+    if (occ_cnt < CULL_RECT_CNT) {
+        occ[occ_cnt++] = *area;
+        return;
+    }
+    uint32_t least = 0;
+    for (uint32_t i = 1; i < CULL_RECT_CNT; ++i) {
+        least = (lv_area_get_size(&occ[i]) < lv_area_get_size(&occ[least])) ? i : least;
+    }
+    if (lv_area_get_size(area) > lv_area_get_size(&occ[least])) {
+        occ[least] = *area;
+    }
+}
+
+/********** lv_refr.c的钩子 **********/
+
+void lv_port_cull_frame_begin(lv_disp_t * disp) {
+    _wrap(disp);
+    ++stat.frames;
+    frame_written = stat.written;
+    frame_flushed = stat.flushed;
+}
+
+void lv_port_cull_frame_end(void) {
+    const uint64_t flushed = stat.flushed - frame_flushed;
+    if (flushed > 0) {
+        stat.last = (uint32_t)(100 * (stat.written - frame_written) / flushed);
+    }
+    occ_cnt = 0;
+}
+
+void lv_port_cull_obj_begin(const lv_draw_ctx_t * draw_ctx, lv_obj_t * obj) {
+    /* 父对象的剔除阶段到第一个子对象开始绘制为止 */
+    occ_cnt = 0;
+
+    const uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    lv_area_t      region;
+    if ((child_cnt == 0) || lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN) ||
+        (_lv_obj_get_layer_type(obj) != LV_LAYER_TYPE_NONE) ||
+        lv_obj_get_style_clip_corner(obj, LV_PART_MAIN) ||
+        !_lv_area_intersect(&region, draw_ctx->clip_area, &obj->coords)) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < child_cnt; ++i) {
+        lv_obj_t * const child = obj->spec_attr->children[i];
+        lv_area_t        area;
+        if (lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN) ||
+            (_lv_obj_get_layer_type(child) != LV_LAYER_TYPE_NONE) ||
+            !_lv_area_intersect(&area, &region, &child->coords) ||
+            (lv_area_get_size(&area) < CULL_MIN_PX)) {
+            continue;
+        }
+
+        lv_cover_check_info_t info;
+        info.res  = LV_COVER_RES_COVER;
+        info.area = &area;
+        lv_event_send(child, LV_EVENT_COVER_CHECK, &info);
+        if (info.res == LV_COVER_RES_COVER) {
+            _occ_add(&area);
+        }
+    }
+}
+
+void lv_port_cull_obj_end(void) {
+    occ_cnt = 0;
+}
+
+void lv_port_cull_flush(const uint32_t px) {
+    stat.flushed += px;
+}
+
+/********** 查看结果 **********/
+
+void lv_port_cull_enable(const int on) {
+    lv_port_task_lock(-1);
+    enabled = on;
+    lv_port_task_unlock();
+}
+
+void lv_port_cull_reset(void) {
+    lv_port_task_lock(-1);
+    lv_memset_00(&stat, sizeof(stat));
+    lv_port_task_unlock();
+}
+
+void lv_port_cull_info(lv_port_cull_stat * const s) {
+    lv_port_task_lock(-1);
+    *s = stat;
+    lv_port_task_unlock();
+}
+
+void lv_port_cull_print(int (*print)(const char * fmt, ...)) {
+    lv_port_cull_stat s;
+    lv_port_cull_info(&s);
+
+    /* 有剔除时，没有剔除的重绘倍数是(written + culled) / flushed */
+    const uint32_t over = (s.flushed == 0) ? 0 : (uint32_t)(100 * s.written / s.flushed);
+    const uint32_t base =
+        (s.flushed == 0) ? 0 : (uint32_t)(100 * (s.written + s.culled) / s.flushed);
+    print("%8s %10s %10s %10s %9s %8s %8s\n", "frames", "flushed_k", "written_k",
+          "culled_k", "occluders", "splits", "overflow");
+    print("%8u %10u %10u %10u %9u %8u %8u\n", s.frames, (uint32_t)(s.flushed / 1000),
+          (uint32_t)(s.written / 1000), (uint32_t)(s.culled / 1000), s.occluders,
+          s.splits, s.overflows);
+    print("overdraw %u.%02ux (%u.%02ux without culling), ", over / 100, over % 100,
+          base / 100, base % 100);
+    print("last frame %u.%02ux, culling %s\n", s.last / 100, s.last % 100,
+          enabled ? "on" : "off");
+}
+
+#else
+
+void lv_port_cull_enable(const int on) {
+}
+
+void lv_port_cull_reset(void) {
+}
+
+void lv_port_cull_info(lv_port_cull_stat * const stat) {
+    lv_memset_00(stat, sizeof(*stat));
+}
+
+void lv_port_cull_print(int (*print)(const char * fmt, ...)) {
+    print("lv_port_cull disabled\n");
+}
+
+#endif  // LV_PORT_CULL
+
+/********** 板上的MSH命令 **********/
+
+/**
+ * @brief lvcull [on|off|reset]：查看重绘倍数与剔除的像素数。
+ * @param argc 参数个数。
+ * @param argv on、off：打开、关闭剔除；reset：清空统计。
+ * @retval
+ * @warning
+ * @note
+ */
+static void lvcull(int argc, char ** argv) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "reset") == 0) {
+            lv_port_cull_reset();
+        } else {
+            lv_port_cull_enable(strcmp(argv[1], "off") != 0);
+        }
+        return;
+    }
+    lv_port_cull_print(rt_kprintf);
+}
+MSH_CMD_EXPORT(lvcull, lvgl overdraw and occlusion culling : lvcull[on | off | reset]);
@@ -0,0 +1,126 @@
+#ifndef LV_PORT_CULL_H
+#define LV_PORT_CULL_H
+
+/**
+ * @brief 这是LVGL的遮挡剔除与重绘统计模块。
+ * @details LVGL的lv_refr_get_top_obj只在一个对象完全盖住整个刷新区域时跳过下面的对象，
+ * 嵌套的面板只盖住父对象的一部分时，父对象的背景照样整块填充，随后又被子对象覆盖。
+ * lv_refr.c每绘制一个对象之前，先对它的子对象发送LV_EVENT_COVER_CHECK，
+ * 找出不透明地盖住一块矩形的子对象作为遮挡物；从此刻到第一个子对象开始绘制，
+ * 正好是父对象绘制自身（LV_EVENT_DRAW_MAIN）的阶段，这期间不带蒙版的填充
+ * 扣掉遮挡物后分成几块分别混合，被盖住的像素不再写入。
+ * 同时统计混合写入的像素数与送到屏幕的像素数，两者之比就是重绘倍数。
+ * 板上通过MSH命令lvcull查看，也可以临时关闭剔除来对比。
+ * @file lv_port_cull.h
+ * @author proyrb
+ * @date 2025/8/21
+ * @note 贴图、文字等带源图或蒙版的混合不剔除；使用图层或者clip_corner的对象不找遮挡物。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <stdint.h>
+
+/********** 配置模块行为 **********/
+
+// 是否启用：0表示钩子为空，不剔除也不统计
+#define LV_PORT_CULL 1
+
+#ifdef LV_PORT_CULL_C
+
+// 每个对象最多记住的遮挡物个数，多出来的替换掉面积最小的一个
+#    define CULL_RECT_CNT 4
+
+// 扣掉遮挡物后最多分成的块数，超出时放弃剔除，整块混合
+#    define CULL_PIECE_CNT 12
+
+// 面积小于这么多像素的子对象不作为遮挡物：分块混合的开销比省下的还多
+#    define CULL_MIN_PX 256
+
+#endif  // LV_PORT_CULL_C
+
+/********** 统计结果 **********/
+
+typedef struct {
+    uint64_t flushed;    // 送到屏幕的像素数
+    uint64_t written;    // 混合写入的像素数，包括图层缓冲区
+    uint64_t culled;     // 因为被遮挡而没有写入的像素数
+    uint32_t frames;     // 渲染的帧数
+    uint32_t occluders;  // 找到的遮挡物个数
+    uint32_t splits;     // 分块混合的填充次数
+    uint32_t overflows;  // 分块过多而放弃剔除的次数
+    uint32_t last;       // 最近一帧的重绘倍数，乘以100
+} lv_port_cull_stat;
+
+/********** 导出的函数 **********/
+
+#if LV_PORT_CULL
+
+struct _lv_disp_t;
+struct _lv_draw_ctx_t;
+struct _lv_obj_t;
+
+/**
+ * @brief lv_refr.c的钩子，经由lv_port_refr.h调用。
+ * @param disp 正在刷新的显示。
+ * @param draw_ctx 绘制上下文，clip_area是这个对象的裁剪区域。
+ * @param obj 将要绘制的对象。
+ * @param px 送到屏幕的像素数。
+ * @retval
+ * @warning 只能由lv_refr.c调用。
+ * @note
+ */
+extern void lv_port_cull_frame_begin(struct _lv_disp_t * disp);
+extern void lv_port_cull_frame_end(void);
+extern void lv_port_cull_obj_begin(const struct _lv_draw_ctx_t * draw_ctx,
+                                   struct _lv_obj_t *             obj);
+extern void lv_port_cull_obj_end(void);
+extern void lv_port_cull_flush(const uint32_t px);
+
+#else
+
+#    define lv_port_cull_frame_begin(disp)        ((void)0)
+#    define lv_port_cull_frame_end()              ((void)0)
+#    define lv_port_cull_obj_begin(draw_ctx, obj) ((void)0)
+#    define lv_port_cull_obj_end()                ((void)0)
+#    define lv_port_cull_flush(px)                ((void)0)
+
+#endif  // LV_PORT_CULL
+
+/**
+ * @brief 打开或者关闭剔除，统计照常进行。
+ * @param on 非0表示打开。
+ * @retval
+ * @warning 线程安全。
+ * @note 默认打开。
+ */
+extern void lv_port_cull_enable(const int on);
+
+/**
+ * @brief 清空统计。
+ * @param
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lv_port_cull_reset(void);
+
+/**
+ * @brief 取得统计。
+ * @param stat 统计结果。
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lv_port_cull_info(lv_port_cull_stat * const stat);
+
+/**
+ * @brief 打印统计。
+ * @param print 输出函数。
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lv_port_cull_print(int (*print)(const char * fmt, ...));
+
+#endif  // LV_PORT_CULL_H
@@ -0,0 +1,258 @@
+#define LV_PORT_FONT_C
+
+#include <lv_port_font.h>
+#ifndef LV_PORT_FONT_HOST
+#    include <rtthread.h>
+#    include <rthw.h>
+#endif  // LV_PORT_FONT_HOST
+
+/* 打开的字体：一次申请，页表紧跟在后面 */
+typedef struct {
+    lv_port_glyph_font_t wrap;      // 套上缓存后交给LVGL的字体
+    lv_font_t            font;      // 原字体，dsc指向这里
+    lv_fs_file_t         file;      // 字体文件，打开期间一直占用
+    lv_port_font_head    head;      // 文件头
+    lv_port_font_page *  pages;     // 页表
+    uint32_t             last;      // 上一次查找的字符
+    uint32_t             found;     // 上一次查找的结果
+    lv_port_font_glyph   glyph;     // 上一次找到的字形
+    uint8_t *            buf;       // 位图缓冲区
+    uint32_t             buf_size;  // 位图缓冲区的字节数
+} font_ctx;
+
+static lv_port_font_stat stat;  // 只在LVGL线程中修改
+
+/**
+ * @brief 从字体文件的指定位置读取。
+ * @param f 字体。
+ * @param ofs 文件偏移。
+ * @param buf 缓冲区。
+ * @param size 字节数。
+ * @retval true：成功。
+ * @retval false：失败或者文件太短。
+ * @warning
+ * @note
+ */
+static bool _font_read(font_ctx * const f, const uint32_t ofs, void * const buf,
+                       const uint32_t size) {
+    uint32_t br = 0;
+    if (lv_fs_seek(&f->file, ofs, LV_FS_SEEK_SET) != LV_FS_RES_OK) {
+        return false;
+    }
+    return (lv_fs_read(&f->file, buf, size, &br) == LV_FS_RES_OK) && (br == size);
+}
+
+/**
+ * @brief 查找字符，把字形表项读到f->glyph。
+ * @param f 字体。
+ * @param letter 字符。
+ * @retval true：找到。
+ * @retval false：字体中没有这个字符，或者读文件失败。
+ * @warning
+ * @note 与上一次查找的字符相同时直接返回上一次的结果。
+ */
+static bool _font_find(font_ctx * const f, const uint32_t letter) {
+    ++stat.lookups;
+    if (letter == f->last) {
+        ++stat.repeats;
+        return f->found;
+    }
+    f->last  = letter;
+    f->found = 0;
+
+    /* 在RAM中二分查找页 */
+    const uint32_t page = letter >> 8;
+    const uint32_t cnt  = f->head.page_cnt;
+    uint32_t       lo   = 0;
+    uint32_t       hi   = cnt;
+    while (lo < hi) {
+        const uint32_t mid = (lo + hi) / 2;
+        if (f->pages[mid].page < page) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if ((lo == cnt) || (f->pages[lo].page != page)) {
+        ++stat.misses;
+        return false;
+    }
+
+    /* 在文件中二分查找这一页的字符表 */
+    const uint32_t codes = sizeof(lv_port_font_head) + cnt * sizeof(lv_port_font_page);
+    const uint8_t  low   = (uint8_t)letter;
+    hi                   = (lo + 1 < cnt) ? f->pages[lo + 1].first : f->head.glyph_cnt;
+    lo                   = f->pages[lo].first;
+    while (lo < hi) {
+        const uint32_t mid  = (lo + hi) / 2;
+        uint8_t        code = 0;
+        ++stat.probes;
+        if (!_font_read(f, codes + mid, &code, 1)) {
+            return false;
+        }
+        if (code == low) {
+            f->found = _font_read(f, f->head.glyph_ofs + mid * sizeof(lv_port_font_glyph),
+                                  &f->glyph, sizeof(lv_port_font_glyph));
+            return f->found;
+        }
+        if (code < low) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    ++stat.misses;
+    return false;
+}
+
+/**
+ * @brief lv_font_t的get_glyph_dsc回调。
+ * @param font 字体。
+ * @param dsc 字形描述。
+ * @param letter 字符。
+ * @param letter_next 下一个字符，不支持字距调整所以没有使用。
+ * @retval true：找到。
+ * @retval false：字体中没有这个字符。
+ * @warning
+ * @note 与lv_font_fmt_txt相同，制表符按两个空格的宽度处理。
+ */
+static bool _font_glyph_dsc(const lv_font_t * font, lv_font_glyph_dsc_t * dsc,
+                            uint32_t letter, uint32_t letter_next) {
+    font_ctx * const f   = (font_ctx *)font->dsc;
+    const bool       tab = letter == '\t';
+    if (!_font_find(f, tab ? ' ' : letter)) {
+        return false;
+    }
+    dsc->adv_w          = tab ? f->glyph.adv_w * 2 : f->glyph.adv_w;
+    dsc->box_w          = f->glyph.box_w;
+    dsc->box_h          = f->glyph.box_h;
+    dsc->ofs_x          = f->glyph.ofs_x;
+    dsc->ofs_y          = f->glyph.ofs_y;
+    dsc->bpp            = f->head.bpp;
+    dsc->is_placeholder = false;
+    return true;
+}
+
+/**
+ * @brief lv_font_t的get_glyph_bitmap回调：把位图读到字体的缓冲区。
+ * @param font 字体。
+ * @param letter 字符。
+ * @retval 位图：NULL表示没有这个字符或者内存不足。
+ * @warning
+ * @note 位图在下一次调用之前有效；缓冲区只增不减，最终等于最大字形的大小。
+ */
+static const uint8_t * _font_glyph_bitmap(const lv_font_t * font, uint32_t letter) {
+    font_ctx * const f = (font_ctx *)font->dsc;
+    if (!_font_find(f, (letter == '\t') ? ' ' : letter)) {
+        return NULL;
+    }
+    const uint32_t size =
+        ((uint32_t)f->glyph.box_w * f->glyph.box_h * f->head.bpp + 7) >> 3;
+    if (size == 0) {
+        return NULL;
+    }
+    if (size > f->buf_size) {
+        uint8_t * const buf = lv_mem_realloc(f->buf, size);
+        if (buf == NULL) {
+            return NULL;
+        }
+        f->buf      = buf;
+        f->buf_size = size;
+    }
+    if (!_font_read(f, f->head.bitmap_ofs + f->glyph.bitmap, f->buf, size)) {
+        return NULL;
+    }
+    ++stat.bitmaps;
+    stat.bytes += size;
+    return f->buf;
+}
+
+/********** 导出的函数 **********/
+
+const lv_font_t * lv_port_font_load(const char * const path) {
+    lv_fs_file_t      file;
+    lv_port_font_head head;
+    uint32_t          br = 0;
+    if (lv_fs_open(&file, path, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+        return NULL;
+    }
+    if ((lv_fs_read(&file, &head, sizeof(head), &br) != LV_FS_RES_OK) ||
+        (br != sizeof(head)) || (head.magic != LV_PORT_FONT_MAGIC) ||
+        ((head.bpp != 1) && (head.bpp != 2) && (head.bpp != 4) && (head.bpp != 8))) {
+        lv_fs_close(&file);
+        return NULL;
+    }
+
+    const uint32_t   pages = head.page_cnt * sizeof(lv_port_font_page);
+    font_ctx * const f     = lv_mem_alloc(sizeof(font_ctx) + pages);
+    if (f == NULL) {
+        lv_fs_close(&file);
+        return NULL;
+    }
+    lv_memset_00(f, sizeof(font_ctx));
+    f->file  = file;
+    f->head  = head;
+    f->pages = (lv_port_font_page *)(f + 1);
+    f->last  = 0xFFFFFFFF;
+    if ((pages > 0) && !_font_read(f, sizeof(head), f->pages, pages)) {
+        lv_fs_close(&f->file);
+        lv_mem_free(f);
+        return NULL;
+    }
+
+    lv_font_t * const font    = &f->font;
+    font->get_glyph_dsc       = _font_glyph_dsc;
+    font->get_glyph_bitmap    = _font_glyph_bitmap;
+    font->line_height         = head.line_height;
+    font->base_line           = head.base_line;
+    font->subpx               = LV_FONT_SUBPX_NONE;
+    font->underline_position  = head.underline_position;
+    font->underline_thickness = (int8_t)head.underline_thickness;
+    font->dsc                 = f;
+    return lv_port_glyph_font(&f->wrap, font);
+}
+
+void lv_port_font_free(const lv_font_t * const font) {
+    font_ctx * const f = (font_ctx *)font->dsc;
+    lv_port_glyph_flush();
+    lv_fs_close(&f->file);
+    lv_mem_free(f->buf);
+    lv_mem_free(f);
+}
+
+void lv_port_font_info(lv_port_font_stat * const s) {
+#ifndef LV_PORT_FONT_HOST
+    rt_base_t level = rt_hw_interrupt_disable();
+    *s              = stat;
+    rt_hw_interrupt_enable(level);
+#else
+    *s = stat;
+#endif  // LV_PORT_FONT_HOST
+}
+
+void lv_port_font_print(int (*print)(const char * fmt, ...)) {
+    lv_port_font_stat s;
+    lv_port_font_info(&s);
+
+    print("%8s %8s %8s %8s %8s %8s\n", "lookups", "repeats", "misses", "probes",
+          "bitmaps", "bytes");
+    print("%8u %8u %8u %8u %8u %8u\n", s.lookups, s.repeats, s.misses, s.probes,
+          s.bitmaps, s.bytes);
+}
+
+/********** 板上的MSH命令 **********/
+
+#ifndef LV_PORT_FONT_HOST
+/**
+ * @brief lvfont：查看外部Flash字体的查找与读取次数。
+ * @param argc 参数个数。
+ * @param argv
+ * @retval
+ * @warning
+ * @note
+ */
+static void lvfont(int argc, char ** argv) {
+    lv_port_font_print(rt_kprintf);
+}
+MSH_CMD_EXPORT(lvfont, lvgl external flash font reads);
+#endif  // LV_PORT_FONT_HOST
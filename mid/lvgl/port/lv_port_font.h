@@ -0,0 +1,112 @@
+#ifndef LV_PORT_FONT_H
+#define LV_PORT_FONT_H
+
+/**
+ * @brief 这是从外部Flash按需读取字形的LVGL字体模块。
+ * @details lv_font_load把整个字体读进RAM，几千个汉字的字体在32KB的RAM中放不下。
+ * 这里的字体文件（由tool/font_pack.c从lv_font_conv生成的C字体转换）按字符排序，
+ * 分成四段：文件头、页表、字符表、字形表，最后是位图：
+ * 页表按字符的高位（字符>>8）列出出现过的页与页内第一个字形的序号，
+ * 字符表按顺序存放每个字形的低8位，字形表存放每个字形的尺寸与位图位置。
+ * 打开字体时只把文件头和页表读进RAM（每页4字节，常用汉字约80页）；
+ * 查找一个字符时先在RAM中二分查找页，再在文件中二分查找这一页的字符表（最多8次），
+ * 最后读出字形表中的一项；取位图时读到字体自己的缓冲区中。
+ * 连续两次查找同一个字符（LVGL先取描述再取位图）只读一次文件。
+ * 返回的字体已经套上lv_port_glyph的缓存，常用的字不会反复读取Flash。
+ * 板上通过MSH命令lvfont查看读取次数。
+ * @file lv_port_font.h
+ * @author proyrb
+ * @date 2025/8/20
+ * @note 字体打开期间一直占用lv_port_fs的一个文件句柄；不支持字距调整。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <lv_port_glyph.h>
+
+/********** 字体文件格式（小端） **********/
+
+// 文件头的magic："SCFT"
+#define LV_PORT_FONT_MAGIC 0x54464353
+
+typedef struct {
+    uint32_t magic;                // LV_PORT_FONT_MAGIC
+    uint16_t glyph_cnt;            // 字形数
+    uint16_t page_cnt;             // 页数
+    uint8_t  bpp;                  // 每像素位数：1、2、4或8
+    uint8_t  line_height;          // 行高
+    int8_t   base_line;            // 基线到行底的距离
+    int8_t   underline_position;   // 下划线位置
+    uint8_t  underline_thickness;  // 下划线粗细
+    uint8_t  reserved[3];          // 保留，写0
+    uint32_t glyph_ofs;            // 字形表的文件偏移
+    uint32_t bitmap_ofs;           // 位图的文件偏移
+} lv_port_font_head;
+
+// 页表项：页表紧跟文件头，字符表紧跟页表（每个字形1字节）
+typedef struct {
+    uint16_t page;   // 字符>>8，按升序排列
+    uint16_t first;  // 页内第一个字形的序号，页内的字形数由下一页的first得出
+} lv_port_font_page;
+
+// 字形表项：与字符表的序号一一对应
+typedef struct {
+    uint32_t bitmap;    // 位图相对bitmap_ofs的偏移，按行紧密排列
+    uint16_t adv_w;     // 步进宽度（像素）
+    uint8_t  box_w;     // 位图宽
+    uint8_t  box_h;     // 位图高
+    int8_t   ofs_x;     // 位图左边相对原点的偏移
+    int8_t   ofs_y;     // 位图底边相对基线的偏移
+    uint16_t reserved;  // 保留，写0
+} lv_port_font_glyph;
+
+/********** 统计结果 **********/
+
+typedef struct {
+    uint32_t lookups;  // 查找字符的次数
+    uint32_t repeats;  // 与上一次查找的字符相同、不读文件的次数
+    uint32_t misses;   // 字体中没有的字符数
+    uint32_t probes;   // 在字符表中二分查找时读文件的次数
+    uint32_t bitmaps;  // 读取位图的次数
+    uint32_t bytes;    // 读取位图的字节数
+} lv_port_font_stat;
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 打开外部Flash中的字体。
+ * @param path 文件路径，例如"F:/font/cjk16.bin"。
+ * @retval 交给LVGL使用的字体：NULL表示文件不存在、格式错误或内存不足。
+ * @warning 只在LVGL线程中调用，或者先调用lv_port_task_lock；必须先调用lv_port_fs_init。
+ * @note 常驻RAM的只有字体本身、页表与一个字形大小的缓冲区。
+ */
+extern const lv_font_t * lv_port_font_load(const char * const path);
+
+/**
+ * @brief 关闭字体。
+ * @param font lv_port_font_load返回的字体。
+ * @retval
+ * @warning 只在LVGL线程中调用，或者先调用lv_port_task_lock；使用它的控件必须已经删除。
+ * @note 同时清空字形缓存。
+ */
+extern void lv_port_font_free(const lv_font_t * const font);
+
+/**
+ * @brief 取得统计。
+ * @param stat 统计结果。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void lv_port_font_info(lv_port_font_stat * const stat);
+
+/**
+ * @brief 打印统计。
+ * @param print 输出函数。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void lv_port_font_print(int (*print)(const char * fmt, ...));
+
+#endif  // LV_PORT_FONT_H
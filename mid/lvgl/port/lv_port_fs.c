@@ -0,0 +1,200 @@
+#define LV_PORT_FS_C
+
+#include <lv_port_fs.h>
+#include <lfs_port.h>
+
+static lv_fs_drv_t fs_drv;
+
+static lfs_file_t files[FS_FILE_CNT];
+static uint8_t    file_used[FS_FILE_CNT];
+static lfs_dir_t  dirs[FS_DIR_CNT];
+static uint8_t    dir_used[FS_DIR_CNT];
+
+/**
+ * @brief 从静态池中取一个空闲句柄。
+ * @param used 占用标志。
+ * @param cnt 句柄数。
+ * @retval 句柄序号：cnt表示没有空闲句柄。
+ * @warning 只在LVGL线程中调用，不需要加锁。
+ * @note
+ */
+static uint32_t _fs_claim(uint8_t * const used, const uint32_t cnt) {
+    uint32_t i = 0;
+    while ((i < cnt) && used[i]) {
+        ++i;
+    }
+    if (i < cnt) {
+        used[i] = 1;
+    }
+    return i;
+}
+
+static lv_fs_res_t _fs_res(const int err) {
+    switch (err) {
+        case LFS_ERR_OK:
+            return LV_FS_RES_OK;
+        case LFS_ERR_NOENT:
+            return LV_FS_RES_NOT_EX;
+        case LFS_ERR_NOSPC:
+            return LV_FS_RES_FULL;
+        case LFS_ERR_NOMEM:
+            return LV_FS_RES_OUT_OF_MEM;
+        case LFS_ERR_CORRUPT:
+            return LV_FS_RES_FS_ERR;
+        case LFS_ERR_INVAL:
+            return LV_FS_RES_INV_PARAM;
+        default:
+            return LV_FS_RES_HW_ERR;
+    }
+}
+
+/********** 文件操作 **********/
+
+static bool _fs_ready(lv_fs_drv_t * drv) {
+    return lfs_port_fs() != NULL;
+}
+
+static void * _fs_open(lv_fs_drv_t * drv, const char * path, lv_fs_mode_t mode) {
+    int flags = LFS_O_RDONLY;
+    if (mode == (LV_FS_MODE_WR | LV_FS_MODE_RD)) {
+        flags = LFS_O_RDWR | LFS_O_CREAT;
+    } else if (mode == LV_FS_MODE_WR) {
+        flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC;
+    }
+
+    const uint32_t i = _fs_claim(file_used, FS_FILE_CNT);
+    if (i == FS_FILE_CNT) {
+        return NULL;
+    }
+    if (lfs_port_file_open(&files[i], path, flags) != LFS_ERR_OK) {
+        file_used[i] = 0;
+        return NULL;
+    }
+    return &files[i];
+}
+
+static lv_fs_res_t _fs_close(lv_fs_drv_t * drv, void * file_p) {
+    lfs_file_t * const file = file_p;
+    const int          err  = lfs_port_file_close(file);
+    file_used[file - files] = 0;
+    return _fs_res(err);
+}
+
+static lv_fs_res_t _fs_read(lv_fs_drv_t * drv, void * file_p, void * buf, uint32_t btr,
+                            uint32_t * br) {
+    const lfs_ssize_t n = lfs_file_read(lfs_port_fs(), file_p, buf, btr);
+    if (n < 0) {
+        *br = 0;
+        return _fs_res(n);
+    }
+    *br = n;
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t _fs_write(lv_fs_drv_t * drv, void * file_p, const void * buf,
+                             uint32_t btw, uint32_t * bw) {
+    const lfs_ssize_t n = lfs_file_write(lfs_port_fs(), file_p, buf, btw);
+    if (n < 0) {
+        *bw = 0;
+        return _fs_res(n);
+    }
+    *bw = n;
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t _fs_seek(lv_fs_drv_t * drv, void * file_p, uint32_t pos,
+                            lv_fs_whence_t whence) {
+    int lfs_whence = LFS_SEEK_SET;
+    if (whence == LV_FS_SEEK_CUR) {
+        lfs_whence = LFS_SEEK_CUR;
+    } else if (whence == LV_FS_SEEK_END) {
+        lfs_whence = LFS_SEEK_END;
+    }
+
+    const lfs_soff_t off = lfs_file_seek(lfs_port_fs(), file_p, pos, lfs_whence);
+    return (off < 0) ? _fs_res(off) : LV_FS_RES_OK;
+}
+
+static lv_fs_res_t _fs_tell(lv_fs_drv_t * drv, void * file_p, uint32_t * pos_p) {
+    const lfs_soff_t off = lfs_file_tell(lfs_port_fs(), file_p);
+    if (off < 0) {
+        return _fs_res(off);
+    }
+    *pos_p = off;
+    return LV_FS_RES_OK;
+}
+
+/********** 目录操作 **********/
+
+static void * _fs_dir_open(lv_fs_drv_t * drv, const char * path) {
+    const uint32_t i = _fs_claim(dir_used, FS_DIR_CNT);
+    if (i == FS_DIR_CNT) {
+        return NULL;
+    }
+    if (lfs_dir_open(lfs_port_fs(), &dirs[i], path) != LFS_ERR_OK) {
+        dir_used[i] = 0;
+        return NULL;
+    }
+    return &dirs[i];
+}
+
+/**
+ * @brief 读取下一个目录项。
+ * @param drv 驱动。
+ * @param rddir_p 目录句柄。
+ * @param fn 接收名字：目录以'/'开头，读完时为空字符串。
+ * @retval LV_FS_RES_OK：读取成功。
+ * @warning
+ * @note 跳过"."与".."。
+ */
+static lv_fs_res_t _fs_dir_read(lv_fs_drv_t * drv, void * rddir_p, char * fn) {
+    struct lfs_info info;
+    int             err;
+
+    do {
+        err = lfs_dir_read(lfs_port_fs(), rddir_p, &info);
+    } while ((err > 0) && (info.type == LFS_TYPE_DIR) &&
+             (!strcmp(info.name, ".") || !strcmp(info.name, "..")));
+
+    if (err < 0) {
+        fn[0] = '\0';
+        return _fs_res(err);
+    }
+    if (err == 0) {
+        fn[0] = '\0';
+    } else if (info.type == LFS_TYPE_DIR) {
+        fn[0] = '/';
+        strcpy(&fn[1], info.name);
+    } else {
+        strcpy(fn, info.name);
+    }
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t _fs_dir_close(lv_fs_drv_t * drv, void * rddir_p) {
+    lfs_dir_t * const dir = rddir_p;
+    const int         err = lfs_dir_close(lfs_port_fs(), dir);
+    dir_used[dir - dirs]  = 0;
+    return _fs_res(err);
+}
+
+/********** 导出的函数 **********/
+
+void lv_port_fs_init(void) {
+    lv_fs_drv_init(&fs_drv);
+
+    fs_drv.letter       = FS_LETTER;
+    fs_drv.cache_size   = FS_CACHE_SIZE;
+    fs_drv.ready_cb     = _fs_ready;
+    fs_drv.open_cb      = _fs_open;
+    fs_drv.close_cb     = _fs_close;
+    fs_drv.read_cb      = _fs_read;
+    fs_drv.write_cb     = _fs_write;
+    fs_drv.seek_cb      = _fs_seek;
+    fs_drv.tell_cb      = _fs_tell;
+    fs_drv.dir_open_cb  = _fs_dir_open;
+    fs_drv.dir_read_cb  = _fs_dir_read;
+    fs_drv.dir_close_cb = _fs_dir_close;
+
+    lv_fs_drv_register(&fs_drv);
+}
@@ -0,0 +1,46 @@
+#ifndef LV_PORT_FS_H
+#define LV_PORT_FS_H
+
+/**
+ * @brief 这是LVGL文件系统到littlefs的移植模块。
+ * @details 先初始化lvgl与lfs_port，再调用lv_port_fs_init注册驱动；
+ * 之后可以用"F:/img/logo.bin"这样的路径从外部flash加载字体与图片。
+ * @file lv_port_fs.h
+ * @author proyrb
+ * @date 2025/8/16
+ * @note 文件句柄与目录句柄都来自静态池，文件缓存来自lfs_port的缓存池，不使用堆内存。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <lvgl.h>
+
+/********** 配置模块行为 **********/
+
+#ifdef LV_PORT_FS_C
+
+// 驱动器盘符
+#    define FS_LETTER 'F'
+
+// 同时打开的文件数与目录数：文件数不能超过LFS_PORT_FILE_CNT
+#    define FS_FILE_CNT 2
+#    define FS_DIR_CNT  1
+
+// LVGL的预读缓存：略大于一行240像素的RGB565（480字节），
+// 图片解码器逐行读取、字体加载器读取若干小段时都能命中
+#    define FS_CACHE_SIZE 512
+
+#endif  // LV_PORT_FS_C
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 注册littlefs驱动。
+ * @param
+ * @retval
+ * @warning 必须在lv_init与lfs_port_init之后调用。
+ * @note
+ */
+extern void lv_port_fs_init(void);
+
+#endif  // LV_PORT_FS_H
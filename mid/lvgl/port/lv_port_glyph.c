@@ -0,0 +1,189 @@
+#define LV_PORT_GLYPH_C
+
+#include <lv_port_glyph.h>
+#include <src/misc/lv_lru.h>
+#ifndef LV_PORT_GLYPH_HOST
+#    include <lv_port_mem.h>
+#    include <rtthread.h>
+#    include <rthw.h>
+#endif  // LV_PORT_GLYPH_HOST
+
+/* 缓存的键：原字体与字符 */
+typedef struct {
+    const lv_font_t * base;
+    uint32_t          letter;
+} glyph_key;
+
+static lv_lru_t *         cache = NULL;  // 第一次套上缓存时创建
+static lv_port_glyph_stat stat;          // 只在LVGL线程中修改
+
+/**
+ * @brief lv_lru释放位图时的回调：顺便统计淘汰次数。
+ * @param value 位图。
+ * @retval
+ * @warning
+ * @note 清空缓存时也会经过这里，由lv_port_glyph_flush扣除。
+ */
+static void _glyph_free(void * value) {
+    lv_mem_free(value);
+    ++stat.evicts;
+    --stat.entries;
+}
+
+/**
+ * @brief 计算字形位图的字节数，与lv_font_fmt_txt解压时的计算一致。
+ * @param dsc 字形描述。
+ * @retval 字节数，0表示不能缓存（空字形或者图片字体）。
+ * @warning
+ * @note 3位色深的字形按4位存放。
+ */
+static uint32_t _glyph_size(const lv_font_glyph_dsc_t * const dsc) {
+    const uint32_t px  = (uint32_t)dsc->box_w * dsc->box_h;
+    const uint32_t bpp = (dsc->bpp == 3) ? 4 : dsc->bpp;
+    if (bpp > 8) {
+        return 0;
+    }
+    return (px * bpp + 7) >> 3;
+}
+
+/**
+ * @brief 决定缓存的字节预算。
+ * @param
+ * @retval 字节数。
+ * @warning
+ * @note 主机版本没有lv_port_mem，直接取上限。
+ */
+static uint32_t _glyph_budget(void) {
+#ifndef LV_PORT_GLYPH_HOST
+    lv_port_mem_stat mem;
+    lv_port_mem_info(&mem);
+    return LV_CLAMP(GLYPH_CACHE_MIN, mem.largest / GLYPH_CACHE_SHARE, GLYPH_CACHE_MAX);
+#else
+    return GLYPH_CACHE_MAX;
+#endif  // LV_PORT_GLYPH_HOST
+}
+
+/**
+ * @brief 替换后的get_glyph_bitmap：先查缓存，未命中时调用原字体并保存一份。
+ * @param font 套上缓存的字体，实际是lv_port_glyph_font_t。
+ * @param letter 字符。
+ * @retval 字形位图，NULL表示没有这个字。
+ * @warning
+ * @note 返回的位图在下一次调用之前有效，与原字体的约定相同；
+ * 制表符与lv_font_fmt_txt一样取空格的位图，但描述中的宽度加倍，所以按空格缓存。
+ */
+static const uint8_t * _glyph_bitmap(const lv_font_t * font, uint32_t letter) {
+    if (letter == '\t') {
+        letter = ' ';
+    }
+    const lv_font_t * const base = ((const lv_port_glyph_font_t *)font)->base;
+    const glyph_key         key  = {.base = base, .letter = letter};
+
+    void * value = NULL;
+    lv_lru_get(cache, &key, sizeof(key), &value);
+    if (value != NULL) {
+        ++stat.hits;
+        return (const uint8_t *)value;
+    }
+
+    /* 先取字形描述再取位图：原字体可能在两者之间共用同一个临时缓冲区 */
+    ++stat.misses;
+    lv_font_glyph_dsc_t   dsc;
+    const bool            found  = base->get_glyph_dsc(base, &dsc, letter, 0);
+    const uint32_t        size   = found ? _glyph_size(&dsc) : 0;
+    const uint8_t * const bitmap = base->get_glyph_bitmap(base, letter);
+    if ((bitmap == NULL) || (size == 0) || (size + GLYPH_OVERHEAD > stat.total)) {
+        return bitmap;
+    }
+
+    uint8_t * const copy = lv_mem_alloc(size);
+    if (copy == NULL) {
+        return bitmap;
+    }
+    lv_memcpy(copy, bitmap, size);
+    if (lv_lru_set(cache, &key, sizeof(key), copy, size + GLYPH_OVERHEAD) != LV_LRU_OK) {
+        lv_mem_free(copy);
+        return bitmap;
+    }
+    ++stat.entries;
+    return copy;
+}
+
+/********** 导出的函数 **********/
+
+const lv_font_t * lv_port_glyph_font(lv_port_glyph_font_t * const wrap,
+                                     const lv_font_t * const      base) {
+    /* 位图直接存放在内部Flash中的字体没有必要缓存 */
+    if (base->get_glyph_bitmap == lv_font_get_bitmap_fmt_txt) {
+        const lv_font_fmt_txt_dsc_t * const fdsc = base->dsc;
+        if (fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
+            return base;
+        }
+    }
+
+    if (cache == NULL) {
+        const uint32_t budget = _glyph_budget();
+        cache = lv_lru_create(budget, GLYPH_AVG_BYTES, _glyph_free, lv_mem_free);
+        if (cache == NULL) {
+            return base;
+        }
+        stat.total = budget;
+    }
+
+    wrap->font                  = *base;
+    wrap->font.get_glyph_bitmap = _glyph_bitmap;
+    wrap->base                  = base;
+    return &wrap->font;
+}
+
+void lv_port_glyph_flush(void) {
+    if (cache == NULL) {
+        return;
+    }
+    const uint32_t evicts = stat.evicts;
+    while (stat.entries > 0) {
+        lv_lru_remove_lru_item(cache);
+    }
+    stat.evicts = evicts;
+}
+
+void lv_port_glyph_info(lv_port_glyph_stat * const s) {
+#ifndef LV_PORT_GLYPH_HOST
+    rt_base_t level = rt_hw_interrupt_disable();
+#endif  // LV_PORT_GLYPH_HOST
+    *s = stat;
+    if (cache != NULL) {
+        s->used = cache->total_memory - cache->free_memory;
+    }
+#ifndef LV_PORT_GLYPH_HOST
+    rt_hw_interrupt_enable(level);
+#endif  // LV_PORT_GLYPH_HOST
+}
+
+void lv_port_glyph_print(int (*print)(const char * fmt, ...)) {
+    lv_port_glyph_stat s;
+    lv_port_glyph_info(&s);
+
+    const uint32_t lookups = s.hits + s.misses;
+    print("%8s %8s %8s %8s %6s %6s %5s\n", "hits", "misses", "evicts", "entries", "used",
+          "total", "hit");
+    print("%8u %8u %8u %8u %6u %6u %4u%%\n", s.hits, s.misses, s.evicts, s.entries,
+          s.used, s.total, (lookups == 0) ? 0 : (uint32_t)(100ULL * s.hits / lookups));
+}
+
+/********** 板上的MSH命令 **********/
+
+#ifndef LV_PORT_GLYPH_HOST
+/**
+ * @brief lvglyph：查看字形缓存的命中率与占用。
+ * @param argc 参数个数。
+ * @param argv
+ * @retval
+ * @warning
+ * @note
+ */
+static void lvglyph(int argc, char ** argv) {
+    lv_port_glyph_print(rt_kprintf);
+}
+MSH_CMD_EXPORT(lvglyph, lvgl glyph cache hits and usage);
+#endif  // LV_PORT_GLYPH_HOST
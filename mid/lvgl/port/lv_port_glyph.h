@@ -0,0 +1,105 @@
+#ifndef LV_PORT_GLYPH_H
+#define LV_PORT_GLYPH_H
+
+/**
+ * @brief 这是LVGL字形位图的LRU缓存模块。
+ * @details 压缩字体每画一个字都要重新解压一次字形，外部Flash中的字体每次都要重新读取；
+ * 文字较多的界面却总在重画同样的几十个字。
+ * 这里用lv_lru按（字体，字符）缓存字形位图，所有字体共用一个字节预算，
+ * 超出预算时淘汰最久没有用到的字形。
+ * 预算在第一次套上缓存时按最大空闲块决定，限制在GLYPH_CACHE_MIN与GLYPH_CACHE_MAX之间。
+ * 用法是给原字体套一层lv_port_glyph_font，把返回的字体交给LVGL：
+ * 它复制原字体的全部参数，只把get_glyph_bitmap换成先查缓存、未命中时再调用原字体。
+ * 位图直接存放在内部Flash中、不需要解压的字体原样返回，不占用缓存。
+ * 板上通过MSH命令lvglyph查看命中率与占用。
+ * @file lv_port_glyph.h
+ * @author proyrb
+ * @date 2025/8/20
+ * @note 原字体的get_glyph_bitmap返回的可以是临时缓冲区：缓存总是复制一份。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <lvgl.h>
+
+/********** 配置模块行为 **********/
+
+#ifdef LV_PORT_GLYPH_C
+
+// 所有字形共用的字节预算的上限，包括每个字形的管理开销：
+// 16点阵4位色深的汉字每个约192字节，够放一个界面上常见的四十来个字
+#    define GLYPH_CACHE_MAX (8 * 1024)
+
+// 字节预算的下限：空闲内存再少也按这么多创建，放得下十来个汉字
+#    define GLYPH_CACHE_MIN (2 * 1024)
+
+// 创建缓存时最多占用当时最大空闲块的几分之一，给绘制缓冲区与图层留出余量
+#    define GLYPH_CACHE_SHARE 4
+
+// 每个字形的管理开销：lv_lru的表项与键，以及它们和位图各自的堆块头
+#    define GLYPH_OVERHEAD 64
+
+// 估计的平均字形大小（含开销），决定lv_lru哈希表的桶数
+#    define GLYPH_AVG_BYTES 192
+
+#endif  // LV_PORT_GLYPH_C
+
+/********** 套在原字体外面的一层 **********/
+
+typedef struct {
+    lv_font_t         font;  // 交给LVGL使用的字体，必须是第一个成员
+    const lv_font_t * base;  // 原字体
+} lv_port_glyph_font_t;
+
+/********** 统计结果 **********/
+
+typedef struct {
+    uint32_t hits;     // 命中次数
+    uint32_t misses;   // 未命中、调用原字体的次数
+    uint32_t evicts;   // 淘汰的字形数
+    uint32_t entries;  // 当前缓存的字形数
+    uint32_t used;     // 当前占用的字节数，包括管理开销
+    uint32_t total;    // 字节预算，创建缓存时按空闲内存决定
+} lv_port_glyph_stat;
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 给字体套上字形缓存。
+ * @param wrap 存放新字体的空间，需要与使用它的控件活得一样久。
+ * @param base 原字体。
+ * @retval 交给LVGL使用的字体；不需要缓存的字体直接返回base。
+ * @warning 只在LVGL线程中调用，或者先调用lv_port_task_lock。
+ * @note 原字体的回退字体保持不变，需要时可以分别套上缓存。
+ */
+extern const lv_font_t * lv_port_glyph_font(lv_port_glyph_font_t * const wrap,
+                                            const lv_font_t * const      base);
+
+/**
+ * @brief 清空缓存。
+ * @param
+ * @retval
+ * @warning 只在LVGL线程中调用，或者先调用lv_port_task_lock。
+ * @note 释放字体之前必须调用：缓存按原字体的地址区分字形。
+ */
+extern void lv_port_glyph_flush(void);
+
+/**
+ * @brief 取得统计。
+ * @param stat 统计结果。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void lv_port_glyph_info(lv_port_glyph_stat * const stat);
+
+/**
+ * @brief 打印统计。
+ * @param print 输出函数。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void lv_port_glyph_print(int (*print)(const char * fmt, ...));
+
+#endif  // LV_PORT_GLYPH_H
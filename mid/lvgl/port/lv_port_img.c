@@ -0,0 +1,408 @@
+#define LV_PORT_IMG_C
+
+#include <lv_port_img.h>
+#include <src/misc/lv_lru.h>
+#include <string.h>
+#ifndef LV_PORT_IMG_HOST
+#    include <rtthread.h>
+#    include <rthw.h>
+#endif  // LV_PORT_IMG_HOST
+
+#if LV_IMG_CACHE_DEF_SIZE != 0
+#    error "lv_port_img needs LV_IMG_CACHE_DEF_SIZE 0 in lv_conf.h"
+#endif
+#if (LV_COLOR_DEPTH != 16) || (LV_COLOR_16_SWAP != 0)
+#    error "lv_port_img needs LV_COLOR_DEPTH 16 and LV_COLOR_16_SWAP 0"
+#endif
+
+// 行偏移表相对于数据开头的位置
+#define ROWS_OFS sizeof(lv_port_img_head)
+
+/* 逐行解码时的图片来源 */
+typedef struct {
+    lv_fs_file_t    file;  // 文件来源，会话期间一直打开
+    const uint8_t * data;  // C数组来源的数据：NULL表示文件
+    uint32_t        h;     // 图片高度
+    uint32_t        px;    // 每像素字节数：2或3
+} img_src;
+
+/* 缓存中的一张图：图片头后面紧跟解码后的像素 */
+typedef struct {
+    lv_img_header_t header;  // 交给LVGL的图片头
+    uint8_t         px[];    // 像素
+} img_entry;
+
+static lv_lru_t *       cache = NULL;  // 注册解码器时创建
+static lv_port_img_stat stat;          // 只在LVGL线程中修改
+
+/**
+ * @brief 取得缓存的键：文件按路径，C数组按地址。
+ * @param src 存放图片来源的变量。
+ * @param key 键。
+ * @retval 键的字节数。
+ * @warning
+ * @note 地址的键只有一个指针长，不会与至少"F:/x"长的路径相同。
+ */
+static uint32_t _img_key(const void * const * const src, const void ** const key) {
+    if (lv_img_src_get_type(*src) == LV_IMG_SRC_FILE) {
+        *key = *src;
+        return strlen(*src) + 1;
+    }
+    *key = src;
+    return sizeof(*src);
+}
+
+/**
+ * @brief lv_lru释放图片时的回调：顺便统计淘汰次数。
+ * @param value 图片。
+ * @retval
+ * @warning
+ * @note 主动删除时也会经过这里，由lv_port_img_invalidate扣除。
+ */
+static void _img_free(void * value) {
+    lv_mem_free(value);
+    ++stat.evicts;
+    --stat.entries;
+}
+
+/**
+ * @brief 打开图片来源并读出图片头。
+ * @param s 图片来源。
+ * @param src 路径或lv_img_dsc_t。
+ * @param header 图片头，颜色格式换成解码后的格式。
+ * @retval true：是这个解码器的图片。
+ * @retval false：不是，或者读文件失败。
+ * @warning 返回true后必须调用_img_src_close。
+ * @note
+ */
+static bool _img_src_open(img_src * const s, const void * const src,
+                          lv_img_header_t * const header) {
+    lv_port_img_head head;
+    if (lv_img_src_get_type(src) == LV_IMG_SRC_VARIABLE) {
+        const lv_img_dsc_t * const dsc = src;
+        *header                        = dsc->header;
+        s->data                        = dsc->data;
+        lv_memcpy(&head, dsc->data, sizeof(head));
+    } else {
+        uint32_t br = 0;
+        s->data     = NULL;
+        if (lv_fs_open(&s->file, src, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+            return false;
+        }
+        if ((lv_fs_read(&s->file, header, sizeof(*header), &br) != LV_FS_RES_OK) ||
+            (br != sizeof(*header)) ||
+            (lv_fs_read(&s->file, &head, sizeof(head), &br) != LV_FS_RES_OK) ||
+            (br != sizeof(head))) {
+            lv_fs_close(&s->file);
+            return false;
+        }
+    }
+
+    if ((header->cf != LV_PORT_IMG_CF) || (head.magic != LV_PORT_IMG_MAGIC)) {
+        if (s->data == NULL) {
+            lv_fs_close(&s->file);
+        }
+        return false;
+    }
+    const bool alpha = (head.flags & LV_PORT_IMG_ALPHA) != 0;
+    header->cf       = alpha ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+    s->h             = header->h;
+    s->px            = alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    return true;
+}
+
+static void _img_src_close(img_src * const s) {
+    if (s->data == NULL) {
+        lv_fs_close(&s->file);
+    }
+}
+
+/**
+ * @brief 从图片数据的指定位置读取。
+ * @param s 图片来源。
+ * @param ofs 相对于数据开头（lv_img_header_t之后）的偏移。
+ * @param buf 缓冲区。
+ * @param size 字节数。
+ * @retval true：成功。
+ * @retval false：读文件失败。
+ * @warning
+ * @note
+ */
+static bool _img_src_read(img_src * const s, const uint32_t ofs, void * const buf,
+                          const uint32_t size) {
+    uint32_t br = 0;
+    if (s->data != NULL) {
+        lv_memcpy(buf, s->data + ofs, size);
+        return true;
+    }
+    if (lv_fs_seek(&s->file, sizeof(lv_img_header_t) + ofs, LV_FS_SEEK_SET) !=
+        LV_FS_RES_OK) {
+        return false;
+    }
+    return (lv_fs_read(&s->file, buf, size, &br) == LV_FS_RES_OK) && (br == size);
+}
+
+/**
+ * @brief 展开一行的行程编码。
+ * @param in 这一行的编码。
+ * @param out 输出的像素。
+ * @param x 跳过的像素数。
+ * @param len 输出的像素数。
+ * @param px 每像素字节数。
+ * @retval
+ * @warning x+len不能超过图片宽度；out按2字节对齐。
+ * @note 跳过的包只移动读取位置，不复制像素。
+ */
+static void _img_rle(const uint8_t * in, uint8_t * out, uint32_t x, uint32_t len,
+                     const uint32_t px) {
+    while (len > 0) {
+        const uint32_t c = *in++;
+        const uint32_t n = (c & 0x7F) + 1;
+        if (x >= n) {
+            x -= n;
+            in += (c & 0x80) ? px : n * px;
+            continue;
+        }
+
+        const uint32_t take = (n - x < len) ? n - x : len;
+        if ((c & 0x80) && (px == 2)) {
+            const uint16_t   v = (uint16_t)(in[0] | (in[1] << 8));
+            uint16_t * const o = (uint16_t *)out;
+            for (uint32_t i = 0; i < take; ++i) {
+                o[i] = v;
+            }
+            in += px;
+        } else if (c & 0x80) {
+            for (uint32_t i = 0; i < take * px; i += px) {
+                out[i]     = in[0];
+                out[i + 1] = in[1];
+                out[i + 2] = in[2];
+            }
+            in += px;
+        } else {
+            lv_memcpy(out, in + x * px, take * px);
+            in += n * px;
+        }
+        out += take * px;
+        len -= take;
+        x = 0;
+    }
+}
+
+/**
+ * @brief 解码一行中的一段。
+ * @param s 图片来源。
+ * @param y 行号。
+ * @param x 起始列。
+ * @param len 像素数。
+ * @param out 输出的像素。
+ * @retval true：成功。
+ * @retval false：读文件失败或者内存不足。
+ * @warning
+ * @note 文件来源先把这一行的编码读进LVGL的临时缓冲区。
+ */
+static bool _img_line(img_src * const s, const uint32_t y, const uint32_t x,
+                      const uint32_t len, uint8_t * const out) {
+    uint32_t ofs[2];
+    if (!_img_src_read(s, ROWS_OFS + y * sizeof(uint32_t), ofs, sizeof(ofs))) {
+        return false;
+    }
+    const uint32_t base = ROWS_OFS + (s->h + 1) * sizeof(uint32_t) + ofs[0];
+    if (s->data != NULL) {
+        _img_rle(s->data + base, out, x, len, s->px);
+        return true;
+    }
+
+    const uint32_t  size = ofs[1] - ofs[0];
+    uint8_t * const buf  = lv_mem_buf_get(size);
+    if (buf == NULL) {
+        return false;
+    }
+    const bool ok = _img_src_read(s, base, buf, size);
+    if (ok) {
+        _img_rle(buf, out, x, len, s->px);
+    }
+    lv_mem_buf_release(buf);
+    return ok;
+}
+
+/********** 解码器回调 **********/
+
+static lv_res_t _img_info(lv_img_decoder_t * decoder, const void * src,
+                          lv_img_header_t * header) {
+    const lv_img_src_t type = lv_img_src_get_type(src);
+    if (type == LV_IMG_SRC_VARIABLE) {
+        if (((const lv_img_dsc_t *)src)->header.cf != LV_PORT_IMG_CF) {
+            return LV_RES_INV;
+        }
+    } else if ((type != LV_IMG_SRC_FILE) || (strcmp(lv_fs_get_ext(src), "rle") != 0)) {
+        return LV_RES_INV;
+    } else {
+        /* 缓存中的图片不必再读文件 */
+        const void *   key   = NULL;
+        const uint32_t ks    = _img_key(&src, &key);
+        void *         value = NULL;
+        lv_lru_get(cache, key, ks, &value);
+        if (value != NULL) {
+            *header = ((const img_entry *)value)->header;
+            return LV_RES_OK;
+        }
+    }
+
+    img_src s;
+    if (!_img_src_open(&s, src, header)) {
+        return LV_RES_INV;
+    }
+    _img_src_close(&s);
+    return LV_RES_OK;
+}
+
+static lv_res_t _img_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc) {
+    const void *   key   = NULL;
+    const uint32_t ks    = _img_key(&dsc->src, &key);
+    void *         value = NULL;
+    lv_lru_get(cache, key, ks, &value);
+    if (value != NULL) {
+        ++stat.hits;
+        dsc->img_data = ((const img_entry *)value)->px;
+        return LV_RES_OK;
+    }
+
+    img_src * const s = lv_mem_alloc(sizeof(img_src));
+    if (s == NULL) {
+        return LV_RES_INV;
+    }
+    lv_img_header_t header;
+    if (!_img_src_open(s, dsc->src, &header)) {
+        lv_mem_free(s);
+        return LV_RES_INV;
+    }
+
+    /* 不超过预算一半的图整张解码进缓存，否则逐行解码 */
+    const uint32_t w    = header.w;
+    const uint32_t size = w * s->h * s->px;
+    img_entry *    e    = NULL;
+    if (size + IMG_OVERHEAD + ks <= IMG_CACHE_BYTES / 2) {
+        e = lv_mem_alloc(sizeof(img_entry) + size);
+    }
+    if (e == NULL) {
+        dsc->user_data = s;
+        return LV_RES_OK;
+    }
+
+    bool ok = true;
+    for (uint32_t y = 0; ok && (y < s->h); ++y) {
+        ok = _img_line(s, y, 0, w, e->px + y * w * s->px);
+    }
+    _img_src_close(s);
+    lv_mem_free(s);
+    e->header = header;
+    if (!ok || (lv_lru_set(cache, key, ks, e, size + IMG_OVERHEAD + ks) != LV_LRU_OK)) {
+        lv_mem_free(e);
+        return LV_RES_INV;
+    }
+    ++stat.entries;
+    ++stat.decodes;
+    dsc->img_data = e->px;
+    return LV_RES_OK;
+}
+
+static lv_res_t _img_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc,
+                               lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                               uint8_t * buf) {
+    img_src * const s = dsc->user_data;
+    if ((s == NULL) || !_img_line(s, (uint32_t)y, (uint32_t)x, (uint32_t)len, buf)) {
+        return LV_RES_INV;
+    }
+    ++stat.lines;
+    return LV_RES_OK;
+}
+
+static void _img_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc) {
+    img_src * const s = dsc->user_data;
+    if (s != NULL) {
+        _img_src_close(s);
+        lv_mem_free(s);
+        dsc->user_data = NULL;
+    }
+}
+
+/********** 导出的函数 **********/
+
+lv_res_t lv_port_img_init(void) {
+    cache = lv_lru_create(IMG_CACHE_BYTES, IMG_AVG_BYTES, _img_free, lv_mem_free);
+    if (cache == NULL) {
+        return LV_RES_INV;
+    }
+    lv_img_decoder_t * const decoder = lv_img_decoder_create();
+    if (decoder == NULL) {
+        lv_lru_del(cache);
+        cache = NULL;
+        return LV_RES_INV;
+    }
+    lv_img_decoder_set_info_cb(decoder, _img_info);
+    lv_img_decoder_set_open_cb(decoder, _img_open);
+    lv_img_decoder_set_read_line_cb(decoder, _img_read_line);
+    lv_img_decoder_set_close_cb(decoder, _img_close);
+    stat.total = IMG_CACHE_BYTES;
+    return LV_RES_OK;
+}
+
+void lv_port_img_invalidate(const void * const src) {
+    if (cache == NULL) {
+        return;
+    }
+    const uint32_t evicts = stat.evicts;
+    if (src == NULL) {
+        while (stat.entries > 0) {
+            lv_lru_remove_lru_item(cache);
+        }
+    } else {
+        const void *   key = NULL;
+        const uint32_t ks  = _img_key(&src, &key);
+        lv_lru_remove(cache, key, ks);
+    }
+    stat.evicts = evicts;
+}
+
+void lv_port_img_info(lv_port_img_stat * const s) {
+#ifndef LV_PORT_IMG_HOST
+    rt_base_t level = rt_hw_interrupt_disable();
+#endif  // LV_PORT_IMG_HOST
+    *s = stat;
+    if (cache != NULL) {
+        s->used = cache->total_memory - cache->free_memory;
+    }
+#ifndef LV_PORT_IMG_HOST
+    rt_hw_interrupt_enable(level);
+#endif  // LV_PORT_IMG_HOST
+}
+
+void lv_port_img_print(int (*print)(const char * fmt, ...)) {
+    lv_port_img_stat s;
+    lv_port_img_info(&s);
+
+    const uint32_t opens = s.hits + s.decodes;
+    print("%8s %8s %8s %8s %8s %6s %6s %5s\n", "hits", "decodes", "lines", "evicts",
+          "entries", "used", "total", "hit");
+    print("%8u %8u %8u %8u %8u %6u %6u %4u%%\n", s.hits, s.decodes, s.lines, s.evicts,
+          s.entries, s.used, s.total,
+          (opens == 0) ? 0 : (uint32_t)(100ULL * s.hits / opens));
+}
+
+/********** 板上的MSH命令 **********/
+
+#ifndef LV_PORT_IMG_HOST
+/**
+ * @brief lvimg：查看图片缓存的命中率与占用。
+ * @param argc 参数个数。
+ * @param argv
+ * @retval
+ * @warning
+ * @note
+ */
+static void lvimg(int argc, char ** argv) {
+    lv_port_img_print(rt_kprintf);
+}
+MSH_CMD_EXPORT(lvimg, lvgl image cache hits and usage);
+#endif  // LV_PORT_IMG_HOST
@@ -0,0 +1,114 @@
+#ifndef LV_PORT_IMG_H
+#define LV_PORT_IMG_H
+
+/**
+ * @brief 这是RGB565行程编码图片的LVGL解码器与按字节预算的图片缓存模块。
+ * @details lv_conf.h中LV_IMG_CACHE_DEF_SIZE为0，LVGL每画一次图片都要重新打开解码器；
+ * 即使改大它，缓存也只按条数限制，几张大图就能占满堆。
+ * 这个解码器处理tool/img_pack.c生成的行程编码图片（文件扩展名为rle，或者C数组），
+ * 像素就是LVGL的RGB565（可选每像素跟一个字节的透明度），解码时只需要展开行程，不需要转换。
+ * 打开图片时先查缓存：命中时直接把解码好的整张图交给LVGL，不做任何解码；
+ * 未命中时把整张图解码进缓存，所有图片共用一个字节预算，超出时淘汰最久没有用到的；
+ * 解码后超过预算一半的大图不进缓存，逐行解码：每行前面有行偏移表，可以直接跳到任意一行。
+ * 初始化后板上通过MSH命令lvimg查看命中率与占用。
+ * @file lv_port_img.h
+ * @author proyrb
+ * @date 2025/8/20
+ * @note 每个解码会话结束后LVGL立即关闭它，所以LV_IMG_CACHE_DEF_SIZE必须保持为0：
+ * 否则LVGL会在缓存淘汰图片之后继续使用它的像素。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <lvgl.h>
+
+/********** 配置模块行为 **********/
+
+#ifdef LV_PORT_IMG_C
+
+// 所有解码后图片共用的字节预算，包括每张图的管理开销
+#    define IMG_CACHE_BYTES (6 * 1024)
+
+// 每张图的管理开销：lv_lru的表项，以及它和像素各自的堆块头；键的长度另外计算
+#    define IMG_OVERHEAD 48
+
+// 估计的平均图片大小，决定lv_lru哈希表的桶数
+#    define IMG_AVG_BYTES 1024
+
+#endif  // LV_PORT_IMG_C
+
+/********** 图片格式（小端） **********/
+
+// 图片头（lv_img_header_t）中的颜色格式
+#define LV_PORT_IMG_CF LV_IMG_CF_USER_ENCODED_0
+
+// 数据开头的magic："RLE5"
+#define LV_PORT_IMG_MAGIC 0x35454C52
+
+// 每个像素后面跟一个字节的透明度
+#define LV_PORT_IMG_ALPHA 0x01
+
+/*
+ * 文件是lv_img_header_t加上数据，C数组的data指向数据，数据依次是：
+ * lv_port_img_head；h+1个uint32_t的行偏移（相对于第一行，最后一项是总长度）；各行的编码。
+ * 每行由若干包组成，包头一个字节：最高位为1时是重复包，后面跟一个像素，重复(低7位+1)次；
+ * 最高位为0时是原样包，后面跟(低7位+1)个像素。像素是2字节RGB565，带透明度时再跟1字节。
+ */
+typedef struct {
+    uint32_t magic;        // LV_PORT_IMG_MAGIC
+    uint8_t  flags;        // LV_PORT_IMG_ALPHA
+    uint8_t  reserved[3];  // 保留，写0
+} lv_port_img_head;
+
+/********** 统计结果 **********/
+
+typedef struct {
+    uint32_t hits;     // 打开图片时命中缓存的次数
+    uint32_t decodes;  // 整张解码进缓存的次数
+    uint32_t lines;    // 逐行解码的行数
+    uint32_t evicts;   // 淘汰的图片数
+    uint32_t entries;  // 当前缓存的图片数
+    uint32_t used;     // 当前占用的字节数，包括管理开销
+    uint32_t total;    // 字节预算
+} lv_port_img_stat;
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 注册解码器。
+ * @param
+ * @retval LV_RES_OK：成功。
+ * @retval LV_RES_INV：内存不足。
+ * @warning 必须在lv_init之后、在LVGL线程中或者加锁后调用；读取文件还需要lv_port_fs_init。
+ * @note 后注册的解码器先被询问，所以不影响LVGL自带格式的图片。
+ */
+extern lv_res_t lv_port_img_init(void);
+
+/**
+ * @brief 从缓存中删除图片。
+ * @param src 图片来源（路径或lv_img_dsc_t）：NULL表示清空缓存。
+ * @retval
+ * @warning 只在LVGL线程中调用，或者先调用lv_port_task_lock。
+ * @note 改写了文件或者释放了C数组之后必须调用。
+ */
+extern void lv_port_img_invalidate(const void * const src);
+
+/**
+ * @brief 取得统计。
+ * @param stat 统计结果。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void lv_port_img_info(lv_port_img_stat * const stat);
+
+/**
+ * @brief 打印统计。
+ * @param print 输出函数。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void lv_port_img_print(int (*print)(const char * fmt, ...));
+
+#endif  // LV_PORT_IMG_H
@@ -0,0 +1,265 @@
+#define LV_PORT_LAYER_C
+
+#include <lv_port_layer.h>
+#include <lv_port_mem.h>
+#include <lv_port_task.h>
+#include <lvgl.h>
+#include <src/draw/sw/lv_draw_sw.h>
+#include <rtthread.h>
+
+#if LV_PORT_LAYER
+
+static lv_port_layer_stat stat;        // 只在LVGL线程中修改
+static lv_obj_t *         cur = NULL;  // 最近一个开始绘制的对象，创建图层时正是图层的主人
+
+/********** 更新统计 **********/
+
+static void _peak(const uint32_t bytes) {
+    stat.peak = LV_MAX(stat.peak, bytes);
+}
+
+/********** 图层回调 **********/
+
+/**
+ * @brief 创建变换图层：整块申请，不能切分。
+ * @param draw_ctx 绘制上下文。
+ * @param layer_ctx 图层，area_full是要画的区域。
+ * @param alpha 是否需要透明度。
+ * @retval 图层；NULL：放弃绘制这个对象。
+ * @warning
+ * @note 与lv_draw_sw_layer_create相同，只是先检查申请结果再清零；
+ * LVGL不限制变换图层的大小，这里超过绘制缓冲区就放弃，不让一个对象占掉整个堆。
+ */
+static lv_draw_layer_ctx_t * _create_transform(lv_draw_ctx_t * const       draw_ctx,
+                                               lv_draw_layer_ctx_t * const layer_ctx,
+                                               const int                   alpha) {
+    if (alpha && (LV_COLOR_SCREEN_TRANSP == 0)) {
+        ++stat.unsupported;
+        return NULL;
+    }
+
+    const uint32_t px    = alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    const uint32_t bytes = lv_area_get_size(&layer_ctx->area_full) * px;
+    const uint32_t draw =
+        _lv_refr_get_disp_refreshing()->driver->draw_buf->size * sizeof(lv_color_t);
+    if (bytes > draw) {
+        ++stat.fails;
+        return NULL;
+    }
+
+    void * const buf = lv_mem_alloc(bytes);
+    if (buf == NULL) {
+        ++stat.fails;
+        return NULL;
+    }
+    lv_memset_00(buf, bytes);
+
+    lv_draw_sw_layer_ctx_t * const sw = (lv_draw_sw_layer_ctx_t *)layer_ctx;
+    sw->buf_size_bytes                = bytes;
+    sw->has_alpha                     = alpha;
+    layer_ctx->buf                    = buf;
+    layer_ctx->area_act               = layer_ctx->area_full;
+
+    draw_ctx->buf                                        = buf;
+    draw_ctx->buf_area                                   = &layer_ctx->area_act;
+    draw_ctx->clip_area                                  = &layer_ctx->area_act;
+    _lv_refr_get_disp_refreshing()->driver->screen_transp = alpha;
+
+    ++stat.transforms;
+    _peak(bytes);
+    return layer_ctx;
+}
+
+/**
+ * @brief layer_init：按空闲内存决定普通图层的条带行数。
+ * @param draw_ctx 绘制上下文。
+ * @param layer_ctx 图层，area_full是要画的区域。
+ * @param flags 是否需要透明度，能否切分。
+ * @retval 图层；NULL：放弃绘制这个对象。
+ * @warning
+ * @note 条带不超过绘制缓冲区，也不占用最大空闲块的最后LAYER_RESERVE字节；
+ * 连一行都放不下时仍然试着申请一行，这时LAYER_RESERVE让给图层。
+ */
+static lv_draw_layer_ctx_t * _create(lv_draw_ctx_t *       draw_ctx,
+                                     lv_draw_layer_ctx_t * layer_ctx,
+                                     lv_draw_layer_flags_t flags) {
+    const int alpha = (flags & LV_DRAW_LAYER_FLAG_HAS_ALPHA) != 0;
+    if ((flags & LV_DRAW_LAYER_FLAG_CAN_SUBDIVIDE) == 0) {
+        return _create_transform(draw_ctx, layer_ctx, alpha);
+    }
+
+    /* 底色只对NORMAL混合成立：其它模式会把底色再混合一次 */
+    if (alpha && (cur != NULL) &&
+        (lv_obj_get_style_blend_mode(cur, LV_PART_MAIN) != LV_BLEND_MODE_NORMAL)) {
+        ++stat.unsupported;
+        return NULL;
+    }
+
+    const uint32_t line = lv_area_get_width(&layer_ctx->area_full) * sizeof(lv_color_t);
+    const uint32_t h    = lv_area_get_height(&layer_ctx->area_full);
+    const uint32_t draw =
+        _lv_refr_get_disp_refreshing()->driver->draw_buf->size * sizeof(lv_color_t);
+    const uint32_t want = LV_MIN(h * line, LV_MAX(draw, line));
+
+    lv_port_mem_stat mem;
+    lv_port_mem_info(&mem);
+    const uint32_t room = (mem.largest > LAYER_RESERVE) ? mem.largest - LAYER_RESERVE : 0;
+
+    /* 空闲块之外还有块头，申请失败时行数减半再试 */
+    uint32_t rows = LV_MAX(LV_MIN(want, room) / line, 1);
+    void *   buf  = lv_mem_alloc(rows * line);
+    while ((buf == NULL) && (rows > 1)) {
+        rows /= 2;
+        buf = lv_mem_alloc(rows * line);
+    }
+    if (buf == NULL) {
+        ++stat.fails;
+        return NULL;
+    }
+
+    lv_draw_sw_layer_ctx_t * const sw = (lv_draw_sw_layer_ctx_t *)layer_ctx;
+    sw->buf_size_bytes                = rows * line;
+    sw->has_alpha                     = 0;
+    layer_ctx->buf                    = buf;
+    layer_ctx->max_row_with_alpha     = rows;
+    layer_ctx->max_row_with_no_alpha  = rows;
+    layer_ctx->area_act               = layer_ctx->area_full;
+    layer_ctx->area_act.y2            = layer_ctx->area_full.y1;
+
+    ++stat.layers;
+    if (rows < h) {
+        stat.shrunk += (rows * line < want);
+        stat.min_rows = (stat.min_rows == 0) ? rows : LV_MIN(stat.min_rows, rows);
+    }
+    _peak(rows * line);
+    return layer_ctx;
+}
+
+/**
+ * @brief 把下面已经画好的内容复制进图层，作为这个条带的底色。
+ * @param layer_ctx 图层，area_act是这个条带。
+ * @retval
+ * @warning
+ * @note 普通图层的区域取自上一层的裁剪区域，一定落在上一层的缓冲区之内。
+ */
+static void _backdrop(const lv_draw_layer_ctx_t * const layer_ctx) {
+    const lv_area_t * const area  = &layer_ctx->area_act;
+    const lv_area_t * const under = layer_ctx->original.buf_area;
+    const lv_coord_t        w     = lv_area_get_width(area);
+    const lv_coord_t        step  = lv_area_get_width(under);
+
+    const lv_color_t * src = (const lv_color_t *)layer_ctx->original.buf +
+                             (area->y1 - under->y1) * step + (area->x1 - under->x1);
+    lv_color_t *       dst = layer_ctx->buf;
+    for (lv_coord_t y = area->y1; y <= area->y2; ++y) {
+        lv_memcpy(dst, src, w * sizeof(lv_color_t));
+        dst += w;
+        src += step;
+    }
+}
+
+/**
+ * @brief layer_adjust：开始绘制一个条带。
+ * @param draw_ctx 绘制上下文，此时指向上一层的缓冲区。
+ * @param layer_ctx 图层，area_act是这个条带。
+ * @param flags 这个条带是否需要透明度。
+ * @retval
+ * @warning
+ * @note 需要透明度时复制底色，图层本身始终不带透明度，由layer_blend按opa_layered混合。
+ */
+static void _adjust(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx,
+                    lv_draw_layer_flags_t flags) {
+    /* 异步的绘制可能还在写上一层的缓冲区或者图层 */
+    lv_draw_wait_for_finish(draw_ctx);
+
+    if (flags & LV_DRAW_LAYER_FLAG_HAS_ALPHA) {
+        _backdrop(layer_ctx);
+        ++stat.backdrops;
+    }
+    ++stat.slices;
+
+    ((lv_draw_sw_layer_ctx_t *)layer_ctx)->has_alpha       = 0;
+    _lv_refr_get_disp_refreshing()->driver->screen_transp = 0;
+
+    draw_ctx->buf       = layer_ctx->buf;
+    draw_ctx->buf_area  = &layer_ctx->area_act;
+    draw_ctx->clip_area = &layer_ctx->area_act;
+}
+
+static void _destroy(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx) {
+    LV_UNUSED(draw_ctx);
+    lv_mem_free(layer_ctx->buf);
+}
+
+/********** 导出的函数 **********/
+
+void lv_port_layer_init_ctx(lv_draw_ctx_t * draw_ctx) {
+    draw_ctx->layer_init          = _create;
+    draw_ctx->layer_adjust        = _adjust;
+    draw_ctx->layer_destroy       = _destroy;
+    draw_ctx->layer_instance_size = sizeof(lv_draw_sw_layer_ctx_t);
+}
+
+void lv_port_layer_obj_begin(lv_obj_t * obj) {
+    cur = obj;
+}
+
+void lv_port_layer_reset(void) {
+    lv_port_task_lock(-1);
+    lv_memset_00(&stat, sizeof(stat));
+    lv_port_task_unlock();
+}
+
+void lv_port_layer_info(lv_port_layer_stat * const s) {
+    lv_port_task_lock(-1);
+    *s = stat;
+    lv_port_task_unlock();
+}
+
+void lv_port_layer_print(int (*print)(const char * fmt, ...)) {
+    lv_port_layer_stat s;
+    lv_port_layer_info(&s);
+
+    print("%7s %7s %7s %7s %7s %7s %7s %7s %7s\n", "layers", "transf", "slices",
+          "backdrp", "shrunk", "fails", "unsupp", "peak", "rows");
+    print("%7u %7u %7u %7u %7u %7u %7u %7u %7u\n", s.layers, s.transforms, s.slices,
+          s.backdrops, s.shrunk, s.fails, s.unsupported, s.peak, s.min_rows);
+    if ((s.shrunk > 0) || (s.fails > 0) || (s.unsupported > 0)) {
+        print("degraded: %u layers sliced for lack of heap, %u not drawn\n", s.shrunk,
+              s.fails + s.unsupported);
+    }
+}
+
+#else
+
+void lv_port_layer_reset(void) {
+}
+
+void lv_port_layer_info(lv_port_layer_stat * const stat) {
+    lv_memset_00(stat, sizeof(*stat));
+}
+
+void lv_port_layer_print(int (*print)(const char * fmt, ...)) {
+    print("lv_port_layer disabled\n");
+}
+
+#endif  // LV_PORT_LAYER
+
+/********** 板上的MSH命令 **********/
+
+/**
+ * @brief lvlayer [reset]：查看图层的条带数与降级次数。
+ * @param argc 参数个数。
+ * @param argv reset：清空统计。
+ * @retval
+ * @warning
+ * @note
+ */
+static void lvlayer(int argc, char ** argv) {
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        lv_port_layer_reset();
+        return;
+    }
+    lv_port_layer_print(rt_kprintf);
+}
+MSH_CMD_EXPORT(lvlayer, lvgl layer slices and degradation : lvlayer[reset]);
@@ -0,0 +1,112 @@
+#ifndef LV_PORT_LAYER_H
+#define LV_PORT_LAYER_H
+
+/**
+ * @brief 这是LVGL图层缓冲区的按需分配模块。
+ * @details opa_layered小于255、blend_mode不是NORMAL的对象先画进一块图层再混合到下面，
+ * LVGL为此固定申请LV_LAYER_SIMPLE_BUF_SIZE字节，失败时退到FALLBACK的大小，
+ * 而且LV_COLOR_SCREEN_TRANSP为0时凡是需要透明度的图层（圆角、阴影等没有盖满的部分）一律放弃。
+ * 这里替换绘制上下文的layer_init、layer_adjust与layer_destroy：
+ * 普通图层每次按当前最大空闲块（留出LAYER_RESERVE）与绘制缓冲区的大小决定一次画多少行，
+ * 内存不够时就切成更多的水平条带分次绘制，一行也放不下时才放弃；
+ * 需要透明度时先把下面已经画好的内容复制进图层作为底色，对象画在底色上，
+ * 再按opa_layered整块混合回去，结果与带透明度的图层相同，每个像素仍然只占2字节。
+ * 变换图层（transform_angle/zoom）要取整块的源像素，不能切分，
+ * 只在不超过绘制缓冲区的大小并且申请得到时创建，否则放弃并计数。
+ * 板上通过MSH命令lvlayer查看图层个数、条带数与降级次数。
+ * @file lv_port_layer.h
+ * @author proyrb
+ * @date 2025/8/22
+ * @note 底色的做法只适用于NORMAL混合；需要透明度的其它混合模式与变换图层照旧放弃并计数。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <stdint.h>
+
+/********** 配置模块行为 **********/
+
+// 是否启用：0表示沿用LVGL的lv_draw_sw_layer
+#define LV_PORT_LAYER 1
+
+#ifdef LV_PORT_LAYER_C
+
+// 申请图层时在最大空闲块中留出的字节数，供绘制期间的蒙版、字形等临时缓冲区使用
+#    define LAYER_RESERVE (2 * 1024)
+
+#endif  // LV_PORT_LAYER_C
+
+/********** 统计结果 **********/
+
+typedef struct {
+    uint32_t layers;       // 创建的普通图层个数
+    uint32_t transforms;   // 创建的变换图层个数
+    uint32_t slices;       // 普通图层绘制的条带数
+    uint32_t backdrops;    // 其中复制了底色的条带数
+    uint32_t shrunk;       // 因为空闲内存不够而切得更细的图层个数
+    uint32_t fails;        // 内存不够或者变换图层太大、没有画出来的图层个数
+    uint32_t unsupported;  // 需要透明度而无法支持、没有画出来的图层个数
+    uint32_t peak;         // 最大的一块图层缓冲区的字节数
+    uint32_t min_rows;     // 切得最细时每个条带的行数，0表示还没有切过
+} lv_port_layer_stat;
+
+/********** 导出的函数 **********/
+
+#if LV_PORT_LAYER
+
+struct _lv_draw_ctx_t;
+struct _lv_obj_t;
+
+/**
+ * @brief 把绘制上下文的图层回调换成本模块的版本。
+ * @param draw_ctx 软件绘制上下文，layer_blend之外的图层回调会被替换。
+ * @retval
+ * @warning 在显示驱动的draw_ctx_init中调用，之后不要再改写这几个回调。
+ * @note layer_adjust中会先调用wait_for_finish，DMA等异步绘制不必再包一层等待。
+ */
+extern void lv_port_layer_init_ctx(struct _lv_draw_ctx_t * draw_ctx);
+
+/**
+ * @brief lv_refr.c的钩子，经由lv_port_refr.h调用，记下将要绘制的对象。
+ * @param obj 将要绘制的对象。
+ * @retval
+ * @warning 只能由lv_refr.c调用。
+ * @note 创建图层时据此取得对象的混合模式。
+ */
+extern void lv_port_layer_obj_begin(struct _lv_obj_t * obj);
+
+#else
+
+#    define lv_port_layer_init_ctx(draw_ctx) ((void)(draw_ctx))
+#    define lv_port_layer_obj_begin(obj)     ((void)0)
+
+#endif  // LV_PORT_LAYER
+
+/**
+ * @brief 清空统计。
+ * @param
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lv_port_layer_reset(void);
+
+/**
+ * @brief 取得统计。
+ * @param stat 统计结果。
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lv_port_layer_info(lv_port_layer_stat * const stat);
+
+/**
+ * @brief 打印统计。
+ * @param print 输出函数。
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lv_port_layer_print(int (*print)(const char * fmt, ...));
+
+#endif  // LV_PORT_LAYER_H
@@ -0,0 +1,124 @@
+#define LV_PORT_MEM_C
+
+#include <lv_port_mem.h>
+#include <rtthread.h>
+
+#if LV_PORT_MEM_ARENA && !defined(RT_USING_MEMHEAP)
+#    error "LV_PORT_MEM_ARENA needs RT_USING_MEMHEAP in rtconfig.h"
+#endif
+
+#if LV_PORT_MEM_ARENA
+static struct rt_memheap arena;
+static uint32_t          arena_buf[LV_PORT_MEM_ARENA / 4];
+#endif  // LV_PORT_MEM_ARENA
+
+// LVGL持有的块数与失败次数：只在LVGL线程中修改
+static uint32_t blocks;
+static uint32_t max_blocks;
+static uint32_t fails;
+
+/**
+ * @brief 记录一次申请的结果。
+ * @param ptr 申请到的地址。
+ * @param grown 是否新增了一块：realloc只在原地址为NULL时才算新增。
+ * @retval ptr。
+ * @warning
+ * @note
+ */
+static void * _mem_count(void * const ptr, const uint8_t grown) {
+    if (ptr == NULL) {
+        ++fails;
+    } else if (grown && (++blocks > max_blocks)) {
+        max_blocks = blocks;
+    }
+    return ptr;
+}
+
+/********** 导出的函数 **********/
+
+int lv_port_mem_init(void) {
+#if LV_PORT_MEM_ARENA
+    return rt_memheap_init(&arena, "lvgl", arena_buf, sizeof(arena_buf));
+#else
+    return RT_EOK;
+#endif  // LV_PORT_MEM_ARENA
+}
+
+void * lv_port_mem_alloc(size_t size) {
+#if LV_PORT_MEM_ARENA
+    return _mem_count(rt_memheap_alloc(&arena, size), 1);
+#else
+    return _mem_count(rt_malloc(size), 1);
+#endif  // LV_PORT_MEM_ARENA
+}
+
+void lv_port_mem_free(void * ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    --blocks;
+#if LV_PORT_MEM_ARENA
+    rt_memheap_free(ptr);
+#else
+    rt_free(ptr);
+#endif  // LV_PORT_MEM_ARENA
+}
+
+void * lv_port_mem_realloc(void * ptr, size_t size) {
+#if LV_PORT_MEM_ARENA
+    return _mem_count(rt_memheap_realloc(&arena, ptr, size), ptr == NULL);
+#else
+    return _mem_count(rt_realloc(ptr, size), ptr == NULL);
+#endif  // LV_PORT_MEM_ARENA
+}
+
+void lv_port_mem_info(lv_port_mem_stat * const stat) {
+    rt_size_t total, used, max_used;
+
+#if LV_PORT_MEM_ARENA
+    rt_memheap_info(&arena, &total, &used, &max_used);
+    stat->largest = rt_memheap_largest(&arena);
+#else
+    rt_memory_info(&total, &used, &max_used);
+    stat->largest = rt_memory_largest();
+#endif  // LV_PORT_MEM_ARENA
+
+    stat->total    = total;
+    stat->used     = used;
+    stat->max_used = max_used;
+
+    /* 与lv_mem_monitor相同的定义：空闲内存全在一块时为0 */
+    const uint32_t free = total - used;
+    stat->frag          = (free > 0) ? 100 - stat->largest * 100 / free : 0;
+
+    stat->blocks     = blocks;
+    stat->max_blocks = max_blocks;
+    stat->fails      = fails;
+}
+
+void lv_port_mem_print(int (*print)(const char * fmt, ...)) {
+    lv_port_mem_stat s;
+    lv_port_mem_info(&s);
+
+    print("%-6s %6s %6s %6s %6s %6s %4s %6s %5s\n", "heap", "total", "used", "peak",
+          "free", "large", "frag", "blocks", "fails");
+    print("%-6s %6u %6u %6u %6u %6u %3u%% %6u %5u\n",
+          LV_PORT_MEM_ARENA ? "lvgl" : "system", s.total, s.used, s.max_used,
+          s.total - s.used, s.largest, s.frag, s.blocks, s.fails);
+    print("lvgl peak blocks: %u\n", s.max_blocks);
+}
+
+/********** 板上的MSH命令 **********/
+
+/**
+ * @brief lvmem：查看LVGL所用堆的已用、空闲、最大空闲块与碎片率。
+ * @param argc 参数个数。
+ * @param argv
+ * @retval
+ * @warning
+ * @note
+ */
+static void lvmem(int argc, char ** argv) {
+    lv_port_mem_print(rt_kprintf);
+}
+MSH_CMD_EXPORT(lvmem, lvgl heap usage and fragmentation);
@@ -0,0 +1,104 @@
+#ifndef LV_PORT_MEM_H
+#define LV_PORT_MEM_H
+
+/**
+ * @brief 这是LVGL动态内存到RT-Thread的移植模块。
+ * @details lv_conf.h设置LV_MEM_CUSTOM为1，lv_mem_alloc等直接调用这里的函数，
+ * LVGL不再在.bss中保留自己的TLSF内存池（及其约1KB的分级空闲表），
+ * 省下的RAM由board.c自动并入系统堆，可以直接用来加大绘制缓冲区。
+ * 默认与RT-Thread共用系统堆；LV_PORT_MEM_ARENA不为0时改用一块专用的rt_memheap，
+ * 这样界面泄漏或碎片不会让其它线程申请失败，代价是两个分配器各自保留余量。
+ * 板上通过MSH命令lvmem查看已用、空闲、最大空闲块与碎片率。
+ * @file lv_port_mem.h
+ * @author proyrb
+ * @date 2025/8/19
+ * @note 共用系统堆时，已用与空闲统计的是整个系统堆，块数只统计LVGL持有的部分。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <stddef.h>
+#include <stdint.h>
+
+/********** 配置模块行为 **********/
+
+#ifdef LV_PORT_MEM_C
+
+// LVGL专用内存池的字节数：0表示与RT-Thread共用系统堆，
+// 非0时需要在rtconfig.h中启用RT_USING_MEMHEAP
+#    define LV_PORT_MEM_ARENA 0
+
+#endif  // LV_PORT_MEM_C
+
+/********** 统计结果 **********/
+
+typedef struct {
+    uint32_t total;       // 总字节数
+    uint32_t used;        // 已用字节数，包括块头
+    uint32_t max_used;    // 已用字节数的峰值
+    uint32_t largest;     // 最大空闲块的字节数，即当前能申请到的最大内存
+    uint32_t frag;        // 碎片率（%）：100 - 最大空闲块 * 100 / 空闲字节数
+    uint32_t blocks;      // LVGL当前持有的块数
+    uint32_t max_blocks;  // LVGL持有块数的峰值
+    uint32_t fails;       // 申请失败的次数
+} lv_port_mem_stat;
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 初始化专用内存池。
+ * @param
+ * @retval RT_EOK：成功。
+ * @retval <0：RT-Thread错误码。
+ * @warning 必须在lv_init之前调用；使用INIT_COMPONENT_EXPORT宏自动初始化。
+ * @note 共用系统堆时什么也不做。
+ */
+extern int lv_port_mem_init(void);
+
+/**
+ * @brief LV_MEM_CUSTOM_ALLOC的实现。
+ * @param size 字节数，lv_mem_alloc保证不为0。
+ * @retval 内存地址：NULL表示失败。
+ * @warning 只在LVGL线程中调用。
+ * @note
+ */
+extern void * lv_port_mem_alloc(size_t size);
+
+/**
+ * @brief LV_MEM_CUSTOM_FREE的实现。
+ * @param ptr 内存地址。
+ * @retval
+ * @warning 只在LVGL线程中调用。
+ * @note
+ */
+extern void lv_port_mem_free(void * ptr);
+
+/**
+ * @brief LV_MEM_CUSTOM_REALLOC的实现。
+ * @param ptr 原来的内存地址。
+ * @param size 新的字节数，lv_mem_realloc保证不为0。
+ * @retval 新的内存地址：NULL表示失败，原来的内存不变。
+ * @warning 只在LVGL线程中调用。
+ * @note
+ */
+extern void * lv_port_mem_realloc(void * ptr, size_t size);
+
+/**
+ * @brief 取得内存统计。
+ * @param stat 统计结果。
+ * @retval
+ * @warning 线程安全。
+ * @note 最大空闲块需要遍历空闲链表，耗时与空闲块数成正比。
+ */
+extern void lv_port_mem_info(lv_port_mem_stat * const stat);
+
+/**
+ * @brief 打印内存统计。
+ * @param print 输出函数。
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lv_port_mem_print(int (*print)(const char * fmt, ...));
+
+#endif  // LV_PORT_MEM_H
@@ -0,0 +1,533 @@
+#define LV_PORT_PROF_C
+
+#include <lv_port_prof.h>
+#include <lv_port_task.h>
+#include <lvgl.h>
+#include <src/draw/sw/lv_draw_sw.h>
+#include <sc32_conf.h>
+#include <rtthread.h>
+#include <stdlib.h>
+
+#if LV_PORT_PROF
+
+/* 一项统计：时间以SysTick计数为单位，打印时再换算成微秒 */
+typedef struct {
+    const void * key;     // 对象类；绘制原语与空项为NULL
+    uint32_t     calls;   // 调用次数
+    uint64_t     counts;  // 自身耗时
+    uint32_t     max;     // 单次最长耗时，包括嵌套在里面的部分
+} prof_row;
+
+/* 一层正在计时的调用 */
+typedef struct {
+    prof_row * row;
+    uint32_t   start;  // 进入时的时间戳
+} prof_scope;
+
+/* 对象类的名字 */
+typedef struct {
+    const struct _lv_obj_class_t * cls;
+    const char *                   name;
+} prof_name;
+
+static prof_row   classes[PROF_CLASS_CNT];
+static prof_row   draws[LV_PORT_PROF_DRAW_CNT];
+static prof_row   frame;  // 自身耗时是不属于任何对象与flush_cb的时间
+static prof_row   flush;
+static prof_name  names[PROF_NAME_CNT] = {{&lv_obj_class, "obj"}};
+static prof_scope objs[PROF_DEPTH];        // 帧、对象、flush_cb共用一个栈
+static prof_scope calls[PROF_DRAW_DEPTH];  // 绘制回调的栈
+static uint32_t   obj_depth  = 0;          // 可能超过PROF_DEPTH，超出的层不计时
+static uint32_t   draw_depth = 0;
+static uint32_t   obj_mark   = 0;  // 上一次把时间记到objs栈顶的时刻
+static uint32_t   draw_mark  = 0;
+static uint32_t   frames     = 0;
+
+static const char * const draw_name[LV_PORT_PROF_DRAW_CNT] = {
+    "rect", "bg", "arc", "img", "letter", "line", "polygon", "transform", "layer",
+    "blend", "wait"};
+
+/* 被替换的绘制回调 */
+static lv_draw_sw_ctx_t      orig;
+static const lv_draw_ctx_t * wrapped = NULL;  // 已经换过回调的绘制上下文
+
+/********** 时间戳 **********/
+
+/**
+ * @brief 由tick与SysTick计数值组合出以SysTick计数为单位的时间戳。
+ * @param
+ * @retval 时间戳，允许回绕。
+ * @warning
+ * @note 读取期间发生tick更新时重新读取；board.c中SysTick的时钟是HCLK/8，
+ * 一个计数是8个HCLK周期。
+ */
+static uint32_t _now(void) {
+    rt_tick_t tick;
+    uint32_t  val;
+    do {
+        tick = rt_tick_get();
+        val  = SysTick->VAL;
+    } while (tick != rt_tick_get());
+
+    return tick * (SysTick->LOAD + 1) + (SysTick->LOAD - val);
+}
+
+/**
+ * @brief 把SysTick计数换算成微秒。
+ * @param counts 计数。
+ * @retval 微秒数。
+ * @warning
+ * @note 每微秒的计数由每个tick的计数得出，与SysTick的时钟源无关。
+ */
+static uint32_t _us(const uint64_t counts) {
+    const uint32_t per_us = (SysTick->LOAD + 1) / (1000000 / RT_TICK_PER_SECOND);
+    return (uint32_t)(counts / per_us);
+}
+
+/********** 自身耗时 **********/
+
+/**
+ * @brief 进入一层调用：到目前为止的时间记到外层，再把这一层压栈。
+ * @param stack 栈。
+ * @param cap 栈的容量。
+ * @param depth 当前层数。
+ * @param mark 上一次记账的时刻。
+ * @param row 这一层的统计项。
+ * @retval
+ * @warning
+ * @note 栈满后不再压栈也不记账，时间留给栈顶一层。
+ */
+static void _enter(prof_scope * const stack,
+                   const uint32_t     cap,
+                   uint32_t * const   depth,
+                   uint32_t * const   mark,
+                   prof_row * const   row) {
+    if (*depth >= cap) {
+        ++*depth;
+        return;
+    }
+    const uint32_t now = _now();
+    if (*depth > 0) {
+        stack[*depth - 1].row->counts += now - *mark;
+    }
+    stack[*depth].row   = row;
+    stack[*depth].start = now;
+    ++*depth;
+    ++row->calls;
+    *mark = now;
+}
+
+/**
+ * @brief 离开一层调用：这一层的剩余时间记到它自己，再出栈。
+ * @param stack 栈。
+ * @param cap 栈的容量。
+ * @param depth 当前层数。
+ * @param mark 上一次记账的时刻。
+ * @retval
+ * @warning
+ * @note
+ */
+static void _leave(prof_scope * const stack,
+                   const uint32_t     cap,
+                   uint32_t * const   depth,
+                   uint32_t * const   mark) {
+    if (*depth == 0) {
+        return;
+    }
+    if (--*depth >= cap) {
+        return;
+    }
+    const uint32_t           now = _now();
+    const prof_scope * const s   = &stack[*depth];
+    const uint32_t           all = now - s->start;
+    s->row->counts += now - *mark;
+    s->row->max = (all > s->row->max) ? all : s->row->max;
+    *mark       = now;
+}
+
+#    define OBJ_ENTER(row) _enter(objs, PROF_DEPTH, &obj_depth, &obj_mark, (row))
+#    define OBJ_LEAVE()    _leave(objs, PROF_DEPTH, &obj_depth, &obj_mark)
+#    define DRAW_ENTER(i) \
+        _enter(calls, PROF_DRAW_DEPTH, &draw_depth, &draw_mark, &draws[(i)])
+#    define DRAW_LEAVE() _leave(calls, PROF_DRAW_DEPTH, &draw_depth, &draw_mark)
+
+/********** 计时的绘制回调 **********/
+
+static void _draw_rect(lv_draw_ctx_t *            draw_ctx,
+                       const lv_draw_rect_dsc_t * dsc,
+                       const lv_area_t *          coords) {
+    DRAW_ENTER(LV_PORT_PROF_RECT);
+    orig.base_draw.draw_rect(draw_ctx, dsc, coords);
+    DRAW_LEAVE();
+}
+
+static void _draw_bg(lv_draw_ctx_t *            draw_ctx,
+                     const lv_draw_rect_dsc_t * dsc,
+                     const lv_area_t *          coords) {
+    DRAW_ENTER(LV_PORT_PROF_BG);
+    orig.base_draw.draw_bg(draw_ctx, dsc, coords);
+    DRAW_LEAVE();
+}
+
+static void _draw_arc(lv_draw_ctx_t *           draw_ctx,
+                      const lv_draw_arc_dsc_t * dsc,
+                      const lv_point_t *        center,
+                      uint16_t                  radius,
+                      uint16_t                  start_angle,
+                      uint16_t                  end_angle) {
+    DRAW_ENTER(LV_PORT_PROF_ARC);
+    orig.base_draw.draw_arc(draw_ctx, dsc, center, radius, start_angle, end_angle);
+    DRAW_LEAVE();
+}
+
+static void _draw_img(lv_draw_ctx_t *           draw_ctx,
+                      const lv_draw_img_dsc_t * dsc,
+                      const lv_area_t *         coords,
+                      const uint8_t *           map_p,
+                      lv_img_cf_t               color_format) {
+    DRAW_ENTER(LV_PORT_PROF_IMG);
+    orig.base_draw.draw_img_decoded(draw_ctx, dsc, coords, map_p, color_format);
+    DRAW_LEAVE();
+}
+
+static void _draw_letter(lv_draw_ctx_t *             draw_ctx,
+                         const lv_draw_label_dsc_t * dsc,
+                         const lv_point_t *          pos_p,
+                         uint32_t                    letter) {
+    DRAW_ENTER(LV_PORT_PROF_LETTER);
+    orig.base_draw.draw_letter(draw_ctx, dsc, pos_p, letter);
+    DRAW_LEAVE();
+}
+
+static void _draw_line(lv_draw_ctx_t *            draw_ctx,
+                       const lv_draw_line_dsc_t * dsc,
+                       const lv_point_t *         point1,
+                       const lv_point_t *         point2) {
+    DRAW_ENTER(LV_PORT_PROF_LINE);
+    orig.base_draw.draw_line(draw_ctx, dsc, point1, point2);
+    DRAW_LEAVE();
+}
+
+static void _draw_polygon(lv_draw_ctx_t *            draw_ctx,
+                          const lv_draw_rect_dsc_t * dsc,
+                          const lv_point_t *         points,
+                          uint16_t                   point_cnt) {
+    DRAW_ENTER(LV_PORT_PROF_POLYGON);
+    orig.base_draw.draw_polygon(draw_ctx, dsc, points, point_cnt);
+    DRAW_LEAVE();
+}
+
+static void _draw_transform(lv_draw_ctx_t *           draw_ctx,
+                            const lv_area_t *         dest_area,
+                            const void *              src_buf,
+                            lv_coord_t                src_w,
+                            lv_coord_t                src_h,
+                            lv_coord_t                src_stride,
+                            const lv_draw_img_dsc_t * dsc,
+                            lv_img_cf_t               cf,
+                            lv_color_t *              cbuf,
+                            lv_opa_t *                abuf) {
+    DRAW_ENTER(LV_PORT_PROF_TRANSFORM);
+    orig.base_draw.draw_transform(draw_ctx, dest_area, src_buf, src_w, src_h, src_stride,
+                                  dsc, cf, cbuf, abuf);
+    DRAW_LEAVE();
+}
+
+static void _layer_blend(lv_draw_ctx_t *           draw_ctx,
+                         lv_draw_layer_ctx_t *     layer_ctx,
+                         const lv_draw_img_dsc_t * dsc) {
+    DRAW_ENTER(LV_PORT_PROF_LAYER);
+    orig.base_draw.layer_blend(draw_ctx, layer_ctx, dsc);
+    DRAW_LEAVE();
+}
+
+static void _blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc) {
+    DRAW_ENTER(LV_PORT_PROF_BLEND);
+    orig.blend(draw_ctx, dsc);
+    DRAW_LEAVE();
+}
+
+static void _wait_for_finish(lv_draw_ctx_t * draw_ctx) {
+    DRAW_ENTER(LV_PORT_PROF_WAIT);
+    orig.base_draw.wait_for_finish(draw_ctx);
+    DRAW_LEAVE();
+}
+
+/**
+ * @brief 把绘制上下文中的回调换成计时的版本，原来的回调保存在orig中。
+ * @param disp 显示。
+ * @retval
+ * @warning
+ * @note 只换第一个显示的绘制上下文，不是软件绘制上下文时什么也不做；
+ * 为NULL的回调保持为NULL。
+ */
+static void _wrap(lv_disp_t * const disp) {
+    lv_draw_sw_ctx_t * const ctx = (lv_draw_sw_ctx_t *)disp->driver->draw_ctx;
+    if ((wrapped != NULL) || (ctx == NULL) ||
+        (disp->driver->draw_ctx_size < sizeof(lv_draw_sw_ctx_t))) {
+        return;
+    }
+    orig    = *ctx;
+    wrapped = &ctx->base_draw;
+
+#    define WRAP(cb, fn)  \
+        if (ctx->cb != NULL) { \
+            ctx->cb = fn;      \
+        }
+    WRAP(base_draw.draw_rect, _draw_rect);
+    WRAP(base_draw.draw_bg, _draw_bg);
+    WRAP(base_draw.draw_arc, _draw_arc);
+    WRAP(base_draw.draw_img_decoded, _draw_img);
+    WRAP(base_draw.draw_letter, _draw_letter);
+    WRAP(base_draw.draw_line, _draw_line);
+    WRAP(base_draw.draw_polygon, _draw_polygon);
+    WRAP(base_draw.draw_transform, _draw_transform);
+    WRAP(base_draw.layer_blend, _layer_blend);
+    WRAP(base_draw.wait_for_finish, _wait_for_finish);
+    WRAP(blend, _blend);
+#    undef WRAP
+}
+
+/********** lv_refr.c的钩子 **********/
+
+void lv_port_prof_frame_begin(lv_disp_t * disp) {
+    _wrap(disp);
+    ++frames;
+    OBJ_ENTER(&frame);
+}
+
+void lv_port_prof_frame_end(void) {
+    OBJ_LEAVE();
+}
+
+/**
+ * @brief 查找对象类的统计项。
+ * @param cls 对象类。
+ * @retval 统计项。
+ * @warning
+ * @note 找不到时占用空项，表满时记在第0项。
+ */
+static prof_row * _class_row(const void * const cls) {
+    uint32_t i = 1;
+    while ((i < PROF_CLASS_CNT) && (classes[i].key != NULL) && (classes[i].key != cls)) {
+        ++i;
+    }
+    if (i == PROF_CLASS_CNT) {
+        return &classes[0];
+    }
+    classes[i].key = cls;
+    return &classes[i];
+}
+
+void lv_port_prof_obj_begin(const lv_obj_t * obj) {
+    OBJ_ENTER(_class_row(obj->class_p));
+}
+
+void lv_port_prof_obj_end(void) {
+    OBJ_LEAVE();
+}
+
+void lv_port_prof_flush_begin(void) {
+    OBJ_ENTER(&flush);
+}
+
+void lv_port_prof_flush_end(void) {
+    OBJ_LEAVE();
+}
+
+void lv_port_prof_name(const lv_obj_class_t * const cls, const char * const name) {
+    for (uint32_t i = 0; i < PROF_NAME_CNT; ++i) {
+        if ((names[i].cls == NULL) || (names[i].cls == cls)) {
+            names[i].cls  = cls;
+            names[i].name = name;
+            return;
+        }
+    }
+}
+
+/********** 查看结果 **********/
+
+void lv_port_prof_reset(void) {
+    lv_port_task_lock(-1);
+    memset(classes, 0, sizeof(classes));
+    memset(draws, 0, sizeof(draws));
+    memset(&frame, 0, sizeof(frame));
+    memset(&flush, 0, sizeof(flush));
+    frames = 0;
+    lv_port_task_unlock();
+}
+
+/**
+ * @brief 不加锁地计算总计。
+ * @param s 统计结果。
+ * @retval
+ * @warning 调用者持有LVGL的锁。
+ * @note
+ */
+static void _info(lv_port_prof_stat * const s) {
+    uint64_t obj  = 0;
+    uint64_t draw = 0;
+    for (uint32_t i = 0; i < PROF_CLASS_CNT; ++i) {
+        obj += classes[i].counts;
+    }
+    for (uint32_t i = 0; i < LV_PORT_PROF_DRAW_CNT; ++i) {
+        draw += draws[i].counts;
+    }
+    s->frames   = frames;
+    s->us       = _us(frame.counts + flush.counts + obj);
+    s->max_us   = _us(frame.max);
+    s->self_us  = _us(frame.counts);
+    s->flushes  = flush.calls;
+    s->start_us = _us(flush.counts);
+    s->obj_us   = _us(obj);
+    s->draw_us  = _us(draw);
+}
+
+void lv_port_prof_info(lv_port_prof_stat * const stat) {
+    lv_port_task_lock(-1);
+    _info(stat);
+    lv_port_task_unlock();
+}
+
+/**
+ * @brief 按自身耗时从高到低排列统计项的下标。
+ * @param rows 统计项。
+ * @param cnt 项数。
+ * @param order 排列结果。
+ * @retval 有调用记录的项数。
+ * @warning
+ * @note 项数很少，用选择排序。
+ */
+static uint32_t _sort(const prof_row * const rows,
+                      const uint32_t         cnt,
+                      uint8_t * const        order) {
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < cnt; ++i) {
+        if (rows[i].calls > 0) {
+            order[used++] = (uint8_t)i;
+        }
+    }
+    for (uint32_t i = 0; i < used; ++i) {
+        uint32_t most = i;
+        for (uint32_t j = i + 1; j < used; ++j) {
+            most = (rows[order[j]].counts > rows[order[most]].counts) ? j : most;
+        }
+        const uint8_t t = order[i];
+        order[i]        = order[most];
+        order[most]     = t;
+    }
+    return used;
+}
+
+/**
+ * @brief 打印一项。
+ * @param print 输出函数。
+ * @param name 名字，NULL时打印key的地址。
+ * @param r 统计项。
+ * @param total 总渲染耗时（us），用于计算占比。
+ * @retval
+ * @warning
+ * @note
+ */
+static void _print_row(int (*print)(const char * fmt, ...),
+                       const char * const     name,
+                       const prof_row * const r,
+                       const uint32_t         total) {
+    const uint32_t us = _us(r->counts);
+    if (name != NULL) {
+        print("%-13s", name);
+    } else {
+        print("0x%08x   ", (uint32_t)(uintptr_t)r->key);
+    }
+    print(" %8u %10u %4u%% %8u %6u\n", r->calls, us,
+          (total == 0) ? 0 : (uint32_t)(100ULL * us / total), _us(r->max),
+          (r->calls == 0) ? 0 : us / r->calls);
+}
+
+/**
+ * @brief 取得对象类的名字。
+ * @param cls 对象类。
+ * @retval 名字，没有取名时为NULL。
+ * @warning
+ * @note
+ */
+static const char * _class_name(const void * const cls) {
+    if (cls == NULL) {
+        return "(other)";
+    }
+    for (uint32_t i = 0; (i < PROF_NAME_CNT) && (names[i].cls != NULL); ++i) {
+        if (names[i].cls == cls) {
+            return names[i].name;
+        }
+    }
+    return NULL;
+}
+
+void lv_port_prof_print(int (*print)(const char * fmt, ...), const uint32_t top) {
+    uint8_t order[(PROF_CLASS_CNT > LV_PORT_PROF_DRAW_CNT) ? PROF_CLASS_CNT
+                                                           : LV_PORT_PROF_DRAW_CNT];
+
+    lv_port_task_lock(-1);
+
+    lv_port_prof_stat s;
+    _info(&s);
+    print("%8s %10s %8s %8s %8s %10s %10s %10s\n", "frames", "us", "avg", "max",
+          "flushes", "start_us", "obj_us", "draw_us");
+    print("%8u %10u %8u %8u %8u %10u %10u %10u\n", s.frames, s.us,
+          (s.frames == 0) ? 0 : s.us / s.frames, s.max_us, s.flushes, s.start_us,
+          s.obj_us, s.draw_us);
+
+    const char * const head = "%-13s %8s %10s %5s %8s %6s\n";
+    print(head, "class", "calls", "self_us", "share", "max", "avg");
+    uint32_t used = _sort(classes, PROF_CLASS_CNT, order);
+    used          = ((top == 0) || (top > used)) ? used : top;
+    for (uint32_t i = 0; i < used; ++i) {
+        const prof_row * const r = &classes[order[i]];
+        _print_row(print, _class_name(r->key), r, s.us);
+    }
+    _print_row(print, "(refresh)", &frame, s.us);
+    _print_row(print, "(flush start)", &flush, s.us);
+
+    print(head, "draw", "calls", "self_us", "share", "max", "avg");
+    used = _sort(draws, LV_PORT_PROF_DRAW_CNT, order);
+    used = ((top == 0) || (top > used)) ? used : top;
+    for (uint32_t i = 0; i < used; ++i) {
+        _print_row(print, draw_name[order[i]], &draws[order[i]], s.us);
+    }
+
+    lv_port_task_unlock();
+}
+
+#else
+
+void lv_port_prof_reset(void) {
+}
+
+void lv_port_prof_info(lv_port_prof_stat * const stat) {
+    memset(stat, 0, sizeof(*stat));
+}
+
+void lv_port_prof_print(int (*print)(const char * fmt, ...), const uint32_t top) {
+    print("lv_port_prof disabled\n");
+}
+
+#endif  // LV_PORT_PROF
+
+/********** 板上的MSH命令 **********/
+
+/**
+ * @brief lvprof [reset|n]：按自身耗时从高到低打印对象类与绘制原语。
+ * @param argc 参数个数。
+ * @param argv reset：清空统计；n：各打印前n项，默认为8。
+ * @retval
+ * @warning
+ * @note
+ */
+static void lvprof(int argc, char ** argv) {
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        lv_port_prof_reset();
+        return;
+    }
+    lv_port_prof_print(rt_kprintf, (argc > 1) ? (uint32_t)atoi(argv[1]) : 8);
+}
+MSH_CMD_EXPORT(lvprof, lvgl render time per class and draw call : lvprof[reset | n]);
@@ -0,0 +1,151 @@
+#ifndef LV_PORT_PROF_H
+#define LV_PORT_PROF_H
+
+/**
+ * @brief 这是LVGL的渲染耗时统计模块。
+ * @details LV_USE_PERF_MONITOR只给出帧率与CPU占用，看不出是哪个控件、哪种绘制最费时间。
+ * lv_refr.c经由lv_port_refr.h在三处调用这里的钩子：
+ * refr_invalid_areas前后（一帧）、每次refr_obj前后（一个对象）、call_flush_cb中flush_cb前后。
+ * 第一帧开始时还把显示的绘制上下文中的各个绘制回调与blend、wait_for_finish换成计时的版本。
+ * 时间戳取自SysTick，分辨率是一个SysTick计数：board.c中SysTick的时钟是HCLK/8，即8个HCLK周期。
+ * 对象与绘制原语都按自身耗时统计：子对象、嵌套调用的blend等的时间从外层扣除，
+ * 所以各项相加等于总渲染时间，没有重复计算。对象按类（lv_obj_class_t）汇总。
+ * ST7789V的flush_cb只启动DMA传输就返回，flush一项只是启动传输的时间（flush start），
+ * 传输本身与LVGL等待它完成的时间算在帧的自身耗时里。
+ * 板上通过MSH命令lvprof按耗时从高到低打印。
+ * @file lv_port_prof.h
+ * @author proyrb
+ * @date 2025/8/21
+ * @note 图片解码、文字排版等不经过绘制回调的工作算在对象自身；
+ * 只计时第一个显示的绘制上下文。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <stdint.h>
+
+/********** 配置模块行为 **********/
+
+// 是否启用统计：0表示钩子为空，lv_refr.c与绘制回调不再计时
+#define LV_PORT_PROF 1
+
+#ifdef LV_PORT_PROF_C
+
+// 可以分别统计的对象类个数，超出的类记在第0项
+#    define PROF_CLASS_CNT 16
+
+// 可以命名的对象类个数
+#    define PROF_NAME_CNT 16
+
+// 跟踪的对象嵌套层数，更深的子对象算在第这么多层的对象上
+#    define PROF_DEPTH 12
+
+// 跟踪的绘制回调嵌套层数
+#    define PROF_DRAW_DEPTH 4
+
+#endif  // LV_PORT_PROF_C
+
+/********** 绘制原语 **********/
+
+#define LV_PORT_PROF_RECT      0   // draw_rect
+#define LV_PORT_PROF_BG        1   // draw_bg
+#define LV_PORT_PROF_ARC       2   // draw_arc
+#define LV_PORT_PROF_IMG       3   // draw_img_decoded
+#define LV_PORT_PROF_LETTER    4   // draw_letter
+#define LV_PORT_PROF_LINE      5   // draw_line
+#define LV_PORT_PROF_POLYGON   6   // draw_polygon
+#define LV_PORT_PROF_TRANSFORM 7   // draw_transform
+#define LV_PORT_PROF_LAYER     8   // layer_blend
+#define LV_PORT_PROF_BLEND     9   // lv_draw_sw_ctx_t的blend
+#define LV_PORT_PROF_WAIT      10  // wait_for_finish
+#define LV_PORT_PROF_DRAW_CNT  11
+
+/********** 统计结果 **********/
+
+typedef struct {
+    uint32_t frames;    // 渲染的帧数
+    uint32_t us;        // 累计渲染耗时
+    uint32_t max_us;    // 最长一帧的耗时
+    uint32_t self_us;   // 其中不属于任何对象与flush_cb的时间：合并区域、等待刷新完成等
+    uint32_t flushes;   // 调用flush_cb的次数
+    uint32_t start_us;  // 在flush_cb中的时间：只是启动传输，不包括传输本身
+    uint32_t obj_us;    // 所有对象的自身耗时之和，包括绘制原语
+    uint32_t draw_us;   // 所有绘制原语的自身耗时之和
+} lv_port_prof_stat;
+
+/********** 导出的函数 **********/
+
+#if LV_PORT_PROF
+
+struct _lv_disp_t;
+struct _lv_obj_t;
+struct _lv_obj_class_t;
+
+/**
+ * @brief lv_refr.c的钩子，经由lv_port_refr.h调用。
+ * @param disp 正在刷新的显示。
+ * @param obj 正在绘制的对象。
+ * @retval
+ * @warning 只能由lv_refr.c调用。
+ * @note
+ */
+extern void lv_port_prof_frame_begin(struct _lv_disp_t * disp);
+extern void lv_port_prof_frame_end(void);
+extern void lv_port_prof_obj_begin(const struct _lv_obj_t * obj);
+extern void lv_port_prof_obj_end(void);
+extern void lv_port_prof_flush_begin(void);
+extern void lv_port_prof_flush_end(void);
+
+/**
+ * @brief 给对象类取名，打印时代替地址。
+ * @param cls 对象类，例如&lv_label_class。
+ * @param name 名字，必须一直有效。
+ * @retval
+ * @warning 只在LVGL线程中调用，或者先调用lv_port_task_lock。
+ * @note lv_obj_class已经有名字；名字表满后忽略。
+ * 模块本身不引用各控件的类，避免把没有用到的控件链接进来。
+ */
+extern void lv_port_prof_name(const struct _lv_obj_class_t * const cls,
+                              const char * const               name);
+
+#else
+
+#    define lv_port_prof_frame_begin(disp) ((void)0)
+#    define lv_port_prof_frame_end()       ((void)0)
+#    define lv_port_prof_obj_begin(obj)    ((void)0)
+#    define lv_port_prof_obj_end()         ((void)0)
+#    define lv_port_prof_flush_begin()     ((void)0)
+#    define lv_port_prof_flush_end()       ((void)0)
+#    define lv_port_prof_name(cls, name)   ((void)(cls), (void)(name))
+
+#endif  // LV_PORT_PROF
+
+/**
+ * @brief 清空统计。
+ * @param
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lv_port_prof_reset(void);
+
+/**
+ * @brief 取得总计。
+ * @param stat 统计结果。
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lv_port_prof_info(lv_port_prof_stat * const stat);
+
+/**
+ * @brief 打印总计，以及自身耗时最多的对象类与绘制原语。
+ * @param print 输出函数。
+ * @param top 各打印多少项，0表示全部。
+ * @retval
+ * @warning 线程安全。
+ * @note
+ */
+extern void lv_port_prof_print(int (*print)(const char * fmt, ...), const uint32_t top);
+
+#endif  // LV_PORT_PROF_H
@@ -0,0 +1,58 @@
+#ifndef LV_PORT_REFR_H
+#define LV_PORT_REFR_H
+
+/**
+ * @brief 这是lv_refr.c中各个钩子的汇总。
+ * @details lv_conf.h把LV_REFR_HOOK_INCLUDE设为本头文件，lv_refr.c在一帧、每个对象、
+ * 每次flush_cb的前后展开这里的宏，宏再依次调用lv_port_prof（计时）与lv_port_cull（剔除）；
+ * 进入对象时还告诉lv_port_layer将要绘制的对象，创建图层时要用到它的混合模式。
+ * 进入对象时先计时再找遮挡物，离开时反过来，所以找遮挡物的开销算在对象名下；
+ * 一帧开始时lv_port_cull先换blend，lv_port_prof后换，计时的blend在外层。
+ * @file lv_port_refr.h
+ * @author proyrb
+ * @date 2025/8/21
+ * @note 宏在lv_refr.c中展开，可以直接使用LVGL的函数。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <lv_port_cull.h>
+#include <lv_port_layer.h>
+#include <lv_port_prof.h>
+
+/********** lv_refr.c的钩子 **********/
+
+#define LV_REFR_FRAME_BEGIN(disp)          \
+    do {                                   \
+        lv_port_cull_frame_begin(disp);    \
+        lv_port_prof_frame_begin(disp);    \
+    } while (0)
+
+#define LV_REFR_FRAME_END(disp)            \
+    do {                                   \
+        lv_port_prof_frame_end();          \
+        lv_port_cull_frame_end();          \
+    } while (0)
+
+#define LV_REFR_OBJ_BEGIN(draw_ctx, obj)         \
+    do {                                         \
+        lv_port_prof_obj_begin(obj);             \
+        lv_port_cull_obj_begin(draw_ctx, obj);   \
+        lv_port_layer_obj_begin(obj);            \
+    } while (0)
+
+#define LV_REFR_OBJ_END(draw_ctx, obj)     \
+    do {                                   \
+        lv_port_cull_obj_end();            \
+        lv_port_prof_obj_end();            \
+    } while (0)
+
+#define LV_REFR_FLUSH_BEGIN(drv, area)                   \
+    do {                                                 \
+        lv_port_cull_flush(lv_area_get_size(area));      \
+        lv_port_prof_flush_begin();                      \
+    } while (0)
+
+#define LV_REFR_FLUSH_END(drv, area) lv_port_prof_flush_end()
+
+#endif  // LV_PORT_REFR_H
@@ -0,0 +1,111 @@
+#define LV_PORT_TASK_C
+
+#include <lv_port_task.h>
+#include <lvgl.h>
+#include <rtthread.h>
+#include <rthw.h>
+
+#if LV_TICK_CUSTOM == 0
+#    error "lv_port_task needs LV_TICK_CUSTOM 1 in lv_conf.h"
+#endif
+
+static struct rt_mutex     lv_lock;  // 保护LVGL的全部状态（可递归）
+static struct rt_semaphore wake;     // 提前唤醒LVGL线程
+static lv_port_task_stat   stat;     // 只在LVGL线程中修改
+
+/**
+ * @brief LVGL线程：运行lv_timer_handler，然后正好睡到下一个定时器到期。
+ * @param parameter 暂时没有使用。
+ * @retval
+ * @warning
+ * @note 运行之前先清空唤醒信号：运行期间到来的唤醒会让下一次睡眠立即返回。
+ */
+static void _lv_port_task(void * parameter) {
+    while (1) {
+        while (rt_sem_trytake(&wake) == RT_EOK) {}
+
+        rt_mutex_take(&lv_lock, RT_WAITING_FOREVER);
+        const rt_tick_t start = rt_tick_get();
+        const uint32_t  sleep = lv_timer_handler();
+        stat.busy_ms += (rt_tick_get() - start) * (1000 / RT_TICK_PER_SECOND);
+        rt_mutex_release(&lv_lock);
+
+        ++stat.runs;
+        stat.sleep = sleep;
+        if (sleep == LV_NO_TIMER_READY) {
+            ++stat.forever;
+            rt_sem_take(&wake, RT_WAITING_FOREVER);
+            ++stat.wakes;
+        } else if (rt_sem_take(&wake, rt_tick_from_millisecond((rt_int32_t)sleep)) ==
+                   RT_EOK) {
+            ++stat.wakes;
+        } else {
+            ++stat.expires;
+        }
+    }
+}
+
+/********** 导出的函数 **********/
+
+int lv_port_task_init(void) {
+    rt_mutex_init(&lv_lock, "lvgl", RT_IPC_FLAG_PRIO);
+    rt_sem_init(&wake, "lvwake", 0, RT_IPC_FLAG_FIFO);
+    lv_init();
+
+    rt_thread_t tid =
+        rt_thread_create("lvgl", _lv_port_task, RT_NULL, LVGL_STACK_SIZE, LVGL_PRIORITY,
+                         LVGL_TICK);
+    if (tid == RT_NULL) {
+        return -RT_ENOMEM;
+    }
+    return rt_thread_startup(tid);
+}
+
+int lv_port_task_lock(const int32_t timeout_ms) {
+    return rt_mutex_take(&lv_lock, rt_tick_from_millisecond(timeout_ms));
+}
+
+void lv_port_task_unlock(void) {
+    rt_mutex_release(&lv_lock);
+    lv_port_task_wake();
+}
+
+void lv_port_task_wake(void) {
+    rt_sem_release(&wake);
+}
+
+void lv_port_task_info(lv_port_task_stat * const s) {
+    rt_base_t level = rt_hw_interrupt_disable();
+    *s              = stat;
+    rt_hw_interrupt_enable(level);
+}
+
+void lv_port_task_print(int (*print)(const char * fmt, ...)) {
+    lv_port_task_stat s;
+    lv_port_task_info(&s);
+
+    print("%8s %8s %8s %8s %10s %6s %5s\n", "runs", "wakes", "expires", "forever",
+          "busy(ms)", "sleep", "idle");
+    if (s.sleep == LV_NO_TIMER_READY) {
+        print("%8u %8u %8u %8u %10u %6s %4u%%\n", s.runs, s.wakes, s.expires, s.forever,
+              s.busy_ms, "-", lv_timer_get_idle());
+    } else {
+        print("%8u %8u %8u %8u %10u %6u %4u%%\n", s.runs, s.wakes, s.expires, s.forever,
+              s.busy_ms, s.sleep, lv_timer_get_idle());
+    }
+}
+
+/********** 板上的MSH命令 **********/
+
+/**
+ * @brief lvtask：查看LVGL线程的运行与唤醒次数。
+ * @param argc 参数个数。
+ * @param argv
+ * @retval
+ * @warning
+ * @note
+ */
+static void lvtask(int argc, char ** argv) {
+    lv_port_task_print(rt_kprintf);
+}
+MSH_CMD_EXPORT(lvtask, lvgl thread runs and wakeups);
@@ -0,0 +1,103 @@
+#ifndef LV_PORT_TASK_H
+#define LV_PORT_TASK_H
+
+/**
+ * @brief 这是LVGL在RT-Thread上的时基与任务移植模块。
+ * @details lv_conf.h把LV_TICK_CUSTOM设为1，LVGL直接读取rt_tick_get_millisecond，
+ * 不再需要在中断里调用lv_tick_inc。
+ * 模块启动一个LVGL线程循环调用lv_timer_handler，每次正好睡眠它返回的时间，
+ * 没有就绪的定时器时一直睡眠；其它线程或中断通过lv_port_task_wake提前唤醒它。
+ * 其它线程修改界面前后调用lv_port_task_lock与lv_port_task_unlock，
+ * 解锁时自动唤醒LVGL线程，所以lv_obj_invalidate等修改会在下一次调度时立即生效。
+ * 界面静止时LVGL线程不占用CPU；板上通过MSH命令lvtask查看运行与唤醒次数。
+ * @file lv_port_task.h
+ * @author proyrb
+ * @date 2025/8/20
+ * @note 输入设备按中断工作时，在中断中调用lv_port_task_wake即可，不必缩短读取周期。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <stdint.h>
+
+/********** 配置模块行为 **********/
+
+#ifdef LV_PORT_TASK_C
+
+/* 配置LVGL线程 */
+#    define LVGL_STACK_SIZE (32 * 64)
+#    define LVGL_PRIORITY   4
+#    define LVGL_TICK       10
+
+#endif  // LV_PORT_TASK_C
+
+/********** 统计结果 **********/
+
+typedef struct {
+    uint32_t runs;     // 调用lv_timer_handler的次数
+    uint32_t wakes;    // 被lv_port_task_wake提前唤醒的次数
+    uint32_t expires;  // 睡到定时器到期的次数
+    uint32_t forever;  // 没有就绪的定时器、无限期睡眠的次数
+    uint32_t busy_ms;  // 在lv_timer_handler中累计的毫秒数
+    uint32_t sleep;    // 最近一次计划睡眠的毫秒数，0xFFFFFFFF表示无限期
+} lv_port_task_stat;
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 初始化LVGL并启动LVGL线程。
+ * @param
+ * @retval RT_EOK：成功。
+ * @retval -RT_ENOMEM：内存不足。
+ * @warning 必须在lv_port_mem_init之后调用；使用INIT_APP_EXPORT宏自动初始化。
+ * @note 显示器与输入设备由应用在加锁后注册。
+ */
+extern int lv_port_task_init(void);
+
+/**
+ * @brief 取得访问LVGL的锁。
+ * @param timeout_ms 最长等待的毫秒数，负数表示一直等待。
+ * @retval RT_EOK：成功。
+ * @retval -RT_ETIMEOUT：超时。
+ * @warning LVGL线程以外的线程调用任何LVGL函数前都必须加锁；不能在中断中调用。
+ * @note 可以递归加锁。
+ */
+extern int lv_port_task_lock(const int32_t timeout_ms);
+
+/**
+ * @brief 释放访问LVGL的锁，并唤醒LVGL线程。
+ * @param
+ * @retval
+ * @warning 只能由加锁的线程调用。
+ * @note
+ */
+extern void lv_port_task_unlock(void);
+
+/**
+ * @brief 让LVGL线程立即运行一次lv_timer_handler。
+ * @param
+ * @retval
+ * @warning
+ * @note 可以在中断中调用；连续多次唤醒只会多运行一次。
+ */
+extern void lv_port_task_wake(void);
+
+/**
+ * @brief 取得统计。
+ * @param stat 统计结果。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void lv_port_task_info(lv_port_task_stat * const stat);
+
+/**
+ * @brief 打印统计。
+ * @param print 输出函数。
+ * @retval
+ * @warning
+ * @note 同时打印LVGL自己统计的空闲率。
+ */
+extern void lv_port_task_print(int (*print)(const char * fmt, ...));
+
+#endif  // LV_PORT_TASK_H
@@ -23,6 +23,10 @@
     #include "../widgets/lv_label.h"
 #endif
 
+#ifdef LV_REFR_HOOK_INCLUDE
+    #include LV_REFR_HOOK_INCLUDE
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -93,6 +97,20 @@ static lv_disp_t * disp_refr; /*Display being refreshed*/
     #define REFR_TRACE(...)
 #endif
 
+/*Hooks around a frame, an object and a flush. Empty unless LV_REFR_HOOK_INCLUDE defines them*/
+#ifndef LV_REFR_FRAME_BEGIN
+    #define LV_REFR_FRAME_BEGIN(disp)
+    #define LV_REFR_FRAME_END(disp)
+#endif
+#ifndef LV_REFR_OBJ_BEGIN
+    #define LV_REFR_OBJ_BEGIN(draw_ctx, obj)
+    #define LV_REFR_OBJ_END(draw_ctx, obj)
+#endif
+#ifndef LV_REFR_FLUSH_BEGIN
+    #define LV_REFR_FLUSH_BEGIN(drv, area)
+    #define LV_REFR_FLUSH_END(drv, area)
+#endif
+
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
@@ -179,7 +197,9 @@ void lv_obj_redraw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
         uint32_t child_cnt = lv_obj_get_child_cnt(obj);
         for(i = 0; i < child_cnt; i++) {
             lv_obj_t * child = obj->spec_attr->children[i];
+            LV_REFR_OBJ_BEGIN(draw_ctx, child);
             refr_obj(draw_ctx, child);
+            LV_REFR_OBJ_END(draw_ctx, child);
         }
     }
 
@@ -321,7 +341,9 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
 
     lv_refr_join_area();
     refr_sync_areas();
+    LV_REFR_FRAME_BEGIN(disp_refr);
     refr_invalid_areas();
+    LV_REFR_FRAME_END(disp_refr);
 
     /*If refresh happened ...*/
     if(disp_refr->inv_p != 0) {
@@ -851,7 +873,9 @@ static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj)
     if(top_obj == NULL) return;  /*Shouldn't happen*/
 
     /*Refresh the top object and its children*/
+    LV_REFR_OBJ_BEGIN(draw_ctx, top_obj);
     refr_obj(draw_ctx, top_obj);
+    LV_REFR_OBJ_END(draw_ctx, top_obj);
 
     /*Draw the 'younger' sibling objects because they can be on top_obj*/
     lv_obj_t * parent;
@@ -871,7 +895,9 @@ static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj)
             }
             else {
                 /*Refresh the objects*/
+                LV_REFR_OBJ_BEGIN(draw_ctx, child);
                 refr_obj(draw_ctx, child);
+                LV_REFR_OBJ_END(draw_ctx, child);
             }
         }
 
@@ -1319,7 +1345,9 @@ static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_
         .y2 = area->y2 + drv->offset_y
     };
 
+    LV_REFR_FLUSH_BEGIN(drv, &offset_area);
     drv->flush_cb(drv, &offset_area, color_p);
+    LV_REFR_FLUSH_END(drv, &offset_area);
 }
 
 #if LV_USE_PERF_MONITOR
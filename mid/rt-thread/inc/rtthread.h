@@ -269,7 +269,8 @@ void * rt_calloc(rt_size_t count, rt_size_t size);
 void * rt_malloc_align(rt_size_t size, rt_size_t align);
 void   rt_free_align(void * ptr);
 
-void rt_memory_info(rt_size_t * total, rt_size_t * used, rt_size_t * max_used);
+void      rt_memory_info(rt_size_t * total, rt_size_t * used, rt_size_t * max_used);
+rt_size_t rt_memory_largest(void);
 
 #    if defined(RT_USING_SLAB) && defined(RT_USING_SLAB_AS_HEAP)
 void * rt_page_alloc(rt_size_t npages);
@@ -292,24 +293,26 @@ rt_err_t  rt_smem_detach(rt_smem_t m);
 void *    rt_smem_alloc(rt_smem_t m, rt_size_t size);
 void *    rt_smem_realloc(rt_smem_t m, void * rmem, rt_size_t newsize);
 void      rt_smem_free(void * rmem);
+rt_size_t rt_smem_largest(rt_smem_t m);
 #endif
 
 #ifdef RT_USING_MEMHEAP
 /**
  * memory heap object interface
  */
-rt_err_t rt_memheap_init(struct rt_memheap * memheap,
-                         const char *        name,
-                         void *              start_addr,
-                         rt_size_t           size);
-rt_err_t rt_memheap_detach(struct rt_memheap * heap);
-void *   rt_memheap_alloc(struct rt_memheap * heap, rt_size_t size);
-void *   rt_memheap_realloc(struct rt_memheap * heap, void * ptr, rt_size_t newsize);
-void     rt_memheap_free(void * ptr);
-void     rt_memheap_info(struct rt_memheap * heap,
-                         rt_size_t *         total,
-                         rt_size_t *         used,
-                         rt_size_t *         max_used);
+rt_err_t  rt_memheap_init(struct rt_memheap * memheap,
+                          const char *        name,
+                          void *              start_addr,
+                          rt_size_t           size);
+rt_err_t  rt_memheap_detach(struct rt_memheap * heap);
+void *    rt_memheap_alloc(struct rt_memheap * heap, rt_size_t size);
+void *    rt_memheap_realloc(struct rt_memheap * heap, void * ptr, rt_size_t newsize);
+void      rt_memheap_free(void * ptr);
+void      rt_memheap_info(struct rt_memheap * heap,
+                          rt_size_t *         total,
+                          rt_size_t *         used,
+                          rt_size_t *         max_used);
+rt_size_t rt_memheap_largest(struct rt_memheap * heap);
 #endif
 
 #ifdef RT_USING_SLAB
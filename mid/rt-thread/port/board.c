@@ -12,6 +12,24 @@
 #include <sc32_conf.h>
 #include <rtthread.h>
 #include <st7789v.h>
+#include <w25q64.h>
+#include <w25q64_pool.h>
+#include <lfs_port.h>
+#include <lv_port_mem.h>
+#include <lv_draw_sc32_dma.h>
+#include <lv_port_task.h>
+
+/********** 终端输入 **********/
+
+#ifdef RT_USING_FINSH
+// 终端接收缓冲区的字节数，必须是2的幂
+#    define CONSOLE_RX_SIZE 32
+
+static struct rt_semaphore console_rx;  // 缓冲区中有新字符
+static volatile char       console_buf[CONSOLE_RX_SIZE];
+static volatile uint8_t    console_head = 0;  // 中断写入的位置
+static volatile uint8_t    console_tail = 0;  // FinSH读取的位置
+#endif
 
 /********** 实现中断配置代码 **********/
 
@@ -33,14 +51,20 @@ __attribute__((interrupt)) void SysTick_Handler(void) {
  * @param
  * @retval
  * @warning
- * @note
+ * @note 收到的字符放进终端接收缓冲区并唤醒FinSH，缓冲区满时丢弃。
  */
-
 __attribute__((interrupt)) void UART1_3_5_IRQHandler(void) {
     rt_interrupt_enter();
-    rt_kprintf("in\n");
     if (UART_GetFlagStatus(UART5, UART_Flag_RX)) {
         UART_ClearFlag(UART5, UART_Flag_RX);
+#ifdef RT_USING_FINSH
+        const char ch = (char)UART_ReceiveData(UART5);
+        if ((uint8_t)(console_head - console_tail) < CONSOLE_RX_SIZE) {
+            console_buf[console_head % CONSOLE_RX_SIZE] = ch;
+            ++console_head;
+            rt_sem_release(&console_rx);
+        }
+#endif
     }
     rt_interrupt_leave();
 }
@@ -51,13 +75,24 @@ __attribute__((interrupt)) void DMA0_IRQHandler(void) {
 }
 
 __attribute__((interrupt)) void DMA1_IRQHandler(void) {
-    // w25q64_dma_irq();
+    rt_interrupt_enter();
     DMA_ClearFlag(DMA1, DMA_FLAG_GIF | DMA_FLAG_TCIF | DMA_FLAG_HTIF | DMA_FLAG_TEIF);
+    w25q64_dma_irq();
+    rt_interrupt_leave();
 }
 
 __attribute__((interrupt)) void DMA2_IRQHandler(void) {
-    // w25q64_dma_irq();
+    rt_interrupt_enter();
     DMA_ClearFlag(DMA2, DMA_FLAG_GIF | DMA_FLAG_TCIF | DMA_FLAG_HTIF | DMA_FLAG_TEIF);
+    w25q64_dma_irq();
+    rt_interrupt_leave();
+}
+
+__attribute__((interrupt)) void DMA3_IRQHandler(void) {
+    rt_interrupt_enter();
+    DMA_ClearFlag(DMA3, DMA_FLAG_GIF | DMA_FLAG_TCIF | DMA_FLAG_HTIF | DMA_FLAG_TEIF);
+    lv_draw_sc32_dma_irq();
+    rt_interrupt_leave();
 }
 
 /********** 实现初始化配置代码 **********/
@@ -114,12 +149,8 @@ static void uart5_init(void) {
     UART_InitStruct.UART_BaudRate       = 115200;
     UART_InitStruct.UART_Mode           = UART_Mode_10B;
     UART_Init(UART5, &UART_InitStruct);
-    // UART_ITConfig(UART5, UART_IT_EN | UART_IT_RX, ENABLE);
     UART_PinRemapConfig(UART5, UART_PinRemap_Default);
-    // NVIC_SetPriority(UART1_3_5_IRQn, 2);
-    // NVIC_EnableIRQ(UART1_3_5_IRQn);
     UART_TXCmd(UART5, ENABLE);
-    // UART_RXCmd(UART5, ENABLE);
     Printf_UartInit(UART5);
 }
 
@@ -198,6 +229,14 @@ static void qspi_0_init(void) {
     QSPI_Cmd(QSPI0, ENABLE);                               // 使能
 }
 
+static void crc_init(void) {
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_CRC, ENABLE);                 // 使能时钟
+    CRC_InitTypeDef CRC_InitStruct;                                   // 初始化结构体
+    CRC_InitStruct.DefaultPolynomialUse = DEFAULT_Polynomial_Enable;  // 使用CRC-32多项式
+    CRC_InitStruct.DefaultInitValueUse  = DEFAULT_InitValue_Enable;   // 使用默认初值
+    CRC_Init(&CRC_InitStruct);                                        // 初始化
+}
+
 static void dma0_init(void) {
     RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA, ENABLE);            // 使能时钟
     DMA_InitTypeDef DMA_InitStruct;                              // 初始化结构体
@@ -273,6 +312,39 @@ static void dma_2_init(void) {
     DMA_Cmd(DMA2, DISABLE);                      // 先关闭使能
 }
 
+/**
+ * @brief 初始化LVGL绘制用的内存到内存DMA通道。
+ * @param
+ * @retval
+ * @warning
+ * @note 内存之间的传输使用软件请求；批量传输一次请求搬完全部数据，
+ * 每次仲裁只搬一个数据，不要求计数是突发长度的整数倍，也不会长时间占住总线。
+ * 传输宽度与源地址模式由lv_draw_sc32_dma在每次启动前设置。
+ */
+static void dma_3_init(void) {
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA, ENABLE);            // 使能时钟
+    DMA_InitTypeDef DMA_InitStruct;                              // 初始化结构体
+    DMA_InitStruct.DMA_Priority     = DMA_Priority_LOW;          // 设置优先级为低
+    DMA_InitStruct.DMA_CircularMode = DMA_CircularMode_Disable;  // 禁用循环模式
+    DMA_InitStruct.DMA_DataSize     = DMA_DataSize_Word;         // 设置数据大小为字
+    DMA_InitStruct.DMA_TargetMode   = DMA_TargetMode_INC;        // 设置目标地址递增
+    DMA_InitStruct.DMA_SourceMode   = DMA_SourceMode_INC;        // 设置源地址递增
+    DMA_InitStruct.DMA_Burst        = DMA_Burst_1B;              // 批量传输
+    DMA_InitStruct.DMA_BufferSize   = 0;                         // 设置缓冲区大小为0
+    DMA_InitStruct.DMA_Request      = DMA_Request_Null;          // 只用软件请求
+    DMA_InitStruct.DMA_SrcAddress   = 0;                         // 设置源地址为0
+    DMA_InitStruct.DMA_DstAddress   = 0;                         // 设置目标地址为0
+    DMA_Init(DMA3, &DMA_InitStruct);                             // 初始化
+    DMA_ITConfig(DMA3, DMA_IT_INTEN, ENABLE);                    // 使能总中断
+    DMA_ITConfig(DMA3, DMA_IT_TCIE, ENABLE);                     // 使能传输完成中断
+    DMA_ITConfig(DMA3, DMA_IT_HTIE, DISABLE);                    // 禁用半传输中断
+    DMA_ITConfig(DMA3, DMA_IT_TEIE, DISABLE);                    // 禁用传输错误中断
+    DMA_DMACmd(DMA3, DMA_DMAReq_CHRQ, DISABLE);                  // 关闭DMA请求
+    __NVIC_SetPriority(DMA3_IRQn, 1);                            // 设置中断优先级为1
+    __NVIC_EnableIRQ(DMA3_IRQn);                                 // 使能中断
+    DMA_Cmd(DMA3, DISABLE);                                      // 先关闭使能
+}
+
 /**
  * @brief 在系统启动阶段进行的初始化操作。
  * @param
@@ -287,6 +359,11 @@ void rt_hw_board_init(void) {
     gpio_init();
     spi2_init();
     dma0_init();
+    qspi_0_init();
+    dma_1_init();
+    dma_2_init();
+    dma_3_init();
+    crc_init();
 
 #ifdef RT_USING_COMPONENTS_INIT
     /* 初始化系统组件 */
@@ -301,6 +378,29 @@ void rt_hw_board_init(void) {
 #endif
 }
 
+/**
+ * @brief 基于SysTick计数值实现微秒级忙等延时。
+ * @param us 延时的微秒数。
+ * @retval
+ * @warning 忙等，不会让出处理器；只适合很短的延时。
+ * @note RT-Thread的系统调用。
+ */
+void rt_hw_us_delay(rt_uint32_t us) {
+    const rt_uint32_t reload  = SysTick->LOAD;
+    const rt_uint32_t target  = us * ((reload + 1) / (1000000 / RT_TICK_PER_SECOND));
+    rt_uint32_t       elapsed = 0;
+    rt_uint32_t       last    = SysTick->VAL;
+
+    while (elapsed < target) {
+        const rt_uint32_t now = SysTick->VAL;
+        if (now != last) {
+            /* SysTick向下计数，回绕时补上一个重装周期 */
+            elapsed += (now < last) ? (last - now) : (reload + 1 - now + last);
+            last = now;
+        }
+    }
+}
+
 #ifdef RT_USING_CONSOLE
 /**
  * @brief 实现终端信息输出。
@@ -320,18 +420,47 @@ void rt_hw_console_output(const char * str) {
 #endif
 
 #ifdef RT_USING_FINSH
+/**
+ * @brief 打开UART5的接收中断，供FinSH读取终端输入。
+ * @param
+ * @retval 0 一般固定。
+ * @warning 必须在finsh_system_init之前调用。
+ * @note 使用INIT_DEVICE_EXPORT宏自动初始化。
+ */
+static int console_rx_init(void) {
+    rt_sem_init(&console_rx, "conrx", 0, RT_IPC_FLAG_FIFO);
+    UART_ITConfig(UART5, UART_IT_EN | UART_IT_RX, ENABLE);
+    NVIC_SetPriority(UART1_3_5_IRQn, 2);
+    NVIC_EnableIRQ(UART1_3_5_IRQn);
+    UART_RXCmd(UART5, ENABLE);
+    return 0;
+}
+
 /**
  * @brief 实现终端信息输入。
  * @param
  * @retval 输入的字符。
- * @warning
- * @note RT-Thread的系统调用。
+ * @warning 只由FinSH线程调用。
+ * @note RT-Thread的系统调用；缓冲区为空时阻塞，不会返回-1让FinSH空转。
  */
 char rt_hw_console_getchar(void) {
-    char ch = -1;
+    while (console_head == console_tail) {
+        rt_sem_take(&console_rx, RT_WAITING_FOREVER);
+    }
+    const char ch = console_buf[console_tail % CONSOLE_RX_SIZE];
+    ++console_tail;
     return ch;
 }
 #endif
 
 /********** 自动初始化 **********/
+#ifdef RT_USING_FINSH
+INIT_DEVICE_EXPORT(console_rx_init);
+#endif
+INIT_DEVICE_EXPORT(w25q64_init);
+INIT_COMPONENT_EXPORT(w25q64_pool_init);
+INIT_COMPONENT_EXPORT(lv_port_mem_init);
+INIT_COMPONENT_EXPORT(lv_draw_sc32_dma_init);
+INIT_ENV_EXPORT(lfs_port_init);
 INIT_APP_EXPORT(st7789v_init);
+INIT_APP_EXPORT(lv_port_task_init);
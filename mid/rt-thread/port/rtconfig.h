@@ -226,9 +226,9 @@
 /**
  * @brief 启用FinSH。
  * @warning
- * @note
+ * @note 终端输入来自UART5的接收中断，见board.c。
  */
-// #define RT_USING_FINSH
+#define RT_USING_FINSH
 
 /**
  * @brief 启用MSH模式。
@@ -1312,6 +1312,7 @@ rt_inline void   _smem_info(rt_size_t * total, rt_size_t * used, rt_size_t * max
 #        define _MEM_REALLOC(_ptr, _newsize) rt_smem_realloc(system_heap, _ptr, _newsize)
 #        define _MEM_FREE(_ptr) rt_smem_free(_ptr)
 #        define _MEM_INFO(_total, _used, _max) _smem_info(_total, _used, _max)
+#        define _MEM_LARGEST() rt_smem_largest(system_heap)
 #    elif defined(RT_USING_MEMHEAP_AS_HEAP)
 static struct rt_memheap system_heap;
 void *                   _memheap_alloc(struct rt_memheap * heap, rt_size_t size);
@@ -1325,6 +1326,7 @@ void * _memheap_realloc(struct rt_memheap * heap, void * rmem, rt_size_t newsize
 #        define _MEM_FREE(_ptr) _memheap_free(_ptr)
 #        define _MEM_INFO(_total, _used, _max)                                           \
             rt_memheap_info(&system_heap, _total, _used, _max)
+#        define _MEM_LARGEST() rt_memheap_largest(&system_heap)
 #    elif defined(RT_USING_SLAB_AS_HEAP)
 static rt_slab_t system_heap;
 rt_inline void   _slab_info(rt_size_t * total, rt_size_t * used, rt_size_t * max_used) {
@@ -1341,12 +1343,14 @@ rt_inline void   _slab_info(rt_size_t * total, rt_size_t * used, rt_size_t * max
 #        define _MEM_REALLOC(_ptr, _newsize) rt_slab_realloc(system_heap, _ptr, _newsize)
 #        define _MEM_FREE(_ptr) rt_slab_free(system_heap, _ptr)
 #        define _MEM_INFO _slab_info
+#        define _MEM_LARGEST() 0
 #    else
 #        define _MEM_INIT(...)
 #        define _MEM_MALLOC(...) RT_NULL
 #        define _MEM_REALLOC(...) RT_NULL
 #        define _MEM_FREE(...)
 #        define _MEM_INFO(...)
+#        define _MEM_LARGEST() 0
 #    endif
 
 /**
@@ -1483,6 +1487,26 @@ RT_WEAK void rt_memory_info(rt_size_t * total, rt_size_t * used, rt_size_t * max
 }
 RTM_EXPORT(rt_memory_info);
 
+/**
+ * @brief This function will return the size of the largest free block of the
+ *        system heap, which is the largest request rt_malloc can satisfy now.
+ *
+ * @return the size of the largest free block, 0 if the heap can not tell.
+ */
+RT_WEAK rt_size_t rt_memory_largest(void) {
+    rt_base_t level;
+    rt_size_t largest;
+
+    /* Enter critical zone */
+    level   = _heap_lock();
+    largest = _MEM_LARGEST();
+    /* Exit critical zone */
+    _heap_unlock(level);
+
+    return largest;
+}
+RTM_EXPORT(rt_memory_largest);
+
 #    if defined(RT_USING_SLAB) && defined(RT_USING_SLAB_AS_HEAP)
 void * rt_page_alloc(rt_size_t npages) {
     rt_base_t level;
@@ -539,6 +539,39 @@ void rt_smem_free(void * rmem) {
 }
 RTM_EXPORT(rt_smem_free);
 
+/**
+ * @brief This function will return the size of the largest free block, which is
+ *        the largest request rt_smem_alloc can satisfy without splitting others.
+ *
+ * @param m the small memory management object.
+ *
+ * @return the user data size of the largest free block.
+ */
+rt_size_t rt_smem_largest(rt_smem_t m) {
+    struct rt_small_mem_item * mem;
+    struct rt_small_mem *      small_mem;
+    rt_size_t                  ptr, size, largest = 0;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+
+    small_mem = (struct rt_small_mem *)m;
+    /* every block below lfree is used, start from there */
+    for (ptr = (rt_uint8_t *)small_mem->lfree - small_mem->heap_ptr;
+         ptr < small_mem->mem_size_aligned;
+         ptr = ((struct rt_small_mem_item *)&small_mem->heap_ptr[ptr])->next) {
+        mem = (struct rt_small_mem_item *)&small_mem->heap_ptr[ptr];
+        if (!MEM_ISUSED(mem)) {
+            size = mem->next - (ptr + SIZEOF_STRUCT_MEM);
+            if (size > largest)
+                largest = size;
+        }
+    }
+
+    return largest;
+}
+RTM_EXPORT(rt_smem_largest);
+
 #    ifdef RT_USING_FINSH
 #        include <finsh.h>
 
@@ -719,6 +719,41 @@ void rt_memheap_info(struct rt_memheap * heap,
     }
 }
 
+/**
+ * @brief This function will return the size of the largest free block on the heap.
+ *
+ * @param heap is a pointer to the memheap object.
+ *
+ * @return the user data size of the largest free block, 0 if the lock fails.
+ */
+rt_size_t rt_memheap_largest(struct rt_memheap * heap) {
+    struct rt_memheap_item * item;
+    rt_size_t                largest = 0;
+    rt_err_t                 result;
+
+    if (heap->locked == RT_FALSE) {
+        /* lock memheap */
+        result = rt_sem_take(&(heap->lock), RT_WAITING_FOREVER);
+        if (result != RT_EOK) {
+            rt_set_errno(result);
+            return 0;
+        }
+    }
+
+    for (item = heap->free_list->next_free; item != heap->free_list;
+         item = item->next_free) {
+        if (MEMITEM_SIZE(item) > largest)
+            largest = MEMITEM_SIZE(item);
+    }
+
+    if (heap->locked == RT_FALSE) {
+        /* release lock */
+        rt_sem_release(&(heap->lock));
+    }
+
+    return largest;
+}
+
 #    ifdef RT_USING_MEMHEAP_AS_HEAP
 /*
  * rt_malloc port function
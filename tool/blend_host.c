@@ -0,0 +1,224 @@
+/**
+ * @brief 这是lv_port_blend的主机版本逐位比对与测速程序。
+ * @details 把LVGL的lv_draw_sw_blend.c与mid/lvgl/port/lv_port_blend.c编译到一起，
+ * 用随机的目标缓冲区、混合区域、裁剪区域、源图、蒙版、透明度与对齐方式
+ * 分别调用lv_draw_sw_blend_basic与lv_port_blend，比较整个目标缓冲区（包括区域之外）；
+ * 然后运行与板上blendbench相同的测试，单位是主机的纳秒，只用来比较两者的相对快慢。
+ * 编译：gcc -std=gnu11 -O2 -DLV_CONF_INCLUDE_SIMPLE -DLV_PORT_BLEND_HOST -Imid/lvgl
+ *       -Imid/lvgl/port tool/blend_host.c mid/lvgl/port/lv_port_blend.c
+ *       mid/lvgl/src/draw/sw/lv_draw_sw_blend.c mid/lvgl/src/misc/lv_color.c
+ *       mid/lvgl/src/misc/lv_mem.c mid/lvgl/src/misc/lv_area.c
+ *       mid/lvgl/src/misc/lv_math.c -o blend_host
+ * @file blend_host.c
+ * @author proyrb
+ * @date 2025/8/19
+ * @note 用法：./blend_host [轮数] [随机种子]。
+ */
+
+#include <lv_port_blend.h>
+#include <lv_port_mem.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// 目标缓冲区的宽与高
+#define BUF_W 48
+#define BUF_H 20
+
+// 源图与蒙版的最大宽高
+#define AREA_MAX 40
+
+/********** 代替LVGL其余部分的桩 **********/
+
+lv_mem_buf_arr_t lv_mem_buf;
+
+static lv_disp_drv_t drv;
+static lv_disp_t     disp = {.driver = &drv};
+static lv_disp_t *   refr = &disp;
+
+lv_disp_t * _lv_refr_get_disp_refreshing(void) {
+    return refr;
+}
+
+void _lv_refr_set_disp_refreshing(lv_disp_t * d) {
+    refr = d;
+}
+
+void lv_draw_sw_init_ctx(lv_disp_drv_t * d, lv_draw_ctx_t * draw_ctx) {
+}
+
+void * lv_port_mem_alloc(size_t size) {
+    return malloc(size);
+}
+
+void lv_port_mem_free(void * ptr) {
+    free(ptr);
+}
+
+void * lv_port_mem_realloc(void * ptr, size_t size) {
+    return realloc(ptr, size);
+}
+
+/********** 随机数据 **********/
+
+static uint32_t _rand(const uint32_t n) {
+    return (uint32_t)rand() % n;
+}
+
+static lv_opa_t _rand_opa(void) {
+    /* 多取边界值：各条分支的阈值与舍入特例都在这里 */
+    static const lv_opa_t edge[] = {0,   1,   2,   3,   4,   5,   127,
+                                    128, 250, 251, 252, 253, 254, 255};
+    return (_rand(3) == 0) ? (lv_opa_t)_rand(256) : edge[_rand(sizeof(edge))];
+}
+
+static void _rand_area(lv_area_t * const a, const int32_t lo, const int32_t hi,
+                       const int32_t max) {
+    a->x1 = lo + (int32_t)_rand(hi - lo);
+    a->y1 = lo + (int32_t)_rand(hi - lo);
+    a->x2 = a->x1 + (int32_t)_rand(max);
+    a->y2 = a->y1 + (int32_t)_rand(max / 2);
+}
+
+/**
+ * @brief 生成一段目标内容：成片的同色区域与杂色交替，覆盖两种实现的缓存路径。
+ * @param
+ * @retval
+ * @warning
+ * @note
+ */
+static void _rand_pixels(uint16_t * const buf, const uint32_t cnt) {
+    uint16_t c = 0;
+    for (uint32_t i = 0; i < cnt; ++i) {
+        if (_rand(8) == 0) {
+            c = (_rand(4) == 0) ? 0 : (uint16_t)_rand(0x10000);
+        }
+        buf[i] = (_rand(4) == 0) ? (uint16_t)_rand(0x10000) : c;
+    }
+}
+
+/********** 逐位比对 **********/
+
+typedef struct {
+    uint16_t   ref[BUF_W * BUF_H + 2];               // 参考实现的目标
+    uint16_t   port[BUF_W * BUF_H + 2];              // lv_port_blend的目标
+    uint16_t   src[AREA_MAX * AREA_MAX + 4];         // 源图，多留出对齐读取的余量
+    lv_opa_t   mask[AREA_MAX * AREA_MAX];            // 蒙版
+    lv_opa_t   mask_ref[AREA_MAX * AREA_MAX];        // 参考实现使用的蒙版副本
+    lv_color_t dummy;                                // 占位
+} case_buf;
+
+static case_buf cb;
+
+/**
+ * @brief 随机生成一组参数，分别用两种实现混合并比较结果。
+ * @param n 第几轮，用于报告。
+ * @retval 0：相同。
+ * @retval -1：不同。
+ * @warning
+ * @note
+ */
+static int _check_once(const uint32_t n) {
+    /* 目标缓冲区：随机错开半个字 */
+    const uint32_t off  = _rand(2);
+    lv_area_t      buf_area;
+    buf_area.x1 = (int32_t)_rand(8);
+    buf_area.y1 = (int32_t)_rand(8);
+    buf_area.x2 = buf_area.x1 + BUF_W - 1 - (int32_t)off;
+    buf_area.y2 = buf_area.y1 + BUF_H - 1;
+    _rand_pixels(cb.ref, BUF_W * BUF_H + 2);
+    memcpy(cb.port, cb.ref, sizeof(cb.ref));
+
+    /* 混合区域与裁剪区域都可能超出缓冲区 */
+    lv_area_t blend_area, mask_area, clip;
+    _rand_area(&blend_area, 0, BUF_W, AREA_MAX);
+    if (blend_area.y2 - blend_area.y1 >= AREA_MAX) {
+        blend_area.y2 = blend_area.y1 + AREA_MAX - 1;
+    }
+    mask_area = blend_area;
+    if (!_lv_area_intersect(&clip, &buf_area, &blend_area)) {
+        clip = buf_area;
+    }
+    if (_rand(2)) {
+        clip.x1 += (int32_t)_rand(3);
+        clip.x2 -= (int32_t)_rand(3);
+    }
+
+    const uint32_t src_off = _rand(2);
+    _rand_pixels(cb.src, sizeof(cb.src) / 2);
+    for (uint32_t i = 0; i < sizeof(cb.mask); ++i) {
+        const uint32_t r = _rand(4);
+        cb.mask[i]       = (r == 0) ? 0 : (r == 1) ? 255 : _rand_opa();
+    }
+    memcpy(cb.mask_ref, cb.mask, sizeof(cb.mask));
+
+    lv_draw_sw_blend_dsc_t dsc;
+    memset(&dsc, 0, sizeof(dsc));
+    dsc.blend_area = &blend_area;
+    dsc.mask_area  = &mask_area;
+    dsc.src_buf    = _rand(2) ? (const lv_color_t *)cb.src + src_off : NULL;
+    dsc.color.full = _rand(4) ? (uint16_t)_rand(0x10000) : 0;
+    dsc.opa        = _rand_opa();
+    dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+
+    const uint32_t res = _rand(4);
+    dsc.mask_res       = (res == 0) ? LV_DRAW_MASK_RES_FULL_COVER :
+                         (res == 1) ? LV_DRAW_MASK_RES_TRANSP :
+                                      LV_DRAW_MASK_RES_CHANGED;
+    const int masked   = _rand(3) != 0;
+    drv.antialiasing   = _rand(4) != 0;
+
+    lv_draw_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.buf_area  = &buf_area;
+    ctx.clip_area = &clip;
+
+    ctx.buf      = cb.ref + off;
+    dsc.mask_buf = masked ? cb.mask_ref : NULL;
+    lv_draw_sw_blend_basic(&ctx, &dsc);
+
+    ctx.buf      = cb.port + off;
+    dsc.mask_buf = masked ? cb.mask : NULL;
+    lv_port_blend(&ctx, &dsc);
+
+    if ((memcmp(cb.ref, cb.port, sizeof(cb.ref)) == 0) &&
+        (memcmp(cb.mask_ref, cb.mask, sizeof(cb.mask)) == 0)) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < BUF_W * BUF_H + 2; ++i) {
+        if (cb.ref[i] != cb.port[i]) {
+            printf("round %u: pixel %u lvgl %04x port %04x (src %d mask %d res %d opa %u "
+                   "aa %u off %u/%u)\n",
+                   n, i, cb.ref[i], cb.port[i], dsc.src_buf != NULL, masked, dsc.mask_res,
+                   dsc.opa, drv.antialiasing, off, src_off);
+            break;
+        }
+    }
+    return -1;
+}
+
+/********** 测速 **********/
+
+static uint32_t _host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+int main(int argc, char ** argv) {
+    const uint32_t rounds = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200000;
+    const uint32_t seed   = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+    uint32_t       fails  = 0;
+
+    srand(seed);
+    for (uint32_t n = 0; n < rounds; ++n) {
+        if ((_check_once(n) != 0) && (++fails >= 10)) {
+            break;
+        }
+    }
+    printf("bit-exact: %u rounds, %u mismatches\n", rounds, fails);
+
+    lv_port_blend_bench(printf, _host_ns, "ns");
+    return (fails == 0) ? 0 : 1;
+}
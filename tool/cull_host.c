@@ -0,0 +1,215 @@
+/**
+ * @brief 这是lv_port_cull的主机版本对比程序。
+ * @details 在主机上编译整个LVGL与板上同一份lv_port_cull.c、lv_port_prof.c、lv_port_layer.c，
+ * 搭一个嵌套面板的界面：三个面板各有三个子面板，子面板里再有标签和小方块，
+ * 其中包括圆角、边框、半透明背景、clip_corner的父对象、opa_layered的子对象、
+ * 缩放、阴影与滚动过的父对象，覆盖剔除时需要跳过或者正确处理的各种情况。
+ * 先关闭剔除整屏刷新一次作为参考，再打开剔除刷新一次，逐像素比较两帧，
+ * 并打印两次的重绘倍数（与板上lvcull相同）与lvprof的统计。
+ * 加参数dma时绘制上下文换成板上的lv_draw_sc32_dma，DMA通道由tool/dma_sim.c模拟：
+ * 剔除把一次填充拆成几块连续混合，检查每块都等到上一块的DMA完成才开始。
+ * 编译：gcc -std=gnu11 -O2 -DLV_CONF_INCLUDE_SIMPLE -DLV_LVGL_H_INCLUDE_SIMPLE
+ *       -DLV_PORT_BLEND_HOST -DLV_DRAW_SC32_DMA_HOST -Itool/host -Itool -Imid/lvgl
+ *       -Imid/lvgl/port tool/cull_host.c tool/dma_sim.c mid/lvgl/port/lv_port_cull.c
+ *       mid/lvgl/port/lv_port_prof.c mid/lvgl/port/lv_port_layer.c
+ *       mid/lvgl/port/lv_port_blend.c mid/lvgl/port/lv_draw_sc32_dma.c
+ *       $(find mid/lvgl/src -name '*.c') -no-pie -o cull_host
+ * @file cull_host.c
+ * @author proyrb
+ * @date 2025/8/21
+ * @note 用法：./cull_host [dma]；两帧不同或者DMA通道使用出错时返回1。
+ * tool/host中的rtthread.h与sc32_conf.h代替板上的头文件，耗时取自主机时钟。
+ * 与tool/dma_host.c相同，用-no-pie链接，交给DMA的缓冲区都在低4GB之内。
+ */
+
+#include <lvgl.h>
+#include <lv_draw_sc32_dma.h>
+#include <lv_port_cull.h>
+#include <lv_port_mem.h>
+#include <lv_port_prof.h>
+#include <lv_port_task.h>
+#include <rtthread.h>
+#include <dma_sim.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 模拟屏幕的宽与高
+#define SCR_W 240
+#define SCR_H 320
+
+// 绘制缓冲区的行数
+#define BUF_ROWS 40
+
+/********** 代替板上模块的桩 **********/
+
+host_systick host_systick_regs = {.LOAD = 8000 - 1, .VAL = 0};
+
+void * lv_port_mem_alloc(size_t size) {
+    return malloc(size);
+}
+
+void lv_port_mem_free(void * ptr) {
+    free(ptr);
+}
+
+void * lv_port_mem_realloc(void * ptr, size_t size) {
+    return realloc(ptr, size);
+}
+
+void lv_port_mem_info(lv_port_mem_stat * const stat) {
+    memset(stat, 0, sizeof(*stat));
+    stat->largest = 1024 * 1024;
+}
+
+int lv_port_task_lock(const int32_t timeout_ms) {
+    return 0;
+}
+
+void lv_port_task_unlock(void) {
+}
+
+/********** 模拟的屏幕 **********/
+
+static lv_color_t screen[SCR_W * SCR_H];
+static lv_color_t draw_buf[SCR_W * BUF_ROWS];
+
+static void _flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * px) {
+    for (lv_coord_t y = area->y1; y <= area->y2; ++y) {
+        for (lv_coord_t x = area->x1; x <= area->x2; ++x) {
+            screen[y * SCR_W + x] = *px++;
+        }
+    }
+    lv_disp_flush_ready(drv);
+}
+
+/********** 测试界面 **********/
+
+/**
+ * @brief 创建一个子面板：标签与底部的小方块。
+ * @param parent 面板。
+ * @param i 面板的序号。
+ * @param j 子面板的序号。
+ * @retval
+ * @warning
+ * @note 个别子面板带半透明背景、缩放、半透明或阴影。
+ */
+static void _child(lv_obj_t * const parent, const int i, const int j) {
+    lv_obj_t * const c = lv_obj_create(parent);
+    lv_obj_set_pos(c, j * 68, 0);
+    lv_obj_set_size(c, 64, 80);
+    lv_obj_set_style_radius(c, (j == 2) ? 8 : 0, 0);
+    lv_obj_set_style_bg_color(c, lv_color_hex(0x40a000 + j * 0x30), 0);
+    lv_obj_set_style_border_width(c, j, 0);
+    lv_obj_set_style_bg_opa(c, ((i == 2) && (j == 0)) ? LV_OPA_50 : LV_OPA_COVER, 0);
+    lv_obj_clear_flag(c, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t * const label = lv_label_create(c);
+    lv_label_set_text_fmt(label, "P%d.%d", i, j);
+
+    lv_obj_t * const box = lv_obj_create(c);
+    lv_obj_set_size(box, 40, 30);
+    lv_obj_align(box, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_obj_set_style_bg_color(box, lv_color_hex(0xff8000), 0);
+    if ((i == 0) && (j == 1)) {
+        lv_obj_set_style_transform_zoom(box, 300, 0);
+    }
+    if ((i == 1) && (j == 0)) {
+        lv_obj_set_style_opa(box, LV_OPA_50, 0);
+    }
+    if ((i == 2) && (j == 1)) {
+        lv_obj_set_style_shadow_width(box, 10, 0);
+    }
+}
+
+/**
+ * @brief 创建三个面板：第0个的一个子面板使用图层，第1个clip_corner，第2个滚动过。
+ * @param
+ * @retval
+ * @warning
+ * @note
+ */
+static void _build(void) {
+    lv_obj_t * const scr = lv_scr_act();
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x203040), 0);
+
+    for (int i = 0; i < 3; ++i) {
+        lv_obj_t * const p = lv_obj_create(scr);
+        lv_obj_set_pos(p, 5 + i * 10, 5 + i * 100);
+        lv_obj_set_size(p, 220, 95);
+        lv_obj_set_style_radius(p, 0, 0);
+        lv_obj_set_style_pad_all(p, 4, 0);
+        lv_obj_clear_flag(p, LV_OBJ_FLAG_SCROLLABLE);
+        for (int j = 0; j < 3; ++j) {
+            _child(p, i, j);
+        }
+
+        if (i == 0) {
+            lv_obj_set_style_opa_layered(lv_obj_get_child(p, 2), LV_OPA_70, 0);
+        } else if (i == 1) {
+            lv_obj_set_style_clip_corner(p, true, 0);
+            lv_obj_set_style_radius(p, 30, 0);
+        } else {
+            lv_obj_add_flag(p, LV_OBJ_FLAG_SCROLLABLE);
+            lv_obj_set_size(p, 150, 95);
+            lv_obj_scroll_to_x(p, 37, LV_ANIM_OFF);
+        }
+    }
+}
+
+/**
+ * @brief 整屏刷新一次并打印重绘统计。
+ * @param cull 是否剔除。
+ * @retval
+ * @warning
+ * @note
+ */
+static void _render(const int cull) {
+    lv_port_cull_reset();
+    lv_port_cull_enable(cull);
+    memset(screen, 0, sizeof(screen));
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    printf("culling %s:\n", cull ? "on" : "off");
+    lv_port_cull_print(printf);
+}
+
+int main(int argc, char ** argv) {
+    static lv_disp_draw_buf_t buf;
+    static lv_disp_drv_t      drv;
+    static lv_color_t         ref[SCR_W * SCR_H];
+    const int                 dma = (argc > 1) && (strcmp(argv[1], "dma") == 0);
+
+    lv_init();
+    lv_disp_draw_buf_init(&buf, draw_buf, NULL, SCR_W * BUF_ROWS);
+    lv_disp_drv_init(&drv);
+    drv.hor_res  = SCR_W;
+    drv.ver_res  = SCR_H;
+    drv.flush_cb = _flush;
+    drv.draw_buf = &buf;
+    if (dma) {
+        lv_draw_sc32_dma_init();
+        drv.draw_ctx_init = lv_draw_sc32_dma_ctx_init;
+        drv.draw_ctx_size = sizeof(lv_draw_sc32_dma_ctx_t);
+    }
+    lv_disp_drv_register(&drv);
+    _build();
+
+    _render(0);
+    memcpy(ref, screen, sizeof(screen));
+    _render(1);
+
+    uint32_t diff = 0;
+    for (uint32_t i = 0; i < SCR_W * SCR_H; ++i) {
+        diff += ref[i].full != screen[i].full;
+    }
+    printf("differing pixels: %u\n", diff);
+
+    lv_port_prof_print(printf, 5);
+    if (dma) {
+        printf("dma channel errors: %u\n", dma_sim_errors);
+        lv_draw_sc32_dma_print(printf);
+    }
+    return ((diff == 0) && (dma_sim_errors == 0)) ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+/**
+ * @brief 这是lv_draw_sc32_dma的主机版本逐位比对程序。
+ * @details 把mid/lvgl/port/lv_draw_sc32_dma.c与lv_port_blend.c、LVGL的lv_draw_sw_blend.c
+ * 编译到一起，DMA通道与信号量由tool/dma_sim.c模拟。
+ * 用随机的目标缓冲区、混合区域、裁剪区域、颜色、源图与对齐方式
+ * 分别调用lv_draw_sw_blend_basic与blend + wait_for_finish，比较整个目标缓冲区（包括区域之外），
+ * 最后打印与板上lvdma相同的统计。
+ * 编译：gcc -std=gnu11 -O2 -DLV_CONF_INCLUDE_SIMPLE -DLV_PORT_BLEND_HOST
+ *       -DLV_DRAW_SC32_DMA_HOST -Imid/lvgl -Imid/lvgl/port -Itool tool/dma_host.c
+ *       mid/lvgl/port/lv_draw_sc32_dma.c mid/lvgl/port/lv_port_blend.c
+ *       mid/lvgl/src/draw/sw/lv_draw_sw_blend.c mid/lvgl/src/misc/lv_color.c
+ *       mid/lvgl/src/misc/lv_mem.c mid/lvgl/src/misc/lv_area.c
+ *       mid/lvgl/src/misc/lv_math.c tool/dma_sim.c -no-pie -o dma_host
+ * @file dma_host.c
+ * @author proyrb
+ * @date 2025/8/20
+ * @note 用法：./dma_host [轮数] [随机种子]；
+ * 模块把地址转成uint32_t交给DMA：程序用-no-pie链接、缓冲区用MAP_32BIT映射，
+ * 都落在低4GB之内，只能在x86-64 Linux上运行。
+ */
+
+#include <lv_draw_sc32_dma.h>
+#include <lv_port_layer.h>
+#include <lv_port_mem.h>
+#include <dma_sim.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// 目标缓冲区的宽与高
+#define BUF_W 64
+#define BUF_H 24
+
+// 混合区域的最大宽高
+#define AREA_MAX 80
+
+/********** 代替LVGL其余部分的桩 **********/
+
+lv_mem_buf_arr_t lv_mem_buf;
+
+static lv_disp_drv_t drv;
+static lv_disp_t     disp = {.driver = &drv};
+static lv_disp_t *   refr = &disp;
+
+lv_disp_t * _lv_refr_get_disp_refreshing(void) {
+    return refr;
+}
+
+void _lv_refr_set_disp_refreshing(lv_disp_t * d) {
+    refr = d;
+}
+
+void lv_draw_sw_init_ctx(lv_disp_drv_t * d, lv_draw_ctx_t * draw_ctx) {
+    memset(draw_ctx, 0, sizeof(lv_draw_sw_ctx_t));
+}
+
+void lv_draw_sw_layer_adjust(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx,
+                             lv_draw_layer_flags_t flags) {
+}
+
+void lv_draw_sw_layer_blend(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx,
+                            const lv_draw_img_dsc_t * draw_dsc) {
+}
+
+void lv_draw_sw_buffer_copy(lv_draw_ctx_t * draw_ctx, void * dest_buf,
+                            lv_coord_t dest_stride, const lv_area_t * dest_area,
+                            void * src_buf, lv_coord_t src_stride,
+                            const lv_area_t * src_area) {
+}
+
+void lv_port_layer_init_ctx(lv_draw_ctx_t * draw_ctx) {
+}
+
+void * lv_port_mem_alloc(size_t size) {
+    return malloc(size);
+}
+
+void lv_port_mem_free(void * ptr) {
+    free(ptr);
+}
+
+void * lv_port_mem_realloc(void * ptr, size_t size) {
+    return realloc(ptr, size);
+}
+
+/********** 随机数据 **********/
+
+static uint32_t _rand(const uint32_t n) {
+    return (uint32_t)rand() % n;
+}
+
+static void _rand_pixels(uint16_t * const buf, const uint32_t cnt) {
+    for (uint32_t i = 0; i < cnt; ++i) {
+        buf[i] = (uint16_t)_rand(0x10000);
+    }
+}
+
+/********** 逐位比对 **********/
+
+typedef struct {
+    uint16_t ref[BUF_W * BUF_H + 2];        // 参考实现的目标
+    uint16_t port[BUF_W * BUF_H + 2];       // lv_draw_sc32_dma的目标
+    uint16_t src[AREA_MAX * AREA_MAX + 2];  // 源图，多留出错开半个字的余量
+    lv_opa_t mask[AREA_MAX * AREA_MAX];     // 蒙版，只用来走回退的分支
+} case_buf;
+
+static case_buf * cb;
+
+/**
+ * @brief 随机生成一组参数，分别用两种实现混合并比较结果。
+ * @param ctx 绘制上下文。
+ * @param n 第几轮，用于报告。
+ * @retval 0：相同。
+ * @retval -1：不同。
+ * @warning
+ * @note 多数参数落在DMA接管的范围内，少数走lv_port_blend的回退。
+ */
+static int _check_once(lv_draw_sw_ctx_t * const ctx, const uint32_t n) {
+    /* 目标缓冲区：宽度多数是满宽，随机错开半个字 */
+    const uint32_t off = _rand(2);
+    lv_area_t      buf_area;
+    buf_area.x1 = (int32_t)_rand(4);
+    buf_area.y1 = (int32_t)_rand(4);
+    buf_area.x2 = buf_area.x1 + (_rand(3) ? BUF_W - 1 : (int32_t)_rand(BUF_W));
+    buf_area.x2 -= (int32_t)off;
+    buf_area.y2 = buf_area.y1 + BUF_H - 1;
+    _rand_pixels(cb->ref, BUF_W * BUF_H + 2);
+    memcpy(cb->port, cb->ref, sizeof(cb->ref));
+
+    /* 混合区域可能超出缓冲区，三分之一与缓冲区同宽以覆盖整块传输 */
+    lv_area_t blend_area, clip;
+    blend_area.x1 = buf_area.x1 - 2 + (int32_t)_rand(40);
+    blend_area.y1 = buf_area.y1 - 2 + (int32_t)_rand(20);
+    blend_area.x2 = blend_area.x1;
+    blend_area.x2 += _rand(2) ? buf_area.x2 - buf_area.x1 + 4 : (int32_t)_rand(60);
+    blend_area.y2 = blend_area.y1 + (int32_t)_rand(30);
+    if (_rand(3) == 0) {
+        blend_area.x1 = buf_area.x1;
+        blend_area.x2 = buf_area.x2;
+    }
+    if (!_lv_area_intersect(&clip, &buf_area, &blend_area)) {
+        return 0;
+    }
+
+    _rand_pixels(cb->src, sizeof(cb->src) / 2);
+    memset(cb->mask, 0x80, sizeof(cb->mask));
+
+    lv_draw_sw_blend_dsc_t dsc;
+    memset(&dsc, 0, sizeof(dsc));
+    dsc.blend_area = &blend_area;
+    dsc.mask_area  = &blend_area;
+    dsc.src_buf    = _rand(2) ? (const lv_color_t *)cb->src + _rand(2) : NULL;
+    dsc.color.full = (uint16_t)_rand(0x10000);
+    dsc.opa        = _rand(4) ? LV_OPA_COVER : (lv_opa_t)(250 + _rand(6));
+    dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+    dsc.mask_res   = LV_DRAW_MASK_RES_FULL_COVER;
+    if (_rand(8) == 0) {
+        dsc.mask_buf = cb->mask;
+        dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+    }
+
+    ctx->base_draw.buf_area  = &buf_area;
+    ctx->base_draw.clip_area = &clip;
+
+    ctx->base_draw.buf = cb->ref + off;
+    lv_draw_sw_blend_basic(&ctx->base_draw, &dsc);
+
+    ctx->base_draw.buf = cb->port + off;
+    ctx->blend(&ctx->base_draw, &dsc);
+    ctx->base_draw.wait_for_finish(&ctx->base_draw);
+
+    if (memcmp(cb->ref, cb->port, sizeof(cb->ref)) == 0) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < BUF_W * BUF_H + 2; ++i) {
+        if (cb->ref[i] != cb->port[i]) {
+            printf("round %u: pixel %u lvgl %04x dma %04x (src %d opa %u off %u)\n", n, i,
+                   cb->ref[i], cb->port[i], dsc.src_buf != NULL, dsc.opa, off);
+            break;
+        }
+    }
+    return -1;
+}
+
+int main(int argc, char ** argv) {
+    const uint32_t rounds = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200000;
+    const uint32_t seed   = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+    uint32_t       fails  = 0;
+
+    cb = mmap(NULL, sizeof(case_buf), PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+    if (cb == MAP_FAILED) {
+        printf("mmap failed\n");
+        return 1;
+    }
+
+    lv_draw_sw_ctx_t ctx;
+    lv_draw_sc32_dma_init();
+    lv_draw_sc32_dma_ctx_init(&drv, &ctx.base_draw);
+
+    srand(seed);
+    for (uint32_t n = 0; n < rounds; ++n) {
+        if ((_check_once(&ctx, n) != 0) && (++fails >= 10)) {
+            break;
+        }
+    }
+    printf("bit-exact: %u rounds, %u mismatches, %u channel errors\n", rounds, fails,
+           dma_sim_errors);
+
+    lv_draw_sc32_dma_print(printf);
+    return ((fails == 0) && (dma_sim_errors == 0)) ? 0 : 1;
+}
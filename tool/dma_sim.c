@@ -0,0 +1,106 @@
+#include <dma_sim.h>
+#include <lv_draw_sc32_dma.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/********** 模拟的DMA通道 **********/
+
+DMA_TypeDef dma_sim_ch;
+uint32_t    dma_sim_errors = 0;
+
+static uint8_t armed = 0;  // 已经触发、还没有搬运的传输
+
+void DMA_Cmd(DMA_TypeDef * dma, FunctionalState state) {
+    if (state == ENABLE) {
+        dma->DMA_CFG |= DMA_CFG_CHEN;
+    } else {
+        dma->DMA_CFG &= ~DMA_CFG_CHEN;
+    }
+}
+
+void DMA_SetSrcAddress(DMA_TypeDef * dma, uint32_t adr) {
+    dma->DMA_SADR = adr;
+}
+
+void DMA_SetDstAddress(DMA_TypeDef * dma, uint32_t adr) {
+    dma->DMA_DADR = adr;
+}
+
+void DMA_SetCurrDataCounter(DMA_TypeDef * dma, uint32_t cnt) {
+    dma->DMA_CNT = cnt;
+}
+
+void DMA_SoftwareTrigger(DMA_TypeDef * dma) {
+    if (armed || ((dma->DMA_CFG & DMA_CFG_CHEN) == 0)) {
+        printf("trigger: %s\n", armed ? "transfer not done" : "channel disabled");
+        ++dma_sim_errors;
+        return;
+    }
+    armed = 1;
+}
+
+/**
+ * @brief 完成已经触发的传输：按配置搬运，再进入完成中断，直到中断不再续传。
+ * @param
+ * @retval
+ * @warning
+ * @note 中断里续传的下一行在这里的循环中接着搬运。
+ */
+static void _dma_run(void) {
+    while (armed) {
+        armed = 0;
+
+        const DMA_TypeDef *   d   = &dma_sim_ch;
+        const uint32_t        w   = d->DMA_CFG & DMA_CFG_TXWIDTH;
+        const uint32_t        u   = (w == DMA_DataSize_Word) ? 4 : 2;
+        const int             inc = (d->DMA_CFG & DMA_CFG_SAINC) == DMA_SourceMode_INC;
+        uint8_t * const       dst = (uint8_t *)(uintptr_t)d->DMA_DADR;
+        const uint8_t * const src = (const uint8_t *)(uintptr_t)d->DMA_SADR;
+
+        if ((d->DMA_DADR | d->DMA_SADR) % u) {
+            printf("transfer: %08x <- %08x not aligned to %u\n", d->DMA_DADR, d->DMA_SADR,
+                   u);
+            ++dma_sim_errors;
+        }
+        for (uint32_t i = 0; i < d->DMA_CNT; ++i) {
+            memcpy(dst + i * u, src + (inc ? i * u : 0), u);
+        }
+        lv_draw_sc32_dma_irq();
+    }
+}
+
+/********** 模拟的信号量 **********/
+
+int rt_sem_init(struct rt_semaphore * sem, const char * name, uint32_t value,
+                uint8_t flag) {
+    sem->value = (int)value;
+    return RT_EOK;
+}
+
+int rt_sem_trytake(struct rt_semaphore * sem) {
+    /* 一半的情况下DMA在等待之前就已经完成 */
+    if (rand() % 2) {
+        _dma_run();
+    }
+    if (sem->value > 0) {
+        --sem->value;
+        return RT_EOK;
+    }
+    return -RT_ETIMEOUT;
+}
+
+int rt_sem_take(struct rt_semaphore * sem, int32_t time) {
+    _dma_run();
+    if (sem->value <= 0) {
+        printf("take: nothing will release the semaphore\n");
+        exit(1);
+    }
+    --sem->value;
+    return RT_EOK;
+}
+
+int rt_sem_release(struct rt_semaphore * sem) {
+    ++sem->value;
+    return RT_EOK;
+}
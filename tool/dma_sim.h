@@ -0,0 +1,81 @@
+#ifndef DMA_SIM_H
+#define DMA_SIM_H
+
+/**
+ * @brief 这是主机上运行的SC32 DMA通道与RT-Thread信号量的模拟模块。
+ * @details 以定义了LV_DRAW_SC32_DMA_HOST的方式编译lv_draw_sc32_dma.c时，
+ * 由它代替sc32_conf.h、rtthread.h与rthw.h：寄存器、配置位与DMA_*函数的名字与SC32 HAL相同，
+ * 软件触发只记下一次传输，等到LVGL线程等待信号量时才真正搬运并进入完成中断，
+ * 所以模块在DMA完成之前读写缓冲区的错误会反映在结果里。
+ * 传输时检查通道已经打开、首地址对齐到传输宽度，上一次传输没有完成时不能再次触发，
+ * 违反的次数记在dma_sim_errors中。
+ * @file dma_sim.h
+ * @author proyrb
+ * @date 2025/8/20
+ * @note 只在主机工具中使用，不参与固件编译；函数在tool/dma_sim.c中实现，
+ * tool/dma_host.c与tool/cull_host.c都链接它。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <stdint.h>
+
+/********** 模拟的寄存器 **********/
+
+typedef struct {
+    uint32_t DMA_SADR;  // 源地址
+    uint32_t DMA_DADR;  // 目标地址
+    uint32_t DMA_CFG;   // 配置
+    uint32_t DMA_CNT;   // 数据个数
+    uint32_t DMA_STS;   // 状态，未使用
+} DMA_TypeDef;
+
+extern DMA_TypeDef dma_sim_ch;
+extern uint32_t    dma_sim_errors;  // 违反通道使用规则的次数
+
+#define DMA3 (&dma_sim_ch)
+
+// 与SC32 HAL相同的配置位
+#define DMA_CFG_TXWIDTH (0x3UL << 2)
+#define DMA_CFG_CHEN    (0x1UL << 7)
+#define DMA_CFG_SAINC   (0x3UL << 10)
+
+#define DMA_DataSize_HalfWord (0x1UL << 2)
+#define DMA_DataSize_Word     (0x2UL << 2)
+#define DMA_SourceMode_FIXED  (0x0UL << 10)
+#define DMA_SourceMode_INC    (0x1UL << 10)
+
+// 主机缓冲区都在低4GB之内，全部当作Flash中的源图
+#define SRAM_BASE (0xFFFFFFF0UL)
+
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+
+extern void DMA_Cmd(DMA_TypeDef * dma, FunctionalState state);
+extern void DMA_SetSrcAddress(DMA_TypeDef * dma, uint32_t adr);
+extern void DMA_SetDstAddress(DMA_TypeDef * dma, uint32_t adr);
+extern void DMA_SetCurrDataCounter(DMA_TypeDef * dma, uint32_t cnt);
+extern void DMA_SoftwareTrigger(DMA_TypeDef * dma);
+
+/********** 模拟的RT-Thread **********/
+
+#define RT_EOK             0
+#define RT_ETIMEOUT        2
+#define RT_IPC_FLAG_FIFO   0
+#define RT_WAITING_FOREVER (-1)
+
+typedef long rt_base_t;
+
+struct rt_semaphore {
+    int value;  // 计数
+};
+
+extern int rt_sem_init(struct rt_semaphore * sem, const char * name, uint32_t value,
+                       uint8_t flag);
+extern int rt_sem_trytake(struct rt_semaphore * sem);
+extern int rt_sem_take(struct rt_semaphore * sem, int32_t time);
+extern int rt_sem_release(struct rt_semaphore * sem);
+
+#define rt_hw_interrupt_disable()  (0)
+#define rt_hw_interrupt_enable(lv) ((void)(lv))
+
+#endif  // DMA_SIM_H
@@ -0,0 +1,125 @@
+#include <flash_sim.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 计算一次传输的耗时。
+ * @param sim 模拟芯片。
+ * @param lines 数据阶段的线数。
+ * @param bytes 数据字节数。
+ * @retval 耗时（ns）。
+ * @warning
+ * @note 指令与3字节地址固定按单线发送。
+ */
+static uint64_t _sim_xfer_ns(const flash_sim * const sim, const uint8_t lines,
+                             const uint32_t bytes) {
+    const uint64_t bit_ns = 1000000 / sim->timing.sck_khz;
+    uint64_t       ns     = sim->timing.cmd_ns + 4 * 8 * bit_ns;
+    ns += (uint64_t)bytes * 8 / lines * bit_ns;
+    return ns;
+}
+
+/**
+ * @brief 计算本次编程/擦除在掉电前完成的字节数。
+ * @param sim 模拟芯片。
+ * @param size 本次操作的字节数。
+ * @retval size：正常完成。
+ * @retval <size：掉电。
+ * @warning 必须在计数加1之后调用。
+ * @note 掉电之后芯片一直没电，后续的编程/擦除都不会生效。
+ */
+static uint32_t _sim_power_keep(flash_sim * const sim, const uint32_t size) {
+    const uint32_t n = sim->prog_cnt + sim->erase_cnt;
+    if ((sim->fail_at == 0) || (n < sim->fail_at)) {
+        return size;
+    }
+    if (n > sim->fail_at) {
+        return 0;
+    }
+    return sim->fail_keep % size;
+}
+
+int flash_sim_init(flash_sim * const sim, const uint32_t capacity,
+                   const uint32_t page_size) {
+    memset(sim, 0, sizeof(*sim));
+    sim->mem = malloc(capacity);
+    if (sim->mem == NULL) {
+        return -1;
+    }
+    memset(sim->mem, 0xFF, capacity);
+    sim->capacity  = capacity;
+    sim->page_size = page_size;
+
+    sim->timing.sck_khz     = 16000;
+    sim->timing.cmd_ns      = 6000;
+    sim->timing.poll_ns[0]  = 0;
+    sim->timing.poll_ns[1]  = 900;
+    sim->timing.poll_ns[2]  = 900;
+    sim->timing.page_us     = 400;
+    sim->timing.erase_ms[0] = 45;
+    sim->timing.erase_ms[1] = 120;
+    sim->timing.erase_ms[2] = 150;
+
+    return 0;
+}
+
+void flash_sim_deinit(flash_sim * const sim) {
+    free(sim->mem);
+    sim->mem = NULL;
+}
+
+int flash_sim_read(flash_sim * const sim, const uint8_t lines, const uint32_t adr,
+                   void * const buf, const uint32_t size) {
+    if ((adr + size > sim->capacity) || (lines != 1 && lines != 2 && lines != 4)) {
+        return -1;
+    }
+    memcpy(buf, sim->mem + adr, size);
+
+    /* 2线与4线读取逐字节接收，软件开销远大于线上时间 */
+    const uint8_t idx = (lines == 1) ? 0 : (lines == 2) ? 1 : 2;
+    sim->now_ns += _sim_xfer_ns(sim, lines, size);
+    sim->now_ns += (uint64_t)size * sim->timing.poll_ns[idx];
+    return 0;
+}
+
+int flash_sim_program(flash_sim * const sim, const uint32_t adr,
+                      const void * const buf, const uint32_t size) {
+    if ((adr + size > sim->capacity) ||
+        (adr / sim->page_size != (adr + size - 1) / sim->page_size)) {
+        return -1;
+    }
+
+    ++sim->prog_cnt;
+    const uint8_t * src = buf;
+    const uint32_t  cnt = _sim_power_keep(sim, size);
+    for (uint32_t i = 0; i < cnt; ++i) {
+        sim->mem[adr + i] &= src[i];
+    }
+
+    sim->now_ns += _sim_xfer_ns(sim, 1, size);
+    sim->now_ns += (uint64_t)sim->timing.page_us * 1000;
+    return (cnt == size) ? 0 : -1;
+}
+
+int flash_sim_erase(flash_sim * const sim, const uint32_t size, const uint32_t adr) {
+    uint8_t idx = 0;
+    if (size == 4 * 1024) {
+        idx = 0;
+    } else if (size == 32 * 1024) {
+        idx = 1;
+    } else if (size == 64 * 1024) {
+        idx = 2;
+    } else {
+        return -1;
+    }
+    if (adr >= sim->capacity) {
+        return -1;
+    }
+
+    ++sim->erase_cnt;
+    sim->now_ns += _sim_xfer_ns(sim, 1, 0);
+    sim->now_ns += (uint64_t)sim->timing.erase_ms[idx] * 1000000;
+    const uint32_t cnt = _sim_power_keep(sim, size);
+    memset(sim->mem + (adr & ~(size - 1)), 0xFF, cnt);
+    return (cnt == size) ? 0 : -1;
+}
@@ -0,0 +1,109 @@
+#ifndef FLASH_SIM_H
+#define FLASH_SIM_H
+
+/**
+ * @brief 这是主机上运行的NOR Flash模拟模块。
+ * @details 用内存模拟W25Q系列芯片：编程只能把1变成0，擦除把整块填成0xFF；
+ * 每次访问都按SPI时钟、指令开销与芯片典型时间推进一个虚拟时钟，
+ * 因此主机上得到的耗时与板上实测处于同一量级。
+ * @file flash_sim.h
+ * @author proyrb
+ * @date 2025/8/14
+ * @note 只在主机工具中使用，不参与固件编译。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <stdint.h>
+
+/********** 时序模型 **********/
+
+typedef struct {
+    uint32_t sck_khz;      // SPI时钟
+    uint32_t cmd_ns;       // 每次传输的固定开销：片选、指令与地址之外的软件耗时
+    uint32_t poll_ns[3];   // 1、2、4线读取时每字节的额外软件开销
+    uint32_t page_us;      // 典型页编程时间
+    uint32_t erase_ms[3];  // 4KB、32KB、64KB典型擦除时间
+} flash_sim_timing;
+
+/********** 模拟芯片 **********/
+
+typedef struct {
+    uint8_t *        mem;        // 存储内容
+    uint32_t         capacity;   // 容量
+    uint32_t         page_size;  // 页大小
+    flash_sim_timing timing;     // 时序模型
+    uint64_t         now_ns;     // 虚拟时钟
+    uint32_t         prog_cnt;   // 编程次数
+    uint32_t         erase_cnt;  // 擦除次数
+    uint32_t         fail_at;    // 在第几次编程/擦除时掉电，之后一直没电；0表示不掉电
+    uint32_t         fail_keep;  // 掉电的那次操作完成的字节数，对操作字节数取模
+} flash_sim;
+
+/********** 导出的函数 **********/
+
+/**
+ * @brief 创建模拟芯片，内容初始化为0xFF。
+ * @param sim 模拟芯片。
+ * @param capacity 容量。
+ * @param page_size 页大小。
+ * @retval 0：成功。
+ * @retval -1：内存不足。
+ * @warning
+ * @note 时序模型取W25Q64JV在16MHz下的典型值，可以在创建后修改sim->timing。
+ */
+extern int flash_sim_init(flash_sim * const sim, const uint32_t capacity,
+                          const uint32_t page_size);
+
+/**
+ * @brief 释放模拟芯片。
+ * @param sim 模拟芯片。
+ * @retval
+ * @warning
+ * @note
+ */
+extern void flash_sim_deinit(flash_sim * const sim);
+
+/**
+ * @brief 读取数据。
+ * @param sim 模拟芯片。
+ * @param lines 线数：1、2或4。
+ * @param adr 起始地址。
+ * @param buf 接收缓冲区。
+ * @param size 字节数。
+ * @retval 0：成功。
+ * @retval -1：越界或线数错误。
+ * @warning
+ * @note
+ */
+extern int flash_sim_read(flash_sim * const sim, const uint8_t lines, const uint32_t adr,
+                          void * const buf, const uint32_t size);
+
+/**
+ * @brief 编程数据：按位与到原有内容上。
+ * @param sim 模拟芯片。
+ * @param adr 起始地址。
+ * @param buf 数据。
+ * @param size 字节数：不能跨页。
+ * @retval 0：成功。
+ * @retval -1：越界、跨页或模拟掉电。
+ * @warning
+ * @note 掉电时只写入前fail_keep % size字节，之后的编程全部失败。
+ */
+extern int flash_sim_program(flash_sim * const sim, const uint32_t adr,
+                             const void * const buf, const uint32_t size);
+
+/**
+ * @brief 擦除一个块。
+ * @param sim 模拟芯片。
+ * @param size 块大小：4KB、32KB或64KB。
+ * @param adr 块内任意地址。
+ * @retval 0：成功。
+ * @retval -1：越界、大小错误或模拟掉电。
+ * @warning
+ * @note 掉电时只有块内前fail_keep % size字节变为0xFF，之后的擦除全部失败。
+ */
+extern int flash_sim_erase(flash_sim * const sim, const uint32_t size,
+                           const uint32_t adr);
+
+#endif  // FLASH_SIM_H
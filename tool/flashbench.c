@@ -0,0 +1,68 @@
+/**
+ * @brief 这是flashbench的主机版本。
+ * @details 把drv/w25q64/w25q64_bench.c接到flash_sim模拟芯片上运行，用于在没有板子时估算吞吐率。
+ * 编译：gcc -std=gnu11 -O2 -DW25Q64_BENCH_HOST -Idrv/w25q64 -Itool
+ *       tool/flashbench.c tool/flash_sim.c drv/w25q64/w25q64_bench.c -o flashbench
+ * @file flashbench.c
+ * @author proyrb
+ * @date 2025/8/14
+ * @note 用法：./flashbench [scratch]
+ */
+
+#include <w25q64_bench.h>
+#include <flash_sim.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// 模拟W25Q64：8MB，256字节页
+#define SIM_CAPACITY  (8 * 1024 * 1024)
+#define SIM_PAGE_SIZE 256
+
+// 每次读取的字节数，与板上一致
+#define BENCH_BUF_SIZE 512
+
+static flash_sim sim;
+
+static uint32_t _host_now_us(void) {
+    return (uint32_t)(sim.now_ns / 1000);
+}
+
+static int _host_read(uint8_t lines, uint32_t adr, void * buf, uint32_t size) {
+    return flash_sim_read(&sim, lines, adr, buf, size);
+}
+
+static int _host_program(uint32_t adr, const void * buf, uint32_t size) {
+    return flash_sim_program(&sim, adr, buf, size);
+}
+
+static int _host_erase(uint32_t size, uint32_t adr) {
+    return flash_sim_erase(&sim, size, adr);
+}
+
+int main(int argc, char ** argv) {
+    if (flash_sim_init(&sim, SIM_CAPACITY, SIM_PAGE_SIZE) != 0) {
+        fprintf(stderr, "flashbench: no memory\n");
+        return 1;
+    }
+
+    const w25q64_bench_ops ops = {
+        .capacity  = SIM_CAPACITY,
+        .page_size = SIM_PAGE_SIZE,
+        .now_us    = _host_now_us,
+        .read      = _host_read,
+        .program   = _host_program,
+        .erase     = _host_erase,
+        .print     = printf,
+    };
+
+    uint32_t scratch = SIM_CAPACITY - W25Q64_BENCH_SCRATCH;
+    if (argc > 1) {
+        scratch = strtoul(argv[1], NULL, 0);
+    }
+
+    static uint8_t buf[BENCH_BUF_SIZE];
+    const int      ret = w25q64_bench_run(&ops, scratch, buf, sizeof(buf));
+
+    flash_sim_deinit(&sim);
+    return (ret == 0) ? 0 : 1;
+}
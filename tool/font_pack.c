@@ -0,0 +1,328 @@
+/**
+ * @brief 这是把LVGL的C字体转换成lv_port_font文件格式的主机工具。
+ * @details 把lv_font_conv生成的C字体（--format lvgl --no-compress）编译进来，
+ * 逐个字符调用它的get_glyph_dsc与get_glyph_bitmap，按字符顺序写出文件头、页表、
+ * 字符表、字形表与位图；写完后用板上同一份lv_port_font.c和lv_port_glyph.c
+ * （文件系统换成stdio）重新打开，逐个字符比较描述与位图，再随机查找一遍测试缓存。
+ * 生成的文件用lfs_image放进文件系统镜像，板上用lv_port_font_load打开。
+ * 编译：gcc -std=gnu11 -O2 -DLV_CONF_INCLUDE_SIMPLE -DLV_LVGL_H_INCLUDE_SIMPLE
+ *       -DLV_PORT_FONT_HOST -DLV_PORT_GLYPH_HOST -DFONT_NAME=lv_font_simsun_16_cjk
+ *       -DLV_FONT_SIMSUN_16_CJK=1 -Imid/lvgl -Imid/lvgl/port tool/font_pack.c
+ *       mid/lvgl/src/font/lv_font_simsun_16_cjk.c mid/lvgl/port/lv_port_font.c
+ *       mid/lvgl/port/lv_port_glyph.c mid/lvgl/src/font/lv_font_fmt_txt.c
+ *       mid/lvgl/src/font/lv_font.c mid/lvgl/src/misc/lv_fs.c
+ *       mid/lvgl/src/misc/lv_lru.c mid/lvgl/src/misc/lv_mem.c
+ *       mid/lvgl/src/misc/lv_ll.c mid/lvgl/src/misc/lv_gc.c
+ *       mid/lvgl/src/misc/lv_math.c mid/lvgl/src/misc/lv_utils.c -o font_pack
+ * @file font_pack.c
+ * @author proyrb
+ * @date 2025/8/20
+ * @note 用法：./font_pack <输出文件>
+ * 上面转换的是LVGL自带的simsun_16_cjk：它在lv_conf.h中是关闭的，需要用-D打开。
+ * 转换别的字体时把FONT_NAME与字体源文件换成lv_font_conv的输出，去掉-DLV_FONT_SIMSUN_16_CJK=1；
+ * lv_font_conv生成的字体没有定义开关时默认编译，不需要改动lv_conf.h。
+ * 不支持压缩字体与字距调整，字形数不能超过65535。
+ */
+
+#include <lv_port_font.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef FONT_NAME
+#    error "define FONT_NAME as the lv_font_t to convert"
+#endif
+
+// 最大的字符：Unicode的上限
+#define CP_MAX 0x10FFFF
+
+// 最多的字形数
+#define GLYPH_MAX 0xFFFF
+
+// 随机查找的次数，以及其中常用字的个数
+#define VERIFY_ROUNDS 200000
+#define HOT_CNT       40
+
+LV_FONT_DECLARE(FONT_NAME);
+
+/********** 代替LVGL其余部分的桩 **********/
+
+void * lv_port_mem_alloc(size_t size) {
+    return malloc(size);
+}
+
+void lv_port_mem_free(void * ptr) {
+    free(ptr);
+}
+
+void * lv_port_mem_realloc(void * ptr, size_t size) {
+    return realloc(ptr, size);
+}
+
+/********** 用stdio代替lv_port_fs **********/
+
+static void * _fs_open(lv_fs_drv_t * drv, const char * path, lv_fs_mode_t mode) {
+    return fopen(path, "rb");
+}
+
+static lv_fs_res_t _fs_close(lv_fs_drv_t * drv, void * file) {
+    fclose(file);
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t _fs_read(lv_fs_drv_t * drv, void * file, void * buf, uint32_t btr,
+                            uint32_t * br) {
+    *br = (uint32_t)fread(buf, 1, btr, file);
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t _fs_seek(lv_fs_drv_t * drv, void * file, uint32_t pos,
+                            lv_fs_whence_t whence) {
+    const int w = (whence == LV_FS_SEEK_SET) ? SEEK_SET
+                  : (whence == LV_FS_SEEK_CUR) ? SEEK_CUR
+                                               : SEEK_END;
+    return (fseek(file, pos, w) == 0) ? LV_FS_RES_OK : LV_FS_RES_UNKNOWN;
+}
+
+static lv_fs_res_t _fs_tell(lv_fs_drv_t * drv, void * file, uint32_t * pos) {
+    *pos = (uint32_t)ftell(file);
+    return LV_FS_RES_OK;
+}
+
+/**
+ * @brief 注册盘符为F的stdio驱动，与板上lv_port_fs的盘符相同。
+ * @param
+ * @retval
+ * @warning
+ * @note 缓存大小与板上相同，预读的行为也就相同。
+ */
+static void _fs_init(void) {
+    static lv_fs_drv_t drv;
+    _lv_fs_init();
+    lv_fs_drv_init(&drv);
+    drv.letter     = 'F';
+    drv.cache_size = 512;
+    drv.open_cb    = _fs_open;
+    drv.close_cb   = _fs_close;
+    drv.read_cb    = _fs_read;
+    drv.seek_cb    = _fs_seek;
+    drv.tell_cb    = _fs_tell;
+    lv_fs_drv_register(&drv);
+}
+
+/********** 转换 **********/
+
+static uint32_t           codes[GLYPH_MAX];  // 每个字形的字符
+static uint32_t           code_cnt;          // 字形数
+static lv_port_font_glyph glyphs[GLYPH_MAX];
+static lv_port_font_page  pages[(CP_MAX >> 8) + 1];
+
+/**
+ * @brief 计算位图的字节数。
+ * @param dsc 字形描述。
+ * @param bpp 每像素位数。
+ * @retval 字节数。
+ * @warning
+ * @note 与lv_port_font.c的计算相同。
+ */
+static uint32_t _bitmap_size(const lv_font_glyph_dsc_t * const dsc, const uint32_t bpp) {
+    return ((uint32_t)dsc->box_w * dsc->box_h * bpp + 7) >> 3;
+}
+
+/**
+ * @brief 把FONT_NAME写成字体文件。
+ * @param path 输出文件。
+ * @retval 0：成功。
+ * @retval -1：字体不支持或者写文件失败。
+ * @warning
+ * @note
+ */
+static int _pack(const char * const path) {
+    const lv_font_t * const             src  = &FONT_NAME;
+    const lv_font_fmt_txt_dsc_t * const fdsc = src->dsc;
+    if ((src->get_glyph_bitmap != lv_font_get_bitmap_fmt_txt) ||
+        (fdsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN)) {
+        fprintf(stderr, "font_pack: only uncompressed lv_font_fmt_txt fonts\n");
+        return -1;
+    }
+    if ((fdsc->bpp != 1) && (fdsc->bpp != 2) && (fdsc->bpp != 4) && (fdsc->bpp != 8)) {
+        fprintf(stderr, "font_pack: bpp %u not supported\n", fdsc->bpp);
+        return -1;
+    }
+
+    /* 按字符顺序收集字形，同时建立页表 */
+    uint32_t glyph_cnt = 0;
+    uint32_t page_cnt  = 0;
+    uint32_t bitmap    = 0;
+    for (uint32_t cp = 0; cp <= CP_MAX; ++cp) {
+        lv_font_glyph_dsc_t dsc;
+        if ((cp == '\t') || !src->get_glyph_dsc(src, &dsc, cp, 0)) {
+            continue;
+        }
+        if (glyph_cnt == GLYPH_MAX) {
+            fprintf(stderr, "font_pack: more than %u glyphs\n", GLYPH_MAX);
+            return -1;
+        }
+        if ((page_cnt == 0) || (pages[page_cnt - 1].page != (cp >> 8))) {
+            pages[page_cnt].page  = (uint16_t)(cp >> 8);
+            pages[page_cnt].first = (uint16_t)glyph_cnt;
+            ++page_cnt;
+        }
+        lv_port_font_glyph * const g = &glyphs[glyph_cnt];
+        g->bitmap                    = bitmap;
+        g->adv_w                     = (uint16_t)dsc.adv_w;
+        g->box_w                     = (uint8_t)dsc.box_w;
+        g->box_h                     = (uint8_t)dsc.box_h;
+        g->ofs_x                     = (int8_t)dsc.ofs_x;
+        g->ofs_y                     = (int8_t)dsc.ofs_y;
+        g->reserved                  = 0;
+        codes[glyph_cnt++]           = cp;
+        bitmap += _bitmap_size(&dsc, fdsc->bpp);
+    }
+
+    lv_port_font_head head = {
+        .magic               = LV_PORT_FONT_MAGIC,
+        .glyph_cnt           = (uint16_t)glyph_cnt,
+        .page_cnt            = (uint16_t)page_cnt,
+        .bpp                 = (uint8_t)fdsc->bpp,
+        .line_height         = (uint8_t)src->line_height,
+        .base_line           = (int8_t)src->base_line,
+        .underline_position  = src->underline_position,
+        .underline_thickness = (uint8_t)src->underline_thickness,
+    };
+    const uint32_t codes_ofs = sizeof(head) + page_cnt * sizeof(lv_port_font_page);
+    head.glyph_ofs           = (codes_ofs + glyph_cnt + 3) & ~3U;
+    head.bitmap_ofs          = head.glyph_ofs + glyph_cnt * sizeof(lv_port_font_glyph);
+
+    FILE * const f = fopen(path, "wb");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    fwrite(&head, sizeof(head), 1, f);
+    fwrite(pages, sizeof(lv_port_font_page), page_cnt, f);
+    for (uint32_t i = 0; i < glyph_cnt; ++i) {
+        fputc((uint8_t)codes[i], f);
+    }
+    for (uint32_t i = codes_ofs + glyph_cnt; i < head.glyph_ofs; ++i) {
+        fputc(0, f);
+    }
+    fwrite(glyphs, sizeof(lv_port_font_glyph), glyph_cnt, f);
+    for (uint32_t i = 0; i < glyph_cnt; ++i) {
+        lv_font_glyph_dsc_t dsc;
+        src->get_glyph_dsc(src, &dsc, codes[i], 0);
+        const uint32_t size = _bitmap_size(&dsc, fdsc->bpp);
+        if (size > 0) {
+            fwrite(src->get_glyph_bitmap(src, codes[i]), 1, size, f);
+        }
+    }
+    const int err = ferror(f);
+    fclose(f);
+    if (err) {
+        fprintf(stderr, "font_pack: write %s failed\n", path);
+        return -1;
+    }
+
+    code_cnt = glyph_cnt;
+    printf("%u glyphs, %u pages (%u bytes in RAM), %u bytes of bitmaps, %u bytes total\n",
+           glyph_cnt, page_cnt, (uint32_t)(page_cnt * sizeof(lv_port_font_page)), bitmap,
+           head.bitmap_ofs + bitmap);
+    return 0;
+}
+
+/********** 校验 **********/
+
+/**
+ * @brief 比较一个字符在两个字体中的描述与位图。
+ * @param src 原字体。
+ * @param font lv_port_font_load打开的字体。
+ * @param cp 字符。
+ * @retval 0：相同。
+ * @retval -1：不同。
+ * @warning
+ * @note 与LVGL一样先取描述再取位图。
+ */
+static int _verify_cp(const lv_font_t * const src, const lv_font_t * const font,
+                      const uint32_t cp) {
+    lv_font_glyph_dsc_t a;
+    lv_font_glyph_dsc_t b;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    const bool fa = src->get_glyph_dsc(src, &a, cp, 0);
+    const bool fb = font->get_glyph_dsc(font, &b, cp, 0);
+    if (fa != fb) {
+        fprintf(stderr, "U+%04X: found %d vs %d\n", cp, fa, fb);
+        return -1;
+    }
+    if (!fa) {
+        return 0;
+    }
+    if ((cp != '\t') && ((a.adv_w != b.adv_w) || (a.box_w != b.box_w) ||
+                         (a.box_h != b.box_h) || (a.ofs_x != b.ofs_x) ||
+                         (a.ofs_y != b.ofs_y) || (a.bpp != b.bpp))) {
+        fprintf(stderr, "U+%04X: glyph descriptor differs\n", cp);
+        return -1;
+    }
+    const uint32_t size = _bitmap_size(&b, b.bpp);
+    if ((cp == '\t') || (size == 0)) {
+        return 0;
+    }
+    const uint8_t * const ma = src->get_glyph_bitmap(src, cp);
+    const uint8_t * const mb = font->get_glyph_bitmap(font, cp);
+    if ((mb == NULL) || (memcmp(ma, mb, size) != 0)) {
+        fprintf(stderr, "U+%04X: bitmap differs\n", cp);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 用lv_port_font打开刚写出的文件，逐个字符与FONT_NAME比较。
+ * @param path 字体文件。
+ * @retval 0：相同。
+ * @retval -1：不同或者打不开。
+ * @warning
+ * @note 先按顺序遍历全部字符，再从字体中的字形随机抽取，测试缓存的命中与淘汰。
+ */
+static int _verify(const char * const path) {
+    const lv_font_t * const src = &FONT_NAME;
+    char                    name[256];
+    snprintf(name, sizeof(name), "F:%s", path);
+
+    _fs_init();
+    const lv_font_t * const font = lv_port_font_load(name);
+    if (font == NULL) {
+        fprintf(stderr, "font_pack: lv_port_font_load %s failed\n", path);
+        return -1;
+    }
+
+    int ret = 0;
+    for (uint32_t cp = 0; (cp <= CP_MAX) && (ret == 0); ++cp) {
+        ret = _verify_cp(src, font, cp);
+    }
+    /* 八成的查找落在少数常用字上，其余均匀分布，与界面文字的分布相近 */
+    srand(1);
+    for (uint32_t n = 0; (n < VERIFY_ROUNDS) && (ret == 0); ++n) {
+        const uint32_t hot = (code_cnt < HOT_CNT) ? code_cnt : HOT_CNT;
+        const uint32_t i   = (rand() % 5 != 0) ? (uint32_t)rand() % hot
+                                               : (uint32_t)rand() % code_cnt;
+        ret = _verify_cp(src, font, codes[i]);
+    }
+
+    lv_port_font_print(printf);
+    lv_port_glyph_print(printf);
+    lv_port_font_free(font);
+    return ret;
+}
+
+int main(int argc, char ** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <output>\n", argv[0]);
+        return 2;
+    }
+    if ((_pack(argv[1]) != 0) || (_verify(argv[1]) != 0)) {
+        return 1;
+    }
+    printf("verify ok\n");
+    return 0;
+}
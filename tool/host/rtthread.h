@@ -0,0 +1,63 @@
+#ifndef RTTHREAD_H_HOST
+#define RTTHREAD_H_HOST
+
+/**
+ * @brief 这是主机工具编译整个LVGL时代替RT-Thread的头文件。
+ * @details lv_conf.h的LV_TICK_CUSTOM_INCLUDE与lv_port_prof、lv_port_cull、lv_port_layer
+ * 都直接包含rtthread.h，主机工具用-Itool/host把这里的版本放在前面：
+ * tick取自主机的单调时钟，MSH命令不导出，rt_kprintf就是printf。
+ * @file rtthread.h
+ * @author proyrb
+ * @date 2025/8/21
+ * @note 只在主机工具中使用，不参与固件编译；SysTick的模拟见同目录的sc32_conf.h。
+ */
+
+/********** 导入需要的头文件 **********/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/********** 模拟的SysTick **********/
+
+typedef struct {
+    volatile uint32_t LOAD;  // 重装值，与board.c相同：HCLK/8下每个tick 8000个计数
+    volatile uint32_t VAL;   // 当前值，向下计数，读取tick时更新
+} host_systick;
+
+extern host_systick host_systick_regs;
+
+/********** 模拟的RT-Thread **********/
+
+#define RT_TICK_PER_SECOND 1000
+
+typedef uint32_t rt_tick_t;
+
+/**
+ * @brief 取得tick，同时按主机时钟更新SysTick的当前值。
+ * @param
+ * @retval tick。
+ * @warning
+ * @note
+ */
+static inline rt_tick_t rt_tick_get(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    const uint64_t ns   = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    const uint64_t tick = 1000000000ULL / RT_TICK_PER_SECOND;
+    const uint32_t load = host_systick_regs.LOAD + 1;
+    host_systick_regs.VAL = host_systick_regs.LOAD - (uint32_t)(ns % tick * load / tick);
+    return (rt_tick_t)(ns / tick);
+}
+
+static inline rt_tick_t rt_tick_get_millisecond(void) {
+    return rt_tick_get() * (1000 / RT_TICK_PER_SECOND);
+}
+
+#define rt_kprintf printf
+
+#define MSH_CMD_EXPORT(command, desc)
+
+#endif  // RTTHREAD_H_HOST
@@ -0,0 +1,17 @@
+#ifndef SC32_CONF_H_HOST
+#define SC32_CONF_H_HOST
+
+/**
+ * @brief 这是主机工具编译lv_port_prof时代替SC32 HAL的头文件。
+ * @details lv_port_prof只用到SysTick的LOAD与VAL，这里指向rtthread.h中按主机时钟更新的模拟寄存器。
+ * @file sc32_conf.h
+ * @author proyrb
+ * @date 2025/8/21
+ * @note 只在主机工具中使用，不参与固件编译。
+ */
+
+#include <rtthread.h>
+
+#define SysTick (&host_systick_regs)
+
+#endif  // SC32_CONF_H_HOST
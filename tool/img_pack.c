@@ -0,0 +1,487 @@
+/**
+ * @brief 这是把图片转换成LVGL可以直接使用的RGB565格式的主机工具。
+ * @details 输入是二进制的PPM（P6）或PAM（P7，RGB或RGB_ALPHA），
+ * 可以用"convert icon.png icon.pam"之类的命令从PNG得到。
+ * 颜色按LVGL的lv_color_make截断成RGB565；透明度全是255时去掉透明度，图片变成不透明的。
+ * 默认按lv_port_img的行程编码输出：扩展名为rle时写成文件，为c时写成lv_img_dsc_t的C数组；
+ * 写出后用板上同一份lv_port_img.c解码两遍（第二遍应当命中缓存），
+ * 逐个像素与转换结果比较，再随机抽取一些行中的片段逐行解码比较。
+ * 加-raw时输出LVGL原生的LV_IMG_CF_TRUE_COLOR(_ALPHA)：扩展名为bin时写成LVGL的图片文件，
+ * 为c时写成C数组；放在内部Flash中的不透明原生图片由lv_draw_sc32_dma直接用DMA复制。
+ * 编译：gcc -std=gnu11 -O2 -DLV_CONF_INCLUDE_SIMPLE -DLV_PORT_IMG_HOST -Imid/lvgl
+ *       -Imid/lvgl/port tool/img_pack.c mid/lvgl/port/lv_port_img.c
+ *       mid/lvgl/src/draw/lv_img_decoder.c mid/lvgl/src/draw/lv_img_buf.c
+ *       mid/lvgl/src/misc/lv_fs.c mid/lvgl/src/misc/lv_lru.c mid/lvgl/src/misc/lv_mem.c
+ *       mid/lvgl/src/misc/lv_ll.c mid/lvgl/src/misc/lv_gc.c
+ *       mid/lvgl/src/misc/lv_math.c mid/lvgl/src/misc/lv_area.c -o img_pack
+ * @file img_pack.c
+ * @author proyrb
+ * @date 2025/8/20
+ * @note 用法：./img_pack [-raw] <输入.ppm|.pam> <输出.rle|.bin|.c>
+ */
+
+#include <lv_port_img.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 随机抽取的行片段数
+#define VERIFY_SPANS 20000
+
+/********** 代替LVGL其余部分的桩 **********/
+
+void * lv_port_mem_alloc(size_t size) {
+    return malloc(size);
+}
+
+void lv_port_mem_free(void * ptr) {
+    free(ptr);
+}
+
+void * lv_port_mem_realloc(void * ptr, size_t size) {
+    return realloc(ptr, size);
+}
+
+lv_img_src_t lv_img_src_get_type(const void * src) {
+    const uint8_t * const u8 = src;
+    if (src == NULL) {
+        return LV_IMG_SRC_UNKNOWN;
+    }
+    if ((u8[0] >= 0x20) && (u8[0] <= 0x7F)) {
+        return LV_IMG_SRC_FILE;
+    }
+    return (u8[0] >= 0x80) ? LV_IMG_SRC_SYMBOL : LV_IMG_SRC_VARIABLE;
+}
+
+uint8_t lv_img_cf_get_px_size(lv_img_cf_t cf) {
+    switch (cf) {
+        case LV_IMG_CF_TRUE_COLOR:
+            return LV_COLOR_SIZE;
+        case LV_IMG_CF_TRUE_COLOR_ALPHA:
+            return LV_IMG_PX_SIZE_ALPHA_BYTE << 3;
+        default:
+            return 0;
+    }
+}
+
+/********** 用stdio代替lv_port_fs **********/
+
+static void * _fs_open(lv_fs_drv_t * drv, const char * path, lv_fs_mode_t mode) {
+    return fopen(path, "rb");
+}
+
+static lv_fs_res_t _fs_close(lv_fs_drv_t * drv, void * file) {
+    fclose(file);
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t _fs_read(lv_fs_drv_t * drv, void * file, void * buf, uint32_t btr,
+                            uint32_t * br) {
+    *br = (uint32_t)fread(buf, 1, btr, file);
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t _fs_seek(lv_fs_drv_t * drv, void * file, uint32_t pos,
+                            lv_fs_whence_t whence) {
+    const int w = (whence == LV_FS_SEEK_SET) ? SEEK_SET
+                  : (whence == LV_FS_SEEK_CUR) ? SEEK_CUR
+                                               : SEEK_END;
+    return (fseek(file, pos, w) == 0) ? LV_FS_RES_OK : LV_FS_RES_UNKNOWN;
+}
+
+static lv_fs_res_t _fs_tell(lv_fs_drv_t * drv, void * file, uint32_t * pos) {
+    *pos = (uint32_t)ftell(file);
+    return LV_FS_RES_OK;
+}
+
+static void _fs_init(void) {
+    static lv_fs_drv_t drv;
+    lv_fs_drv_init(&drv);
+    drv.letter     = 'F';
+    drv.cache_size = 512;
+    drv.open_cb    = _fs_open;
+    drv.close_cb   = _fs_close;
+    drv.read_cb    = _fs_read;
+    drv.seek_cb    = _fs_seek;
+    drv.tell_cb    = _fs_tell;
+    lv_fs_drv_register(&drv);
+}
+
+/********** 读取与转换 **********/
+
+/* 转换后的图片 */
+typedef struct {
+    uint32_t  w;
+    uint32_t  h;
+    uint32_t  px;   // 每像素字节数：2或3
+    uint8_t * pix;  // LVGL的像素：RGB565小端，带透明度时再跟1字节
+} image;
+
+/**
+ * @brief 读取PPM/PAM头中的下一个词，跳过空白与注释。
+ * @param f 文件。
+ * @param buf 词。
+ * @param size buf的字节数。
+ * @retval 0：成功。
+ * @retval -1：文件结束。
+ * @warning
+ * @note 词后面的一个空白字符也被读掉，正好是像素数据之前的那一个。
+ */
+static int _token(FILE * const f, char * const buf, const uint32_t size) {
+    int c = fgetc(f);
+    while ((c == '#') || (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n')) {
+        if (c == '#') {
+            while ((c != EOF) && (c != '\n')) {
+                c = fgetc(f);
+            }
+        }
+        c = fgetc(f);
+    }
+    uint32_t n = 0;
+    while ((c != EOF) && (c != ' ') && (c != '\t') && (c != '\r') && (c != '\n')) {
+        if (n + 1 < size) {
+            buf[n++] = (char)c;
+        }
+        c = fgetc(f);
+    }
+    buf[n] = '\0';
+    return (n == 0) ? -1 : 0;
+}
+
+/**
+ * @brief 读取图片并转换成LVGL的像素。
+ * @param path 输入文件。
+ * @param img 转换结果。
+ * @retval 0：成功。
+ * @retval -1：打不开或者格式不支持。
+ * @warning
+ * @note
+ */
+static int _load(const char * const path, image * const img) {
+    FILE * const f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    char     tok[32];
+    uint32_t w = 0, h = 0, depth = 3, maxval = 0;
+    _token(f, tok, sizeof(tok));
+    if (strcmp(tok, "P6") == 0) {
+        _token(f, tok, sizeof(tok));
+        w = strtoul(tok, NULL, 10);
+        _token(f, tok, sizeof(tok));
+        h = strtoul(tok, NULL, 10);
+        _token(f, tok, sizeof(tok));
+        maxval = strtoul(tok, NULL, 10);
+    } else if (strcmp(tok, "P7") == 0) {
+        while ((_token(f, tok, sizeof(tok)) == 0) && (strcmp(tok, "ENDHDR") != 0)) {
+            char val[32];
+            _token(f, val, sizeof(val));
+            if (strcmp(tok, "WIDTH") == 0) {
+                w = strtoul(val, NULL, 10);
+            } else if (strcmp(tok, "HEIGHT") == 0) {
+                h = strtoul(val, NULL, 10);
+            } else if (strcmp(tok, "DEPTH") == 0) {
+                depth = strtoul(val, NULL, 10);
+            } else if (strcmp(tok, "MAXVAL") == 0) {
+                maxval = strtoul(val, NULL, 10);
+            }
+        }
+    }
+    if ((w == 0) || (h == 0) || (w > 2047) || (h > 2047) || (maxval != 255) ||
+        ((depth != 3) && (depth != 4))) {
+        fprintf(stderr, "img_pack: %s: need 8-bit P6, or P7 with depth 3 or 4\n", path);
+        fclose(f);
+        return -1;
+    }
+
+    uint8_t * const in = malloc((size_t)w * h * depth);
+    const size_t    n  = fread(in, depth, (size_t)w * h, f);
+    fclose(f);
+    if (n != (size_t)w * h) {
+        fprintf(stderr, "img_pack: %s: truncated\n", path);
+        free(in);
+        return -1;
+    }
+
+    /* 透明度全是255时当作不透明 */
+    uint8_t alpha = 0;
+    for (size_t i = 0; (depth == 4) && (i < n); ++i) {
+        alpha |= in[i * 4 + 3] != 255;
+    }
+    img->w   = w;
+    img->h   = h;
+    img->px  = alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : 2;
+    img->pix = malloc(n * img->px);
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t * const p = &in[i * depth];
+        const lv_color_t      c = lv_color_make(p[0], p[1], p[2]);
+        uint8_t * const       o = &img->pix[i * img->px];
+        o[0]                    = (uint8_t)c.full;
+        o[1]                    = (uint8_t)(c.full >> 8);
+        if (alpha) {
+            o[2] = p[3];
+        }
+    }
+    free(in);
+    return 0;
+}
+
+/********** 行程编码 **********/
+
+/**
+ * @brief 按lv_port_img的格式编码整张图。
+ * @param img 图片。
+ * @param size 编码后的字节数（不包括lv_img_header_t）。
+ * @retval 编码后的数据。
+ * @warning
+ * @note 相同的像素连续出现两次以上就用重复包，否则累积成原样包，每包最多128个像素。
+ */
+static uint8_t * _encode(const image * const img, uint32_t * const size) {
+    const uint32_t  px   = img->px;
+    const uint32_t  rows = sizeof(lv_port_img_head) + (img->h + 1) * sizeof(uint32_t);
+    const uint32_t  most = img->w * px + img->w / 128 + 1;  // 一行最坏情况：全是原样包
+    uint8_t * const out  = malloc(rows + (size_t)img->h * most);
+    uint32_t        pos  = rows;
+
+    lv_port_img_head head = {.magic = LV_PORT_IMG_MAGIC,
+                             .flags = (px == 2) ? 0 : LV_PORT_IMG_ALPHA};
+    memcpy(out, &head, sizeof(head));
+    for (uint32_t y = 0; y < img->h; ++y) {
+        const uint32_t ofs = pos - rows;
+        memcpy(out + sizeof(head) + y * sizeof(uint32_t), &ofs, sizeof(ofs));
+
+        const uint8_t * const line = &img->pix[(size_t)y * img->w * px];
+        uint32_t              x    = 0;
+        while (x < img->w) {
+            uint32_t r = 1;
+            while ((x + r < img->w) && (r < 128) &&
+                   (memcmp(&line[(x + r) * px], &line[x * px], px) == 0)) {
+                ++r;
+            }
+            if (r >= 2) {
+                out[pos++] = (uint8_t)(0x80 | (r - 1));
+                memcpy(&out[pos], &line[x * px], px);
+                pos += px;
+                x += r;
+                continue;
+            }
+
+            const uint32_t start = x;
+            while ((x < img->w) && (x - start < 128) &&
+                   !((x + 1 < img->w) &&
+                     (memcmp(&line[(x + 1) * px], &line[x * px], px) == 0))) {
+                ++x;
+            }
+            out[pos++] = (uint8_t)(x - start - 1);
+            memcpy(&out[pos], &line[start * px], (x - start) * px);
+            pos += (x - start) * px;
+        }
+    }
+    const uint32_t end = pos - rows;
+    memcpy(out + sizeof(head) + img->h * sizeof(uint32_t), &end, sizeof(end));
+    *size = pos;
+    return out;
+}
+
+/********** 输出 **********/
+
+/**
+ * @brief 取得C数组的变量名：文件名去掉目录与扩展名。
+ * @param path 输出文件。
+ * @param name 变量名。
+ * @param size name的字节数。
+ * @retval
+ * @warning
+ * @note 不能出现在标识符中的字符换成下划线。
+ */
+static void _name(const char * const path, char * const name, const uint32_t size) {
+    const char * base = strrchr(path, '/');
+    base              = (base == NULL) ? path : base + 1;
+    uint32_t n        = 0;
+    while ((base[n] != '\0') && (base[n] != '.') && (n + 1 < size)) {
+        const char c = base[n];
+        name[n]      = ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+                   (c >= 'A' && c <= 'Z'))
+                           ? c
+                           : '_';
+        ++n;
+    }
+    name[n] = '\0';
+}
+
+static int _write(const char * const path, const lv_img_header_t * const header,
+                  const uint8_t * const data, const uint32_t size,
+                  const char * const cf) {
+    const char * const ext = strrchr(path, '.');
+    FILE * const       f   = fopen(path, "wb");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    if ((ext == NULL) || (strcmp(ext, ".c") != 0)) {
+        fwrite(header, sizeof(*header), 1, f);
+        fwrite(data, 1, size, f);
+    } else {
+        char name[64];
+        _name(path, name, sizeof(name));
+        fprintf(f, "#include <lvgl.h>\n\n");
+        fprintf(f, "static const LV_ATTRIBUTE_MEM_ALIGN uint8_t %s_map[] = {", name);
+        for (uint32_t i = 0; i < size; ++i) {
+            fprintf(f, "%s0x%02x,", (i % 16 == 0) ? "\n    " : " ", data[i]);
+        }
+        fprintf(f, "\n};\n\n");
+        fprintf(f, "const lv_img_dsc_t %s = {\n", name);
+        fprintf(f, "    .header.cf          = %s,\n", cf);
+        fprintf(f, "    .header.always_zero = 0,\n");
+        fprintf(f, "    .header.w           = %u,\n", header->w);
+        fprintf(f, "    .header.h           = %u,\n", header->h);
+        fprintf(f, "    .data_size          = %u,\n", size);
+        fprintf(f, "    .data               = %s_map,\n", name);
+        fprintf(f, "};\n");
+    }
+    const int err = ferror(f);
+    fclose(f);
+    if (err) {
+        fprintf(stderr, "img_pack: write %s failed\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/********** 校验 **********/
+
+/**
+ * @brief 用lv_port_img解码一次并与转换结果比较。
+ * @param img 转换结果。
+ * @param src 图片来源。
+ * @param hit 输出：这次打开是否命中缓存。
+ * @retval 0：相同。
+ * @retval -1：不同或者打不开。
+ * @warning
+ * @note 整张解码进缓存时比较整张图，否则逐行读取整行，再随机读取行中的片段。
+ */
+static int _verify_once(const image * const img, const void * const src,
+                        uint8_t * const hit) {
+    lv_port_img_stat before;
+    lv_port_img_stat after;
+    lv_port_img_info(&before);
+
+    lv_img_decoder_dsc_t dsc;
+    if (lv_img_decoder_open(&dsc, src, lv_color_black(), 0) != LV_RES_OK) {
+        fprintf(stderr, "img_pack: lv_img_decoder_open failed\n");
+        return -1;
+    }
+    lv_port_img_info(&after);
+    *hit = after.hits != before.hits;
+
+    const uint32_t row = img->w * img->px;
+    int            ret = 0;
+    if (dsc.img_data != NULL) {
+        ret = memcmp(dsc.img_data, img->pix, (size_t)row * img->h) ? -1 : 0;
+    } else {
+        uint8_t * const buf = malloc(row);
+        for (uint32_t y = 0; (y < img->h) && (ret == 0); ++y) {
+            ret = ((lv_img_decoder_read_line(&dsc, 0, y, img->w, buf) != LV_RES_OK) ||
+                   memcmp(buf, &img->pix[(size_t)y * row], row))
+                      ? -1
+                      : 0;
+        }
+        for (uint32_t n = 0; (n < VERIFY_SPANS) && (ret == 0); ++n) {
+            const uint32_t y   = (uint32_t)rand() % img->h;
+            const uint32_t x   = (uint32_t)rand() % img->w;
+            const uint32_t len = 1 + (uint32_t)rand() % (img->w - x);
+            ret = ((lv_img_decoder_read_line(&dsc, x, y, len, buf) != LV_RES_OK) ||
+                   memcmp(buf, &img->pix[(size_t)y * row + x * img->px], len * img->px))
+                      ? -1
+                      : 0;
+        }
+        free(buf);
+    }
+    lv_img_decoder_close(&dsc);
+    if (ret != 0) {
+        fprintf(stderr, "img_pack: decoded pixels differ\n");
+    }
+    return ret;
+}
+
+/**
+ * @brief 从内存与输出文件各解码两遍。
+ * @param img 转换结果。
+ * @param header 图片头。
+ * @param data 编码后的数据。
+ * @param size 字节数。
+ * @param path 输出文件：不是rle文件时只从内存解码。
+ * @retval 0：相同。
+ * @retval -1：不同。
+ * @warning
+ * @note
+ */
+static int _verify(const image * const img, const lv_img_header_t * const header,
+                   const uint8_t * const data, const uint32_t size,
+                   const char * const path) {
+    lv_mem_init();
+    _lv_fs_init();
+    _lv_img_decoder_init();
+    _fs_init();
+    if (lv_port_img_init() != LV_RES_OK) {
+        return -1;
+    }
+
+    const lv_img_dsc_t var = {.header = *header, .data_size = size, .data = data};
+    char               name[256];
+    snprintf(name, sizeof(name), "F:%s", path);
+    const char * const ext = strrchr(path, '.');
+    const uint8_t      rle = (ext != NULL) && (strcmp(ext, ".rle") == 0);
+
+    uint8_t hit[4] = {0};
+    srand(1);
+    if ((_verify_once(img, &var, &hit[0]) != 0) ||
+        (_verify_once(img, &var, &hit[1]) != 0) ||
+        (rle && ((_verify_once(img, name, &hit[2]) != 0) ||
+                 (_verify_once(img, name, &hit[3]) != 0)))) {
+        return -1;
+    }
+    lv_port_img_print(printf);
+    printf("verify ok (%s)\n", hit[1] ? "cached" : "line by line");
+    return 0;
+}
+
+int main(int argc, char ** argv) {
+    const uint8_t raw = (argc == 4) && (strcmp(argv[1], "-raw") == 0);
+    if ((argc != 3) && !raw) {
+        fprintf(stderr, "usage: %s [-raw] <input.ppm|.pam> <output.rle|.bin|.c>\n",
+                argv[0]);
+        return 2;
+    }
+    const char * const in  = argv[argc - 2];
+    const char * const out = argv[argc - 1];
+
+    image img;
+    if (_load(in, &img) != 0) {
+        return 1;
+    }
+    lv_img_header_t header = {.w = img.w, .h = img.h};
+    const uint32_t  bytes  = img.w * img.h * img.px;
+
+    if (raw) {
+        header.cf = (img.px == 2) ? LV_IMG_CF_TRUE_COLOR : LV_IMG_CF_TRUE_COLOR_ALPHA;
+        printf("%ux%u %s, %u bytes\n", img.w, img.h, (img.px == 2) ? "opaque" : "alpha",
+               bytes);
+        const char * const cf =
+            (img.px == 2) ? "LV_IMG_CF_TRUE_COLOR" : "LV_IMG_CF_TRUE_COLOR_ALPHA";
+        return (_write(out, &header, img.pix, bytes, cf) != 0) ? 1 : 0;
+    }
+
+    uint32_t        size = 0;
+    uint8_t * const data = _encode(&img, &size);
+    header.cf            = LV_PORT_IMG_CF;
+    printf("%ux%u %s, %u bytes decoded, %u bytes encoded (%u%%)\n", img.w, img.h,
+           (img.px == 2) ? "opaque" : "alpha", bytes, size, size * 100 / bytes);
+    if ((_write(out, &header, data, size, "LV_IMG_CF_USER_ENCODED_0") != 0) ||
+        (_verify(&img, &header, data, size, out) != 0)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * @brief 这是lfs_port的主机版本自检程序。
+ * @details 在flash_sim模拟芯片上运行与板上相同的lfs_port：格式化挂载、写入若干文件，
+ * 分别经过正常卸载（恢复分配器快照）与模拟复位（快照失效）后继续写入，
+ * 最后逐字节校验全部文件、确认文件缓存全部归还，最后打印模拟芯片的编程/擦除次数与虚拟耗时，
+ * 以及lfs_prof统计的各接口开销（耗时取自模拟芯片的虚拟时钟）。
+ * 之后在新的模拟芯片上按固定间隔写文件，分别关闭与打开w25q64_pool的预擦除，
+ * 比较每个文件写入并关闭的耗时。
+ * 编译：gcc -std=gnu11 -O2 -DLFS_PORT_HOST -Imid/littlefs -Imid/littlefs/port -Itool
+ *       tool/lfs_host.c tool/flash_sim.c mid/littlefs/port/lfs_port.c
+ *       mid/littlefs/port/lfs_prof.c
+ *       mid/littlefs/lfs.c mid/littlefs/lfs_util.c -o lfs_host
+ * @file lfs_host.c
+ * @author proyrb
+ * @date 2025/8/15
+ * @note 用法：./lfs_host [文件数] [trace]
+ */
+
+#include <lfs_port.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 模拟W25Q64：8MB，256字节页
+#define SIM_CAPACITY  (8 * 1024 * 1024)
+#define SIM_PAGE_SIZE 256
+
+// 每个文件的字节数
+#define FILE_SIZE 3000
+
+// 比较预擦除时写入的文件数与相邻两次写入的间隔
+#define POOL_FILES   64
+#define POOL_IDLE_MS 100
+
+static uint8_t _pattern(const uint32_t file, const uint32_t i) {
+    return (uint8_t)(file * 31 + i * 7 + (i >> 8));
+}
+
+static int _write_files(const uint32_t first, const uint32_t cnt) {
+    lfs_t * const fs = lfs_port_fs();
+    uint8_t       buf[FILE_SIZE];
+    char          name[16];
+
+    for (uint32_t f = first; f < first + cnt; ++f) {
+        for (uint32_t i = 0; i < FILE_SIZE; ++i) {
+            buf[i] = _pattern(f, i);
+        }
+        snprintf(name, sizeof(name), "f%u", f);
+
+        lfs_file_t file;
+        const int  flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC;
+        if (lfs_port_file_open(&file, name, flags) < 0) {
+            return -1;
+        }
+        const lfs_ssize_t n = lfs_file_write(fs, &file, buf, FILE_SIZE);
+        if ((lfs_port_file_close(&file) < 0) || (n != FILE_SIZE)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int _check_files(const uint32_t cnt) {
+    lfs_t * const fs = lfs_port_fs();
+    uint8_t       buf[FILE_SIZE];
+    char          name[16];
+
+    for (uint32_t f = 0; f < cnt; ++f) {
+        snprintf(name, sizeof(name), "f%u", f);
+
+        lfs_file_t file;
+        if (lfs_port_file_open(&file, name, LFS_O_RDONLY) < 0) {
+            return -1;
+        }
+        const lfs_ssize_t n = lfs_file_read(fs, &file, buf, FILE_SIZE);
+        if ((lfs_port_file_close(&file) < 0) || (n != FILE_SIZE)) {
+            return -1;
+        }
+        for (uint32_t i = 0; i < FILE_SIZE; ++i) {
+            if (buf[i] != _pattern(f, i)) {
+                printf("lfs_host: %s mismatch at %u\n", name, i);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 模拟按固定间隔写文件的线程，统计每个文件写入并关闭的耗时。
+ * @param pool 是否模拟w25q64_pool的预擦除。
+ * @retval 0：成功。
+ * @retval -1：失败。
+ * @warning 会重新创建lfs_port_sim。
+ * @note 两次写入之间让模拟芯片空闲POOL_IDLE_MS毫秒。
+ */
+static int _pool_bench(const uint8_t pool) {
+    flash_sim_deinit(&lfs_port_sim);
+    if (flash_sim_init(&lfs_port_sim, SIM_CAPACITY, SIM_PAGE_SIZE) != 0) {
+        return -1;
+    }
+    lfs_port_sim_pool = pool;
+    if (lfs_port_init() != 0) {
+        return -1;
+    }
+
+    uint64_t       sum    = 0;
+    uint64_t       max    = 0;
+    const uint32_t erases = lfs_port_sim.erase_cnt;
+    for (uint32_t f = 0; f < POOL_FILES; ++f) {
+        const uint64_t start = lfs_port_sim.now_ns;
+        if (_write_files(f, 1) != 0) {
+            return -1;
+        }
+        const uint64_t ns = lfs_port_sim.now_ns - start;
+        sum += ns;
+        max = (ns > max) ? ns : max;
+        lfs_port_sim_idle(POOL_IDLE_MS);
+    }
+    if ((_check_files(POOL_FILES) != 0) || (lfs_port_deinit() != 0)) {
+        return -1;
+    }
+
+    printf("lfs_host: pool %-3s %u files, write avg %u us max %u us, %u erases\n",
+           pool ? "on" : "off", POOL_FILES, (uint32_t)(sum / POOL_FILES / 1000),
+           (uint32_t)(max / 1000), lfs_port_sim.erase_cnt - erases);
+    lfs_port_sim_pool = 0;
+    return 0;
+}
+
+int main(int argc, char ** argv) {
+    const uint32_t cnt = (argc > 1) ? strtoul(argv[1], NULL, 0) : 32;
+
+    if (flash_sim_init(&lfs_port_sim, SIM_CAPACITY, SIM_PAGE_SIZE) != 0) {
+        fprintf(stderr, "lfs_host: no memory\n");
+        return 1;
+    }
+
+    int            ret  = 1;
+    const uint32_t pool = lfs_port_file_free();
+    if ((lfs_port_init() == 0) && (_write_files(0, cnt) == 0) &&
+        (lfs_port_deinit() == 0) &&
+        /* 正常卸载后重新挂载：恢复分配器快照并在此基础上继续写入 */
+        (lfs_port_init() == 0) && (_check_files(cnt) == 0) &&
+        (_write_files(cnt, cnt) == 0) &&
+        /* 不卸载直接重新挂载，模拟复位：快照已经失效，不能被恢复 */
+        (lfs_port_init() == 0) && (_check_files(2 * cnt) == 0) &&
+        (_write_files(2 * cnt, cnt) == 0) && (lfs_port_deinit() == 0) &&
+        (lfs_port_init() == 0) && (_check_files(3 * cnt) == 0) &&
+        (lfs_port_file_free() == pool)) {
+        ret = 0;
+    }
+    lfs_port_deinit();
+
+    lfs_prof_print(printf, (argc > 2) && (strcmp(argv[2], "trace") == 0));
+    printf("lfs_host: %s, %u files, %u progs, %u erases, %u ms simulated\n",
+           ret ? "FAIL" : "ok", 3 * cnt, lfs_port_sim.prog_cnt, lfs_port_sim.erase_cnt,
+           (uint32_t)(lfs_port_sim.now_ns / 1000000));
+
+    if ((_pool_bench(0) != 0) || (_pool_bench(1) != 0)) {
+        printf("lfs_host: pool bench FAIL\n");
+        ret = 1;
+    }
+
+    flash_sim_deinit(&lfs_port_sim);
+    return ret;
+}
@@ -0,0 +1,388 @@
+/**
+ * @brief 这是主机上的littlefs镜像生成与校验工具。
+ * @details 与板上使用同一份lfs.c和lfs_port.c，底层换成flash_sim模拟芯片，
+ * 因此块大小、块数、缓存大小与板上的lfs_port_init完全一致。
+ * pack把一个目录树按名字排序后写入空白芯片，卸载（同时写入分配器快照）后
+ * 输出文件系统所在的整段区域；把它烧录到打印的地址即可，板上挂载后直接可用。
+ * verify把镜像放回模拟芯片并只挂载不格式化，列出每个文件的大小与CRC-32，
+ * 给出目录时还逐字节比较两边的内容，并检查目录中的文件是否都在镜像里。
+ * 编译：gcc -std=gnu11 -O2 -DLFS_PORT_HOST -Imid/littlefs -Imid/littlefs/port -Itool
+ *       tool/lfs_image.c tool/flash_sim.c mid/littlefs/port/lfs_port.c
+ *       mid/littlefs/port/lfs_prof.c mid/littlefs/lfs.c mid/littlefs/lfs_util.c
+ *       -o lfs_image
+ * @file lfs_image.c
+ * @author proyrb
+ * @date 2025/8/16
+ * @note 用法：./lfs_image pack <目录> <镜像> [芯片容量]
+ *            ./lfs_image verify <镜像> [目录|-] [芯片容量]
+ */
+
+#include <lfs_port.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// 默认按W25Q64生成：8MB，256字节页
+#define SIM_CAPACITY  (8 * 1024 * 1024)
+#define SIM_PAGE_SIZE 256
+
+// 拷贝与比较时每次处理的字节数
+#define CHUNK_SIZE 4096
+
+// 路径的最大长度
+#define PATH_MAX_LEN 512
+
+static uint8_t host_buf[CHUNK_SIZE];
+static uint8_t lfs_buf[CHUNK_SIZE];
+
+/********** 打包 **********/
+
+/**
+ * @brief 把一个主机文件写入文件系统。
+ * @param host 主机路径。
+ * @param path 文件系统中的路径。
+ * @retval 0：成功。
+ * @retval -1：失败。
+ * @warning
+ * @note
+ */
+static int _pack_file(const char * const host, const char * const path) {
+    FILE * const in = fopen(host, "rb");
+    if (in == NULL) {
+        fprintf(stderr, "lfs_image: cannot open %s\n", host);
+        return -1;
+    }
+
+    lfs_file_t file;
+    const int  flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_EXCL;
+    int        err   = lfs_port_file_open(&file, path, flags);
+    if (err < 0) {
+        fprintf(stderr, "lfs_image: %s: create fail (%d)\n", path, err);
+        fclose(in);
+        return -1;
+    }
+
+    size_t n;
+    while ((err >= 0) && ((n = fread(host_buf, 1, sizeof(host_buf), in)) > 0)) {
+        const lfs_ssize_t res = lfs_file_write(lfs_port_fs(), &file, host_buf, n);
+        if (res != (lfs_ssize_t)n) {
+            err = (res < 0) ? res : LFS_ERR_NOSPC;
+        }
+    }
+    const int close = lfs_port_file_close(&file);
+    fclose(in);
+
+    if ((err < 0) || (close < 0)) {
+        err = (err < 0) ? err : close;
+        fprintf(stderr, "lfs_image: %s: write fail (%d)\n", path, err);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 递归打包一个目录。
+ * @param host 主机目录。
+ * @param path 文件系统中对应的目录，根目录为空串。
+ * @retval 已打包的文件数。
+ * @retval -1：失败。
+ * @warning
+ * @note 按名字排序，同样的输入总是生成同样的镜像。
+ */
+static int _pack_dir(const char * const host, const char * const path) {
+    struct dirent ** list;
+    const int        cnt = scandir(host, &list, NULL, alphasort);
+    if (cnt < 0) {
+        fprintf(stderr, "lfs_image: cannot read %s\n", host);
+        return -1;
+    }
+
+    int files = 0;
+    for (int i = 0; i < cnt; ++i) {
+        const char * const name = list[i]->d_name;
+        char               host_sub[PATH_MAX_LEN];
+        char               path_sub[PATH_MAX_LEN];
+        struct stat        st;
+
+        if ((files < 0) || (strcmp(name, ".") == 0) || (strcmp(name, "..") == 0)) {
+            continue;
+        }
+        snprintf(host_sub, sizeof(host_sub), "%s/%s", host, name);
+        snprintf(path_sub, sizeof(path_sub), "%s%s%s", path, (path[0] != '\0') ? "/" : "",
+                 name);
+
+        if (stat(host_sub, &st) != 0) {
+            files = -1;
+        } else if (S_ISDIR(st.st_mode)) {
+            const int err = lfs_mkdir(lfs_port_fs(), path_sub);
+            const int sub = (err == LFS_ERR_OK) ? _pack_dir(host_sub, path_sub) : -1;
+            if (err != LFS_ERR_OK) {
+                fprintf(stderr, "lfs_image: %s: mkdir fail (%d)\n", path_sub, err);
+            }
+            files = (sub < 0) ? -1 : files + sub;
+        } else if (S_ISREG(st.st_mode)) {
+            files = (_pack_file(host_sub, path_sub) == 0) ? files + 1 : -1;
+        }
+    }
+
+    for (int i = 0; i < cnt; ++i) {
+        free(list[i]);
+    }
+    free(list);
+    return files;
+}
+
+static int _pack(const char * const dir, const char * const image) {
+    const int files = _pack_dir(dir, "");
+    if (files < 0) {
+        return -1;
+    }
+
+    const lfs_ssize_t used = lfs_fs_size(lfs_port_fs());
+    uint32_t          base;
+    uint32_t          size;
+    lfs_port_region(&base, &size);
+    if (lfs_port_deinit() != 0) {
+        return -1;
+    }
+
+    FILE * const out = fopen(image, "wb");
+    if ((out == NULL) || (fwrite(lfs_port_sim.mem + base, 1, size, out) != size)) {
+        fprintf(stderr, "lfs_image: cannot write %s\n", image);
+        if (out != NULL) {
+            fclose(out);
+        }
+        return -1;
+    }
+    fclose(out);
+
+    printf("lfs_image: %d files, %d of %u blocks used, flash %u bytes at 0x%X\n", files,
+           (int)used, lfs_port_cfg()->block_count, size, base);
+    return 0;
+}
+
+/********** 校验 **********/
+
+static uint32_t mismatch = 0;  // 内容不一致或缺失的文件数
+
+/**
+ * @brief 计算镜像中一个文件的CRC-32，可选地与主机文件比较。
+ * @param path 文件系统中的路径。
+ * @param host 主机路径，NULL表示不比较。
+ * @param size 文件大小。
+ * @retval 0：成功。
+ * @retval -1：读取失败。
+ * @warning
+ * @note CRC-32与zlib相同（littlefs的CRC再取反）。
+ */
+static int _verify_file(const char * const path, const char * const host, uint32_t size) {
+    lfs_file_t file;
+    if (lfs_port_file_open(&file, path, LFS_O_RDONLY) < 0) {
+        return -1;
+    }
+    FILE * const in = (host != NULL) ? fopen(host, "rb") : NULL;
+
+    uint32_t crc  = 0xFFFFFFFF;
+    uint8_t  same = (host == NULL) || (in != NULL);
+    uint32_t left = size;
+    int      err  = 0;
+    while ((err == 0) && (left > 0)) {
+        const uint32_t    n   = (left < CHUNK_SIZE) ? left : CHUNK_SIZE;
+        const lfs_ssize_t res = lfs_file_read(lfs_port_fs(), &file, lfs_buf, n);
+        if (res != (lfs_ssize_t)n) {
+            err = -1;
+            break;
+        }
+        crc = lfs_crc(crc, lfs_buf, n);
+        if (same && (in != NULL)) {
+            same = (fread(host_buf, 1, n, in) == n);
+            same = same && (memcmp(host_buf, lfs_buf, n) == 0);
+        }
+        left -= n;
+    }
+    if (same && (in != NULL)) {
+        same = (fgetc(in) == EOF);
+    }
+    if (in != NULL) {
+        fclose(in);
+    }
+    if ((lfs_port_file_close(&file) < 0) || (err != 0)) {
+        return -1;
+    }
+
+    printf("%10u %08X %s%s\n", size, crc ^ 0xFFFFFFFF, path, same ? "" : "  MISMATCH");
+    mismatch += !same;
+    return 0;
+}
+
+/**
+ * @brief 递归校验镜像中的一个目录。
+ * @param path 文件系统中的目录，根目录为"/"。
+ * @param host 对应的主机目录，NULL表示不比较。
+ * @retval 文件数。
+ * @retval -1：读取失败。
+ * @warning
+ * @note
+ */
+static int _verify_dir(const char * const path, const char * const host) {
+    lfs_dir_t dir;
+    if (lfs_dir_open(lfs_port_fs(), &dir, path) < 0) {
+        return -1;
+    }
+
+    /* 目录句柄不能跨越递归保持打开，先把名字收集起来 */
+    struct lfs_info   info;
+    struct lfs_info * list = NULL;
+    uint32_t          cnt  = 0;
+    int               res;
+    while ((res = lfs_dir_read(lfs_port_fs(), &dir, &info)) > 0) {
+        if ((strcmp(info.name, ".") == 0) || (strcmp(info.name, "..") == 0)) {
+            continue;
+        }
+        struct lfs_info * const grow = realloc(list, (cnt + 1) * sizeof(info));
+        if (grow == NULL) {
+            res = -1;
+            break;
+        }
+        list        = grow;
+        list[cnt++] = info;
+    }
+    lfs_dir_close(lfs_port_fs(), &dir);
+
+    int files = (res < 0) ? -1 : 0;
+    for (uint32_t i = 0; (files >= 0) && (i < cnt); ++i) {
+        char path_sub[PATH_MAX_LEN];
+        char host_sub[PATH_MAX_LEN];
+        snprintf(path_sub, sizeof(path_sub), "%s%s%s", path,
+                 (strcmp(path, "/") == 0) ? "" : "/", list[i].name);
+        if (host != NULL) {
+            snprintf(host_sub, sizeof(host_sub), "%s/%s", host, list[i].name);
+        }
+
+        if (list[i].type == LFS_TYPE_DIR) {
+            const int sub = _verify_dir(path_sub, (host != NULL) ? host_sub : NULL);
+            files         = (sub < 0) ? -1 : files + sub;
+        } else if (_verify_file(path_sub, (host != NULL) ? host_sub : NULL,
+                                list[i].size) == 0) {
+            ++files;
+        } else {
+            files = -1;
+        }
+    }
+    free(list);
+    return files;
+}
+
+/**
+ * @brief 检查主机目录中的每个文件与子目录都存在于镜像中。
+ * @param host 主机目录。
+ * @param path 文件系统中对应的目录，根目录为空串。
+ * @retval
+ * @warning
+ * @note 缺失的项计入mismatch。
+ */
+static void _verify_missing(const char * const host, const char * const path) {
+    struct dirent ** list;
+    const int        cnt = scandir(host, &list, NULL, alphasort);
+    if (cnt < 0) {
+        ++mismatch;
+        return;
+    }
+
+    for (int i = 0; i < cnt; ++i) {
+        const char * const name = list[i]->d_name;
+        char               host_sub[PATH_MAX_LEN];
+        char               path_sub[PATH_MAX_LEN];
+        struct stat        st;
+        struct lfs_info    info;
+
+        if ((strcmp(name, ".") != 0) && (strcmp(name, "..") != 0)) {
+            snprintf(host_sub, sizeof(host_sub), "%s/%s", host, name);
+            snprintf(path_sub, sizeof(path_sub), "%s/%s", path, name);
+            const uint8_t want = (stat(host_sub, &st) == 0) &&
+                                 (S_ISDIR(st.st_mode) || S_ISREG(st.st_mode));
+            if (want) {
+                if (lfs_stat(lfs_port_fs(), path_sub, &info) < 0) {
+                    printf("%10s %8s %s  MISSING\n", "-", "-", path_sub);
+                    ++mismatch;
+                } else if (S_ISDIR(st.st_mode)) {
+                    _verify_missing(host_sub, path_sub);
+                }
+            }
+        }
+        free(list[i]);
+    }
+    free(list);
+}
+
+static int _verify(const char * const image, const char * const dir) {
+    uint32_t base;
+    uint32_t size;
+    lfs_port_region(&base, &size);
+
+    /* 镜像放回模拟芯片后重新挂载，挂载失败说明镜像损坏，不能格式化 */
+    FILE * const in = fopen(image, "rb");
+    if (in == NULL) {
+        fprintf(stderr, "lfs_image: cannot open %s\n", image);
+        return -1;
+    }
+    const size_t n    = fread(lfs_port_sim.mem + base, 1, size, in);
+    const int    more = fgetc(in);
+    fclose(in);
+    if ((n != size) || (more != EOF)) {
+        fprintf(stderr, "lfs_image: %s is not %u bytes\n", image, size);
+        return -1;
+    }
+
+    lfs_port_no_format = 1;
+    if (lfs_port_init() != 0) {
+        return -1;
+    }
+
+    const int files = _verify_dir("/", dir);
+    if ((files >= 0) && (dir != NULL)) {
+        _verify_missing(dir, "");
+    }
+    printf("lfs_image: %d files, %u mismatched, %d of %u blocks used\n", files, mismatch,
+           (int)lfs_fs_size(lfs_port_fs()), lfs_port_cfg()->block_count);
+    return ((files < 0) || (mismatch > 0)) ? -1 : 0;
+}
+
+/********** 入口 **********/
+
+int main(int argc, char ** argv) {
+    const uint8_t pack   = (argc >= 4) && (strcmp(argv[1], "pack") == 0);
+    const uint8_t verify = (argc >= 3) && (strcmp(argv[1], "verify") == 0);
+    if (!pack && !verify) {
+        fprintf(stderr, "usage: %s pack <dir> <image> [capacity]\n"
+                        "       %s verify <image> [dir|-] [capacity]\n",
+                argv[0], argv[0]);
+        return 2;
+    }
+
+    const uint32_t capacity = (argc > 4) ? strtoul(argv[4], NULL, 0) : SIM_CAPACITY;
+    if (flash_sim_init(&lfs_port_sim, capacity, SIM_PAGE_SIZE) != 0) {
+        fprintf(stderr, "lfs_image: no memory\n");
+        return 1;
+    }
+
+    /* 先在空白芯片上格式化挂载，得到与板上相同的配置与区域 */
+    int ret = (lfs_port_init() == 0) ? 0 : -1;
+    if (ret == 0) {
+        if (pack) {
+            ret = _pack(argv[2], argv[3]);
+        } else if (lfs_port_deinit() == 0) {
+            memset(lfs_port_sim.mem, 0xFF, lfs_port_sim.capacity);
+            const uint8_t dir = (argc > 3) && (strcmp(argv[3], "-") != 0);
+            ret               = _verify(argv[2], dir ? argv[3] : NULL);
+        } else {
+            ret = -1;
+        }
+    }
+    lfs_port_deinit();
+
+    flash_sim_deinit(&lfs_port_sim);
+    return (ret == 0) ? 0 : 1;
+}
@@ -0,0 +1,623 @@
+/**
+ * @brief 这是lfs_port的掉电测试程序。
+ * @details 在flash_sim模拟芯片上运行与板上相同的lfs_port，反复执行同一段固定种子的负载：
+ * 追加日志记录并在写满后轮转（删除旧文件、改名），用临时文件加改名的方式更新配置，
+ * 原地重写状态文件，创建与删除带数据文件的目录（会留下需要deorphan的孤儿）。
+ * 先完整运行一遍负载得到编程/擦除的总次数，然后依次在第1、1+stride……次操作时掉电，
+ * 掉电的那次操作只完成随机的前若干字节，之后芯片一直没电。
+ * 每次掉电后重新上电：只挂载不格式化，再调用lfs_fs_mkconsistent完成deorphan等修复，
+ * 按虚拟时钟分别记录两者的耗时，然后检查：
+ * 配置与状态文件完整且版本是最后一次提交或正在进行的那一次；
+ * 日志记录连续、校验正确，最后一条是最后一次提交或正在进行的那一次；
+ * 已提交的目录都在且数据完整；遍历整个文件系统没有错误。
+ * 之后继续执行一段负载，正常卸载再挂载后重新检查一遍。
+ * 最后打印失败的掉电点、恢复耗时的统计与最慢的几次恢复。
+ * 编译：gcc -std=gnu11 -O2 -DLFS_PORT_HOST -DLFS_PORT_QUIET -DLFS_NO_DEBUG -DLFS_NO_WARN
+ *       -DLFS_NO_ERROR -Imid/littlefs -Imid/littlefs/port -Itool
+ *       tool/lfs_powerloss.c tool/flash_sim.c mid/littlefs/port/lfs_port.c
+ *       mid/littlefs/port/lfs_prof.c mid/littlefs/lfs.c mid/littlefs/lfs_util.c
+ *       -o lfs_powerloss
+ * @file lfs_powerloss.c
+ * @author proyrb
+ * @date 2025/8/17
+ * @note 用法：./lfs_powerloss [负载步数] [stride] [种子]
+ */
+
+#include <lfs_port.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 模拟W25Q64：8MB，256字节页
+#define SIM_CAPACITY  (8 * 1024 * 1024)
+#define SIM_PAGE_SIZE 256
+
+// 日志记录与配置/状态记录的字节数
+#define LOG_REC_SIZE 32
+#define CFG_REC_SIZE 200
+
+// 日志文件达到该字节数后轮转
+#define LOG_MAX (2 * 1024)
+
+// 同时保留的目录数与每个目录中数据文件的字节数
+#define SPOOL_KEEP 4
+#define SPOOL_SIZE 300
+
+// 掉电恢复后继续执行的负载步数
+#define RESUME_STEPS 16
+
+// 打印最慢的恢复次数
+#define SLOW_CNT 5
+
+#define REC_MAGIC 0x4C474F4C
+
+/********** 负载 **********/
+
+typedef enum {
+    OpNone = 0,
+    OpAppend,
+    OpRotate,
+    OpCfg,
+    OpState,
+    OpSpoolAdd,
+    OpSpoolDel,
+} op_kind;
+
+static const char * const op_name[] = {"-",     "append", "rotate",    "cfg",
+                                       "state", "mkdir",  "rmdir"};
+
+/* 已经提交的状态：与文件系统中的内容对照 */
+typedef struct {
+    uint32_t log_last;     // 最后一条日志记录的序号，0表示还没有
+    uint32_t cur_first;    // /log/cur第一条记录的序号
+    uint32_t cfg_ver;      // /cfg的版本
+    uint32_t state_ver;    // /state的版本
+    uint32_t spool_first;  // 最早的目录编号
+    uint32_t spool_next;   // 下一个目录编号
+    uint32_t rand;         // 负载的随机数状态
+} model;
+
+static model   mdl;
+static op_kind pending = OpNone;  // 正在进行、可能没有完成的操作
+static uint8_t buf[CFG_REC_SIZE > SPOOL_SIZE ? CFG_REC_SIZE : SPOOL_SIZE];
+static uint8_t log_buf[2 * LOG_MAX];
+
+static uint32_t _rand(uint32_t * const x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+/**
+ * @brief 生成一条记录：开头两个字是magic与序号，中间是由序号决定的内容，最后一个字是CRC。
+ * @param rec 记录。
+ * @param size 字节数：4的整数倍。
+ * @param seq 序号或版本。
+ * @retval
+ * @warning
+ * @note
+ */
+static void _rec_make(uint8_t * const rec, const uint32_t size, const uint32_t seq) {
+    uint32_t * const w = (uint32_t *)rec;
+    w[0]               = REC_MAGIC;
+    w[1]               = seq;
+    for (uint32_t i = 2; i < size / 4 - 1; ++i) {
+        w[i] = seq * 2654435761u + i;
+    }
+    w[size / 4 - 1] = lfs_crc(0xFFFFFFFF, rec, size - 4);
+}
+
+/**
+ * @brief 检查记录。
+ * @param rec 记录。
+ * @param size 字节数。
+ * @retval 序号：记录完整。
+ * @retval 0：记录损坏。
+ * @warning
+ * @note 序号从1开始。
+ */
+static uint32_t _rec_check(const uint8_t * const rec, const uint32_t size) {
+    const uint32_t * const w = (const uint32_t *)rec;
+    if ((w[0] != REC_MAGIC) || (w[size / 4 - 1] != lfs_crc(0xFFFFFFFF, rec, size - 4))) {
+        return 0;
+    }
+    return w[1];
+}
+
+/**
+ * @brief 写入整个文件并关闭。
+ * @param path 路径。
+ * @param flags 打开方式。
+ * @param data 数据。
+ * @param size 字节数。
+ * @retval 0：成功。
+ * @retval <0：littlefs错误码。
+ * @warning
+ * @note 关闭成功才算提交。
+ */
+static int _write(const char * const path, const int flags, const void * const data,
+                  const uint32_t size) {
+    lfs_file_t file;
+    int        err = lfs_port_file_open(&file, path, flags);
+    if (err < 0) {
+        return err;
+    }
+    const lfs_ssize_t n     = lfs_file_write(lfs_port_fs(), &file, data, size);
+    const int         close = lfs_port_file_close(&file);
+    if (n < 0) {
+        return (int)n;
+    }
+    return (n != (lfs_ssize_t)size) ? LFS_ERR_NOSPC : close;
+}
+
+/**
+ * @brief 读出整个文件。
+ * @param path 路径。
+ * @param data 接收缓冲区。
+ * @param size 缓冲区字节数。
+ * @retval >=0：文件字节数。
+ * @retval <0：littlefs错误码。
+ * @warning
+ * @note
+ */
+static lfs_ssize_t _read(const char * const path, void * const data,
+                         const uint32_t size) {
+    lfs_file_t file;
+    int        err = lfs_port_file_open(&file, path, LFS_O_RDONLY);
+    if (err < 0) {
+        return err;
+    }
+    const lfs_ssize_t n     = lfs_file_read(lfs_port_fs(), &file, data, size);
+    const int         close = lfs_port_file_close(&file);
+    return (n < 0) ? n : ((close < 0) ? close : n);
+}
+
+static int _op_append(void) {
+    lfs_file_t file;
+    int        err = lfs_port_file_open(&file, "/log/cur", LFS_O_RDONLY);
+    if (err == LFS_ERR_OK) {
+        const lfs_soff_t size = lfs_file_size(lfs_port_fs(), &file);
+        lfs_port_file_close(&file);
+        if (size >= LOG_MAX) {
+            /* 轮转：先删除旧文件再改名，两步之间掉电时只剩/log/cur */
+            pending = OpRotate;
+            err     = lfs_remove(lfs_port_fs(), "/log/old");
+            if ((err != LFS_ERR_OK) && (err != LFS_ERR_NOENT)) {
+                return err;
+            }
+            err = lfs_rename(lfs_port_fs(), "/log/cur", "/log/old");
+            if (err != LFS_ERR_OK) {
+                return err;
+            }
+            mdl.cur_first = mdl.log_last + 1;
+        }
+    }
+
+    pending = OpAppend;
+    _rec_make(buf, LOG_REC_SIZE, mdl.log_last + 1);
+    const int flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND;
+    err             = _write("/log/cur", flags, buf, LOG_REC_SIZE);
+    if (err == LFS_ERR_OK) {
+        ++mdl.log_last;
+    }
+    return err;
+}
+
+static int _op_cfg(void) {
+    pending = OpCfg;
+    _rec_make(buf, CFG_REC_SIZE, mdl.cfg_ver + 1);
+    int err = _write("/cfg.tmp", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC, buf,
+                     CFG_REC_SIZE);
+    if (err == LFS_ERR_OK) {
+        err = lfs_rename(lfs_port_fs(), "/cfg.tmp", "/cfg");
+    }
+    if (err == LFS_ERR_OK) {
+        ++mdl.cfg_ver;
+    }
+    return err;
+}
+
+static int _op_state(void) {
+    pending = OpState;
+    _rec_make(buf, CFG_REC_SIZE, mdl.state_ver + 1);
+    const int err = _write("/state", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC, buf,
+                           CFG_REC_SIZE);
+    if (err == LFS_ERR_OK) {
+        ++mdl.state_ver;
+    }
+    return err;
+}
+
+static int _op_spool(void) {
+    char path[32];
+    int  err;
+
+    if (mdl.spool_next - mdl.spool_first < SPOOL_KEEP) {
+        pending = OpSpoolAdd;
+        snprintf(path, sizeof(path), "/spool/%u", mdl.spool_next);
+        err = lfs_mkdir(lfs_port_fs(), path);
+        if (err == LFS_ERR_OK) {
+            snprintf(path, sizeof(path), "/spool/%u/data", mdl.spool_next);
+            _rec_make(buf, SPOOL_SIZE, mdl.spool_next + 1);
+            err = _write(path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_EXCL, buf, SPOOL_SIZE);
+        }
+        if (err == LFS_ERR_OK) {
+            ++mdl.spool_next;
+        }
+    } else {
+        pending = OpSpoolDel;
+        snprintf(path, sizeof(path), "/spool/%u/data", mdl.spool_first);
+        err = lfs_remove(lfs_port_fs(), path);
+        if (err == LFS_ERR_OK) {
+            snprintf(path, sizeof(path), "/spool/%u", mdl.spool_first);
+            err = lfs_remove(lfs_port_fs(), path);
+        }
+        if (err == LFS_ERR_OK) {
+            ++mdl.spool_first;
+        }
+    }
+    return err;
+}
+
+/**
+ * @brief 执行一步负载。
+ * @param
+ * @retval 0：成功。
+ * @retval <0：littlefs错误码。
+ * @warning
+ * @note 日志追加最频繁，其次是配置、状态与目录。
+ */
+static int _step(void) {
+    const uint32_t r = _rand(&mdl.rand) % 20;
+    int            err;
+    if (r < 12) {
+        err = _op_append();
+    } else if (r < 15) {
+        err = _op_cfg();
+    } else if (r < 18) {
+        err = _op_state();
+    } else {
+        err = _op_spool();
+    }
+    if (err == LFS_ERR_OK) {
+        pending = OpNone;
+    }
+    return err;
+}
+
+/**
+ * @brief 格式化并建立初始内容。
+ * @param seed 负载的随机数种子。
+ * @retval 0：成功。
+ * @warning
+ * @note
+ */
+static int _setup(const uint32_t seed) {
+    memset(lfs_port_sim.mem, 0xFF, lfs_port_sim.capacity);
+    lfs_port_sim.prog_cnt  = 0;
+    lfs_port_sim.erase_cnt = 0;
+    lfs_port_sim.fail_at   = 0;
+
+    memset(&mdl, 0, sizeof(mdl));
+    mdl.cur_first = 1;
+    mdl.rand      = seed;
+    pending       = OpNone;
+
+    lfs_port_no_format = 0;
+    if (lfs_port_init() != 0) {
+        return -1;
+    }
+    int err = lfs_mkdir(lfs_port_fs(), "/log");
+    err     = err ? err : lfs_mkdir(lfs_port_fs(), "/spool");
+    err     = err ? err : _op_cfg();
+    err     = err ? err : _op_state();
+    pending = OpNone;
+    return err;
+}
+
+/********** 检查 **********/
+
+static const char * fail_why = NULL;  // 第一个不满足的条件
+
+static int _fail(const char * const why) {
+    fail_why = (fail_why == NULL) ? why : fail_why;
+    return -1;
+}
+
+/**
+ * @brief 检查配置或状态文件，并把模型同步为实际版本。
+ * @param path 路径。
+ * @param ver 模型中的版本。
+ * @param may_next 掉电时正在更新它。
+ * @retval 0：满足约束。
+ * @warning
+ * @note
+ */
+static int _check_rec(const char * const path, uint32_t * const ver,
+                      const uint8_t may_next) {
+    if (_read(path, buf, sizeof(buf)) != CFG_REC_SIZE) {
+        return _fail("cfg/state missing");
+    }
+    const uint32_t got = _rec_check(buf, CFG_REC_SIZE);
+    if ((got != *ver) && !(may_next && (got == *ver + 1))) {
+        return _fail("cfg/state version");
+    }
+    *ver = got;
+    return 0;
+}
+
+/**
+ * @brief 检查日志：/log/old与/log/cur首尾相接，记录连续且完整。
+ * @param
+ * @retval 0：满足约束。
+ * @warning
+ * @note 同时把模型同步为实际的最后序号与/log/cur的第一条序号。
+ */
+static int _check_log(void) {
+    const lfs_ssize_t old = _read("/log/old", log_buf, sizeof(log_buf));
+    if ((old < 0) && (old != LFS_ERR_NOENT)) {
+        return _fail("log/old read");
+    }
+    const uint32_t    old_len = (old < 0) ? 0 : (uint32_t)old;
+    const lfs_ssize_t cur     = _read("/log/cur", log_buf + old_len, LOG_MAX);
+    if ((cur < 0) && (cur != LFS_ERR_NOENT)) {
+        return _fail("log/cur read");
+    }
+    const uint32_t cur_len = (cur < 0) ? 0 : (uint32_t)cur;
+    const uint32_t len     = old_len + cur_len;
+    if ((len % LOG_REC_SIZE != 0) || (old_len > LOG_MAX) || (cur_len > LOG_MAX)) {
+        return _fail("log size");
+    }
+
+    uint32_t first = 0;
+    uint32_t last  = 0;
+    for (uint32_t off = 0; off < len; off += LOG_REC_SIZE) {
+        const uint32_t seq = _rec_check(log_buf + off, LOG_REC_SIZE);
+        if ((seq == 0) || ((last != 0) && (seq != last + 1))) {
+            return _fail("log record");
+        }
+        first = (first == 0) ? seq : first;
+        last  = seq;
+    }
+
+    const uint8_t may_next = (pending == OpAppend);
+    if ((last != mdl.log_last) && !(may_next && (last == mdl.log_last + 1))) {
+        return _fail("log last");
+    }
+    if ((mdl.cur_first <= mdl.log_last) && ((first == 0) || (first > mdl.cur_first))) {
+        return _fail("log lost");
+    }
+    mdl.log_last  = last;
+    mdl.cur_first = last + 1;
+    if (cur_len > 0) {
+        mdl.cur_first = _rec_check(log_buf + old_len, LOG_REC_SIZE);
+    }
+    return 0;
+}
+
+/**
+ * @brief 检查已提交的目录，并清理掉电时正在创建或删除的目录。
+ * @param
+ * @retval 0：满足约束。
+ * @warning
+ * @note 清理相当于应用在上电时做的恢复。
+ */
+static int _check_spool(void) {
+    char path[32];
+    for (uint32_t id = mdl.spool_first; id < mdl.spool_next; ++id) {
+        if ((pending == OpSpoolDel) && (id == mdl.spool_first)) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "/spool/%u/data", id);
+        if ((_read(path, buf, sizeof(buf)) != SPOOL_SIZE) ||
+            (_rec_check(buf, SPOOL_SIZE) != id + 1)) {
+            return _fail("spool data");
+        }
+    }
+
+    uint32_t id = 0;
+    if (pending == OpSpoolAdd) {
+        id = mdl.spool_next;
+    } else if (pending == OpSpoolDel) {
+        id = mdl.spool_first++;
+    } else {
+        return 0;
+    }
+    snprintf(path, sizeof(path), "/spool/%u/data", id);
+    const int err = lfs_remove(lfs_port_fs(), path);
+    snprintf(path, sizeof(path), "/spool/%u", id);
+    const int err2 = lfs_remove(lfs_port_fs(), path);
+    if (((err != LFS_ERR_OK) && (err != LFS_ERR_NOENT)) ||
+        ((err2 != LFS_ERR_OK) && (err2 != LFS_ERR_NOENT))) {
+        return _fail("spool cleanup");
+    }
+    return 0;
+}
+
+static int _check(void) {
+    if ((_check_rec("/cfg", &mdl.cfg_ver, pending == OpCfg) != 0) ||
+        (_check_rec("/state", &mdl.state_ver, pending == OpState) != 0) ||
+        (_check_log() != 0) || (_check_spool() != 0)) {
+        return -1;
+    }
+    const int err = lfs_remove(lfs_port_fs(), "/cfg.tmp");
+    if ((err != LFS_ERR_OK) && (err != LFS_ERR_NOENT)) {
+        return _fail("cfg.tmp cleanup");
+    }
+    if (lfs_fs_size(lfs_port_fs()) < 0) {
+        return _fail("traverse");
+    }
+    pending = OpNone;
+    return 0;
+}
+
+/********** 掉电测试 **********/
+
+typedef struct {
+    uint32_t fail_at;     // 掉电点
+    uint32_t keep;        // 掉电的那次操作完成的字节数（取模前）
+    op_kind  op;          // 掉电时正在进行的操作
+    uint32_t mount_us;    // 挂载耗时
+    uint32_t consist_us;  // lfs_fs_mkconsistent耗时
+} recovery;
+
+static uint32_t _sim_us(void) {
+    return (uint32_t)(lfs_port_sim.now_ns / 1000);
+}
+
+/**
+ * @brief 执行一次掉电与恢复。
+ * @param seed 种子。
+ * @param steps 负载步数。
+ * @param rec 输入掉电点，输出恢复耗时。
+ * @retval 1：负载结束前没有到达掉电点。
+ * @retval 0：恢复后全部检查通过。
+ * @retval -1：检查失败，原因在fail_why。
+ * @warning
+ * @note
+ */
+static int _run(const uint32_t seed, const uint32_t steps, recovery * const rec) {
+    fail_why = NULL;
+    if (_setup(seed) != 0) {
+        return _fail("setup");
+    }
+    const uint32_t base    = lfs_port_sim.prog_cnt + lfs_port_sim.erase_cnt;
+    lfs_port_sim.fail_at   = base + rec->fail_at;
+    lfs_port_sim.fail_keep = rec->keep;
+
+    uint32_t i = 0;
+    for (; i < steps; ++i) {
+        const int err = _step();
+        if (lfs_port_sim.prog_cnt + lfs_port_sim.erase_cnt >= lfs_port_sim.fail_at) {
+            break;
+        }
+        if (err != LFS_ERR_OK) {
+            return _fail("error without power loss");
+        }
+    }
+    if (i == steps) {
+        return 1;
+    }
+    rec->op = pending;
+
+    /* 重新上电：不卸载直接挂载，与板上复位相同 */
+    lfs_port_sim.fail_at = 0;
+    lfs_port_no_format   = 1;
+    uint32_t start       = _sim_us();
+    if (lfs_port_init() != 0) {
+        return _fail("mount");
+    }
+    rec->mount_us = _sim_us() - start;
+    start         = _sim_us();
+    if (lfs_fs_mkconsistent(lfs_port_fs()) != 0) {
+        return _fail("mkconsistent");
+    }
+    rec->consist_us = _sim_us() - start;
+
+    if (_check() != 0) {
+        return -1;
+    }
+
+    /* 恢复后继续写入，再正常卸载挂载，确认文件系统仍然可用 */
+    for (uint32_t n = 0; n < RESUME_STEPS; ++n) {
+        if (_step() != LFS_ERR_OK) {
+            return _fail("resume");
+        }
+    }
+    if ((lfs_port_deinit() != 0) || (lfs_port_init() != 0)) {
+        return _fail("remount");
+    }
+    return _check();
+}
+
+int main(int argc, char ** argv) {
+    const uint32_t steps  = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200;
+    const uint32_t stride = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+    const uint32_t seed   = (argc > 3) ? strtoul(argv[3], NULL, 0) : 0x1234567;
+
+    if ((stride == 0) || (seed == 0) ||
+        (flash_sim_init(&lfs_port_sim, SIM_CAPACITY, SIM_PAGE_SIZE) != 0)) {
+        fprintf(stderr, "usage: %s [steps] [stride] [seed]\n", argv[0]);
+        return 2;
+    }
+
+    /* 不掉电完整运行一遍，得到负载的编程/擦除总次数 */
+    if (_setup(seed) != 0) {
+        fprintf(stderr, "lfs_powerloss: setup fail\n");
+        return 1;
+    }
+    const uint32_t base = lfs_port_sim.prog_cnt + lfs_port_sim.erase_cnt;
+    for (uint32_t i = 0; i < steps; ++i) {
+        if (_step() != LFS_ERR_OK) {
+            fprintf(stderr, "lfs_powerloss: workload fail at step %u\n", i);
+            return 1;
+        }
+    }
+    const uint32_t total = lfs_port_sim.prog_cnt + lfs_port_sim.erase_cnt - base;
+    if (_check() != 0) {
+        fprintf(stderr, "lfs_powerloss: workload check fail: %s\n", fail_why);
+        return 1;
+    }
+    printf("lfs_powerloss: %u steps, %u progs/erases, cut every %u\n", steps, total,
+           stride);
+
+    recovery slow[SLOW_CNT];
+    uint64_t mount_sum   = 0;
+    uint64_t consist_sum = 0;
+    uint32_t mount_max   = 0;
+    uint32_t consist_max = 0;
+    uint32_t runs        = 0;
+    uint32_t fails       = 0;
+    uint32_t keep_rand   = seed ^ 0x9E3779B9;
+    memset(slow, 0, sizeof(slow));
+
+    for (uint32_t at = 1; at <= total; at += stride) {
+        recovery  rec = {.fail_at = at, .keep = _rand(&keep_rand)};
+        const int ret = _run(seed, steps, &rec);
+        if (ret > 0) {
+            continue;
+        }
+        ++runs;
+        if (ret < 0) {
+            ++fails;
+            printf("FAIL  cut %u keep %u during %s: %s\n", at, rec.keep, op_name[rec.op],
+                   fail_why);
+            continue;
+        }
+
+        mount_sum += rec.mount_us;
+        consist_sum += rec.consist_us;
+        mount_max   = (rec.mount_us > mount_max) ? rec.mount_us : mount_max;
+        consist_max = (rec.consist_us > consist_max) ? rec.consist_us : consist_max;
+
+        /* 按恢复总耗时保留最慢的几次 */
+        const uint32_t cost = rec.mount_us + rec.consist_us;
+        for (uint32_t s = 0; s < SLOW_CNT; ++s) {
+            if (cost > slow[s].mount_us + slow[s].consist_us) {
+                memmove(&slow[s + 1], &slow[s], (SLOW_CNT - 1 - s) * sizeof(slow[0]));
+                slow[s] = rec;
+                break;
+            }
+        }
+    }
+
+    const uint32_t ok = runs - fails;
+    printf("lfs_powerloss: %u cuts, %u failed\n", runs, fails);
+    if (ok > 0) {
+        printf("mount         avg %8u us  max %8u us\n", (uint32_t)(mount_sum / ok),
+               mount_max);
+        printf("mkconsistent  avg %8u us  max %8u us\n", (uint32_t)(consist_sum / ok),
+               consist_max);
+        printf("slowest recoveries:\n");
+        for (uint32_t s = 0; (s < SLOW_CNT) && (slow[s].fail_at != 0); ++s) {
+            printf("  cut %6u during %-7s mount %8u us  mkconsistent %8u us\n",
+                   slow[s].fail_at, op_name[slow[s].op], slow[s].mount_us,
+                   slow[s].consist_us);
+        }
+    }
+
+    lfs_port_deinit();
+    flash_sim_deinit(&lfs_port_sim);
+    return (fails == 0) ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+/**
+ * @brief 这是lfs_ring的主机版本自检与对比程序。
+ * @details 在flash_sim模拟芯片上比较两种写日志的方式：
+ * 逐条打开、追加、关闭一个普通文件；用lfs_ring追加并每隔若干条提交一次。
+ * 分别打印编程次数、擦除次数与虚拟耗时；
+ * 然后从最新的记录向前遍历，确认序号连续递减；
+ * 接着追加几条不提交的记录后模拟复位，确认重新打开后最新的记录是最后一次提交的那一条；
+ * 最后让切换段失败，确认排除故障后继续追加，记录仍然连续。
+ * 编译：gcc -std=gnu11 -O2 -DLFS_PORT_HOST -DLFS_PORT_QUIET -DLFS_NO_ERROR
+ *       -Imid/littlefs -Imid/littlefs/port -Itool tool/lfs_ring_host.c tool/flash_sim.c
+ *       mid/littlefs/port/lfs_port.c mid/littlefs/port/lfs_prof.c
+ *       mid/littlefs/port/lfs_ring.c mid/littlefs/lfs.c mid/littlefs/lfs_util.c
+ *       -o lfs_ring_host
+ * @file lfs_ring_host.c
+ * @author proyrb
+ * @date 2025/8/18
+ * @note 用法：./lfs_ring_host [记录数] [每次提交的记录数]
+ */
+
+#include <lfs_ring.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 模拟W25Q64：8MB，256字节页
+#define SIM_CAPACITY  (8 * 1024 * 1024)
+#define SIM_PAGE_SIZE 256
+
+// 每条记录的字节数：与实际的遥测数据相近
+#define REC_SIZE 24
+
+typedef struct {
+    uint32_t progs;
+    uint32_t erases;
+    uint64_t ns;
+} cost;
+
+static void _cost_begin(cost * const c) {
+    c->progs  = lfs_port_sim.prog_cnt;
+    c->erases = lfs_port_sim.erase_cnt;
+    c->ns     = lfs_port_sim.now_ns;
+}
+
+static void _cost_print(const char * const name, const cost * const c,
+                        const uint32_t cnt) {
+    const uint32_t progs = lfs_port_sim.prog_cnt - c->progs;
+    const uint64_t us    = (lfs_port_sim.now_ns - c->ns) / 1000;
+    printf("%-14s %6u progs %5u erases %8u ms  %6u us/record\n", name, progs,
+           lfs_port_sim.erase_cnt - c->erases, (uint32_t)(us / 1000),
+           (uint32_t)(us / cnt));
+}
+
+static void _rec_make(uint8_t * const rec, const uint32_t seq) {
+    memset(rec, (uint8_t)seq, REC_SIZE);
+    memcpy(rec, &seq, sizeof(seq));
+}
+
+/**
+ * @brief 格式化后重新挂载，使两种方式从同样的状态开始。
+ * @param
+ * @retval 0：成功。
+ * @warning
+ * @note
+ */
+static int _fresh(void) {
+    memset(lfs_port_sim.mem, 0xFF, lfs_port_sim.capacity);
+    return lfs_port_init();
+}
+
+static int _naive(const uint32_t cnt) {
+    uint8_t rec[REC_SIZE];
+    for (uint32_t i = 0; i < cnt; ++i) {
+        lfs_file_t file;
+        _rec_make(rec, i);
+        const int flags = LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND;
+        if ((lfs_port_file_open(&file, "/naive.log", flags) < 0) ||
+            (lfs_file_write(lfs_port_fs(), &file, rec, REC_SIZE) != REC_SIZE) ||
+            (lfs_port_file_close(&file) < 0)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int _ring(lfs_ring * const ring, const uint32_t first, const uint32_t cnt,
+                 const uint32_t batch) {
+    uint8_t rec[REC_SIZE];
+    for (uint32_t i = first; i < first + cnt; ++i) {
+        _rec_make(rec, i);
+        if (lfs_ring_append(ring, rec, REC_SIZE) != 0) {
+            return -1;
+        }
+        if ((batch > 0) && ((i + 1) % batch == 0) && (lfs_ring_commit(ring) != 0)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 从最新的记录向前遍历。
+ * @param ring 句柄。
+ * @param newest 期望的最新序号。
+ * @retval 遍历到的记录数。
+ * @retval -1：序号不连续或记录损坏。
+ * @warning
+ * @note
+ */
+static int _walk(lfs_ring * const ring, const uint32_t newest) {
+    lfs_ring_iter it;
+    uint8_t       rec[REC_SIZE];
+    uint32_t      expect = newest;
+    int           cnt    = 0;
+    int           len;
+
+    lfs_ring_iter_init(ring, &it);
+    while ((len = lfs_ring_iter_prev(&it, rec, sizeof(rec))) > 0) {
+        uint32_t seq;
+        memcpy(&seq, rec, sizeof(seq));
+        if ((len != REC_SIZE) || (seq != expect)) {
+            printf("lfs_ring_host: got %u (len %d), expect %u\n", seq, len, expect);
+            cnt = -1;
+            break;
+        }
+        --expect;
+        ++cnt;
+    }
+    lfs_ring_iter_end(&it);
+    return (len < 0) ? -1 : cnt;
+}
+
+/**
+ * @brief 切换段失败：追加返回错误，排除故障后继续追加。
+ * @param ring 已经打开的日志。
+ * @param first 下一条记录的序号。
+ * @retval 0：成功。
+ * @retval -1：失败。
+ * @warning
+ * @note 把下一个要切换到的段换成同名目录，打开它时返回LFS_ERR_ISDIR；
+ * 切换失败后当前段已经关闭，下一次追加必须先重试切换，不能再碰关闭的文件。
+ */
+static int _rotate_fail(lfs_ring * const ring, const uint32_t first) {
+    uint32_t next = 0;
+    for (uint32_t i = 1; i < LFS_RING_SEG_CNT; ++i) {
+        next = (ring->gen[i] < ring->gen[next]) ? i : next;
+    }
+    char path[LFS_RING_PATH_MAX + 4];
+    snprintf(path, sizeof(path), "%s/%u", ring->dir, next);
+    lfs_remove(lfs_port_fs(), path);
+    if (lfs_mkdir(lfs_port_fs(), path) != 0) {
+        return -1;
+    }
+
+    /* 一直追加到需要切换段 */
+    uint8_t  rec[REC_SIZE];
+    uint32_t seq = first;
+    int      err = 0;
+    for (uint32_t i = 0; (err == 0) && (i < LFS_RING_SEG_SIZE / REC_SIZE + 1); ++i) {
+        _rec_make(rec, seq);
+        err = lfs_ring_append(ring, rec, REC_SIZE);
+        seq += (err == 0);
+    }
+    const int again = lfs_ring_append(ring, rec, REC_SIZE);
+
+    if ((err != LFS_ERR_ISDIR) || (again != LFS_ERR_ISDIR) ||
+        (lfs_remove(lfs_port_fs(), path) != 0) || (_ring(ring, seq, 8, 1) != 0)) {
+        printf("lfs_ring_host: rotate fail %d, retry %d\n", err, again);
+        return -1;
+    }
+    const int walked = _walk(ring, seq + 7);
+    printf("rotate fail: %d records after retry\n", walked);
+    return (walked > 0) ? 0 : -1;
+}
+
+int main(int argc, char ** argv) {
+    const uint32_t cnt   = (argc > 1) ? strtoul(argv[1], NULL, 0) : 2000;
+    const uint32_t batch = (argc > 2) ? strtoul(argv[2], NULL, 0) : 16;
+
+    if ((cnt < 2 * batch) || (batch == 0) ||
+        (flash_sim_init(&lfs_port_sim, SIM_CAPACITY, SIM_PAGE_SIZE) != 0)) {
+        fprintf(stderr, "usage: %s [records] [batch]\n", argv[0]);
+        return 2;
+    }
+
+    int      ret = 1;
+    cost     c;
+    lfs_ring ring;
+
+    /* 逐条打开追加关闭 */
+    if ((_fresh() != 0)) {
+        goto out;
+    }
+    _cost_begin(&c);
+    if (_naive(cnt) != 0) {
+        goto out;
+    }
+    _cost_print("open/append", &c, cnt);
+
+    /* lfs_ring：每条都提交，与上面的可靠性相同 */
+    if ((_fresh() != 0) || (lfs_ring_open(&ring, "/ring") != 0)) {
+        goto out;
+    }
+    _cost_begin(&c);
+    if ((_ring(&ring, 0, cnt, 1) != 0) || (lfs_ring_close(&ring) != 0)) {
+        goto out;
+    }
+    _cost_print("ring commit 1", &c, cnt);
+
+    /* lfs_ring：按batch条提交 */
+    if ((_fresh() != 0) || (lfs_ring_open(&ring, "/ring") != 0)) {
+        goto out;
+    }
+    _cost_begin(&c);
+    if (_ring(&ring, 0, cnt, batch) != 0) {
+        goto out;
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "ring commit %u", batch);
+    _cost_print(name, &c, cnt);
+
+    /* 最后一次提交之后再追加几条，不提交就复位 */
+    const uint32_t committed = cnt - 1;
+    if ((lfs_ring_commit(&ring) != 0) || (_ring(&ring, cnt, batch / 2, 0) != 0)) {
+        goto out;
+    }
+    const int walked = _walk(&ring, committed);
+    if ((lfs_port_init() != 0) || (lfs_ring_open(&ring, "/ring") != 0)) {
+        goto out;
+    }
+    const int reopened = _walk(&ring, committed);
+    printf("newest-first: %d records before reset, %d after\n", walked, reopened);
+    if ((walked > 0) && (reopened > 0) && (_rotate_fail(&ring, cnt) == 0) &&
+        (lfs_ring_close(&ring) == 0) && (lfs_port_file_free() == 4)) {
+        ret = 0;
+    }
+
+out:
+    printf("lfs_ring_host: %s\n", ret ? "FAIL" : "ok");
+    lfs_port_deinit();
+    flash_sim_deinit(&lfs_port_sim);
+    return ret;
+}